@@ -260,6 +260,12 @@ ADIOS2_FOREACH_TYPE_1ARG(declare_type)
 ADIOS2_FOREACH_TYPE_1ARG(declare_template_instantiation)
 #undef declare_template_instantiation
 
+#define declare_template_instantiation(T)                                      \
+    template std::vector<typename Variable<T>::Info>                           \
+    Variable<T>::ToBlocksInfoMin(const MinVarInfo *) const;
+ADIOS2_FOREACH_TYPE_1ARG(declare_template_instantiation)
+#undef declare_template_instantiation
+
 #define declare_template_instantiation(T) template class detail::Span<T>;
 ADIOS2_FOREACH_PRIMITIVE_TYPE_1ARG(declare_template_instantiation)
 #undef declare_template_instantiation
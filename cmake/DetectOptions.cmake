@@ -388,6 +388,21 @@ else()
   set(ADIOS2_HAVE_SysVShMem OFF)
 endif()
 
+# io_uring, used through the raw system calls, no liburing needed
+if(ADIOS2_USE_IOUring AND CMAKE_SYSTEM_NAME STREQUAL "Linux")
+  include(CheckIncludeFile)
+  include(CheckSymbolExists)
+  CHECK_INCLUDE_FILE(linux/io_uring.h HAVE_linux_io_uring_h)
+  CHECK_SYMBOL_EXISTS(__NR_io_uring_setup "sys/syscall.h" HAVE_io_uring_setup)
+  if(HAVE_linux_io_uring_h AND HAVE_io_uring_setup)
+    set(ADIOS2_HAVE_IOUring TRUE)
+  elseif(NOT ADIOS2_USE_IOUring STREQUAL AUTO)
+    message(FATAL_ERROR "io_uring was requested but linux/io_uring.h or the io_uring system calls were not found")
+  endif()
+elseif(ADIOS2_USE_IOUring AND NOT ADIOS2_USE_IOUring STREQUAL AUTO)
+  message(FATAL_ERROR "io_uring is only available on Linux")
+endif()
+
 #Profiling
 if(ADIOS2_USE_Profiling STREQUAL AUTO)
   if(BUILD_SHARED_LIBS)
@@ -95,6 +95,12 @@ size_t Engine::DebugGetDataBufferSize() const
     return 0;
 }
 
+size_t Engine::DebugGetMappedReads() const
+{
+    ThrowUp("DebugGetMappedReads");
+    return 0;
+}
+
 void Engine::EnterComputationBlock() noexcept {}
 void Engine::ExitComputationBlock() noexcept {}
 
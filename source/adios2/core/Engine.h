@@ -452,6 +452,10 @@ public:
     /* for adios2 internal testing */
     virtual size_t DebugGetDataBufferSize() const;
 
+    /* for adios2 internal testing, number of read requests served straight
+     * from a memory map of the data instead of a copy */
+    virtual size_t DebugGetMappedReads() const;
+
     //  in this call, Step is RELATIVE, not absolute
     virtual MinVarInfo *MinBlocksInfo(const VariableBase &,
                                       const size_t Step) const
@@ -465,6 +469,14 @@ public:
         return false;
     }
 
+    //  Shape of a global array in an absolute Step, for engines that do not
+    //  keep every step's shape in the variable, false to use those
+    virtual bool VarShape(const VariableBase &, const size_t Step,
+                          Dims &Shape) const
+    {
+        return false;
+    }
+
     /** Notify the engine when a new attribute is defined. Called from IO.tcc
      */
     virtual void NotifyEngineAttribute(std::string name,
@@ -36,6 +36,11 @@ Dims Variable<T>::DoShape(const size_t step) const
         const size_t stepInput =
             !m_FirstStreamingStep ? m_Engine->CurrentStep() : step;
 
+        Dims shape;
+        if (m_Engine->VarShape(*this, stepInput, shape))
+        {
+            return shape;
+        }
         const auto it = m_AvailableShapes.find(stepInput + 1);
         if (it != m_AvailableShapes.end())
         {
@@ -232,6 +232,10 @@ void VariableBase::SetStepSelection(const Box<size_t> &boxSteps)
     if (m_ShapeID == ShapeID::GlobalArray)
     {
         /* Handle Global Array with changing shape over steps */
+        if (m_Engine && m_Engine->VarShape(*this, m_StepsStart, m_Shape))
+        {
+            return;
+        }
         const auto it = m_AvailableShapes.find(m_StepsStart + 1);
         if (it != m_AvailableShapes.end())
         {
@@ -102,6 +102,14 @@ void BP4Reader::ReadVariableBlocks(Variable<T> &variable)
                             {{"transport", "File"}, {"library", "daos"}},
                             profile);
                     }
+                    else if (library == "mmap" || library == "MMap")
+                    {
+                        m_DataFileManager.OpenFileID(
+                            subFileName, subStreamBoxInfo.SubStreamID,
+                            Mode::Read,
+                            {{"transport", "File"}, {"library", "mmap"}},
+                            profile);
+                    }
                     else
                     {
                         m_DataFileManager.OpenFileID(
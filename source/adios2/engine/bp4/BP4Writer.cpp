@@ -14,6 +14,10 @@
 #include "adios2/common/ADIOSMacros.h"
 #include "adios2/core/IO.h"
 #include "adios2/helper/adiosFunctions.h" //CheckIndexRange
+#include "adios2/toolkit/burstbuffer/FileDrainerSingleThread.h"
+#ifndef _WIN32
+#include "adios2/toolkit/burstbuffer/FileDrainerMultiThread.h"
+#endif
 #include "adios2/toolkit/transport/file/FileFStream.h"
 #include <adios2-perfstubs-interface.h>
 
@@ -31,7 +35,7 @@ BP4Writer::BP4Writer(IO &io, const std::string &name, const Mode mode,
                      helper::Comm comm)
 : Engine("BP4Writer", io, name, mode, std::move(comm)), m_BP4Serializer(m_Comm),
   m_FileDataManager(m_Comm), m_FileMetadataManager(m_Comm),
-  m_FileMetadataIndexManager(m_Comm), m_FileDrainer()
+  m_FileMetadataIndexManager(m_Comm)
 {
     PERFSTUBS_SCOPED_TIMER("BP4Writer::Open");
     helper::GetParameter(m_IO.m_Parameters, "Verbose", m_Verbosity);
@@ -188,6 +192,23 @@ void BP4Writer::InitParameters()
                                  "in call to BP4::Open to write");
     m_WriteToBB = !(m_BP4Serializer.m_Parameters.BurstBufferPath.empty());
     m_DrainBB = m_WriteToBB && m_BP4Serializer.m_Parameters.BurstBufferDrain;
+
+    if (m_DrainBB)
+    {
+#ifndef _WIN32
+        if (m_BP4Serializer.m_Parameters.BurstBufferDrainThreads > 1 ||
+            m_BP4Serializer.m_Parameters.BurstBufferDrainBandwidth > 0)
+        {
+            m_FileDrainer.reset(new burstbuffer::FileDrainerMultiThread(
+                m_BP4Serializer.m_Parameters.BurstBufferDrainThreads,
+                m_BP4Serializer.m_Parameters.BurstBufferDrainBandwidth));
+        }
+        else
+#endif
+        {
+            m_FileDrainer.reset(new burstbuffer::FileDrainerSingleThread());
+        }
+    }
 }
 
 void BP4Writer::InitTransports()
@@ -225,10 +246,10 @@ void BP4Writer::InitTransports()
             m_DrainSubStreamNames =
                 m_BP4Serializer.GetBPSubStreamNames(drainTransportNames);
             /* start up BB thread */
-            m_FileDrainer.SetVerbose(
+            m_FileDrainer->SetVerbose(
                 m_BP4Serializer.m_Parameters.BurstBufferVerbose,
                 m_BP4Serializer.m_RankMPI);
-            m_FileDrainer.Start();
+            m_FileDrainer->Start();
         }
     }
 
@@ -263,12 +284,14 @@ void BP4Writer::InitTransports()
         m_FileDataManager.OpenFiles(m_SubStreamNames, m_OpenMode,
                                     m_IO.m_TransportsParameters,
                                     m_BP4Serializer.m_Profiler.m_IsActive);
+        m_FileDataManager.m_ConcurrentWrites =
+            m_BP4Serializer.m_Parameters.ConcurrentTransportWrites;
 
         if (m_DrainBB)
         {
             for (const auto &name : m_DrainSubStreamNames)
             {
-                m_FileDrainer.AddOperationOpen(name, m_OpenMode);
+                m_FileDrainer->AddOperationOpen(name, m_OpenMode);
             }
         }
     }
@@ -312,11 +335,11 @@ void BP4Writer::InitTransports()
 
             for (const auto &name : m_DrainMetadataFileNames)
             {
-                m_FileDrainer.AddOperationOpen(name, m_OpenMode);
+                m_FileDrainer->AddOperationOpen(name, m_OpenMode);
             }
             for (const auto &name : m_DrainMetadataIndexFileNames)
             {
-                m_FileDrainer.AddOperationOpen(name, m_OpenMode);
+                m_FileDrainer->AddOperationOpen(name, m_OpenMode);
             }
         }
         //}
@@ -457,7 +480,7 @@ void BP4Writer::DoClose(const int transportIndex)
         {
             for (const auto &name : m_SubStreamNames)
             {
-                m_FileDrainer.AddOperationDelete(name);
+                m_FileDrainer->AddOperationDelete(name);
             }
         }
     }
@@ -495,18 +518,18 @@ void BP4Writer::DoClose(const int transportIndex)
         {
             for (const auto &name : m_MetadataFileNames)
             {
-                m_FileDrainer.AddOperationDelete(name);
+                m_FileDrainer->AddOperationDelete(name);
             }
             for (const auto &name : m_MetadataIndexFileNames)
             {
-                m_FileDrainer.AddOperationDelete(name);
+                m_FileDrainer->AddOperationDelete(name);
             }
             const std::vector<std::string> transportsNames =
                 m_FileDataManager.GetFilesBaseNames(
                     m_BBName, m_IO.m_TransportsParameters);
             for (const auto &name : transportsNames)
             {
-                m_FileDrainer.AddOperationDelete(name);
+                m_FileDrainer->AddOperationDelete(name);
             }
         }
     }
@@ -514,7 +537,7 @@ void BP4Writer::DoClose(const int transportIndex)
     if (m_BP4Serializer.m_Aggregator.m_IsAggregator && m_DrainBB)
     {
         /* Signal the BB thread that no more work is coming */
-        m_FileDrainer.Finish();
+        m_FileDrainer->Finish();
     }
     // m_BP4Serializer.DeleteBuffers();
 }
@@ -531,6 +554,7 @@ void BP4Writer::WriteProfilingJSONFile()
         if (transportTypes[i].compare(0, 4, "File") == 0)
         {
             fileTransportIdx = static_cast<int>(i);
+            break;
         }
     }
 
@@ -546,9 +570,15 @@ void BP4Writer::WriteProfilingJSONFile()
                               transportProfilersMD.begin(),
                               transportProfilersMD.end());
 
-    const std::string lineJSON(m_BP4Serializer.GetRankProfilingJSON(
-                                   transportTypes, transportProfilers) +
-                               ",\n");
+    std::string rankLog(m_BP4Serializer.GetRankProfilingJSON(
+        transportTypes, transportProfilers));
+    if (m_DrainBB && m_BP4Serializer.m_Aggregator.m_IsAggregator)
+    {
+        // drain progress so far, as the last entry of this rank
+        rankLog.insert(rankLog.size() - 2,
+                       ", " + m_FileDrainer->GetProfilingJSON());
+    }
+    const std::string lineJSON(rankLog + ",\n");
 
     const std::vector<char> profilingJSON(
         m_BP4Serializer.AggregateProfilingJSON(lineJSON));
@@ -569,7 +599,7 @@ void BP4Writer::WriteProfilingJSONFile()
             {
                 profileFileName = bpTargetNames[0] + "_profiling.json";
             }
-            m_FileDrainer.AddOperationWrite(
+            m_FileDrainer->AddOperationWrite(
                 profileFileName, profilingJSON.size(), profilingJSON.data());
         }
         else
@@ -624,10 +654,10 @@ void BP4Writer::UpdateActiveFlag(const bool active)
     {
         for (size_t i = 0; i < m_MetadataIndexFileNames.size(); ++i)
         {
-            m_FileDrainer.AddOperationWriteAt(
+            m_FileDrainer->AddOperationWriteAt(
                 m_DrainMetadataIndexFileNames[i],
                 m_BP4Serializer.m_ActiveFlagPosition, 1, &activeChar);
-            m_FileDrainer.AddOperationSeekEnd(m_DrainMetadataIndexFileNames[i]);
+            m_FileDrainer->AddOperationSeekEnd(m_DrainMetadataIndexFileNames[i]);
         }
     }
 }
@@ -658,7 +688,7 @@ void BP4Writer::WriteCollectiveMetadataFile(const bool isFinal)
         {
             for (size_t i = 0; i < m_MetadataFileNames.size(); ++i)
             {
-                m_FileDrainer.AddOperationCopy(
+                m_FileDrainer->AddOperationCopy(
                     m_MetadataFileNames[i], m_DrainMetadataFileNames[i],
                     m_BP4Serializer.m_Metadata.m_Position);
             }
@@ -721,7 +751,7 @@ void BP4Writer::WriteCollectiveMetadataFile(const bool isFinal)
         {
             for (size_t i = 0; i < m_MetadataIndexFileNames.size(); ++i)
             {
-                m_FileDrainer.AddOperationWrite(
+                m_FileDrainer->AddOperationWrite(
                     m_DrainMetadataIndexFileNames[i],
                     m_BP4Serializer.m_MetadataIndex.m_Position,
                     m_BP4Serializer.m_MetadataIndex.m_Buffer.data());
@@ -762,7 +792,7 @@ void BP4Writer::WriteData(const bool isFinal, const int transportIndex)
     {
         for (size_t i = 0; i < m_SubStreamNames.size(); ++i)
         {
-            m_FileDrainer.AddOperationCopy(m_SubStreamNames[i],
+            m_FileDrainer->AddOperationCopy(m_SubStreamNames[i],
                                            m_DrainSubStreamNames[i], dataSize);
         }
     }
@@ -813,7 +843,7 @@ void BP4Writer::AggregateWriteData(const bool isFinal, const int transportIndex)
     {
         for (size_t i = 0; i < m_SubStreamNames.size(); ++i)
         {
-            m_FileDrainer.AddOperationCopy(m_SubStreamNames[i],
+            m_FileDrainer->AddOperationCopy(m_SubStreamNames[i],
                                            m_DrainSubStreamNames[i],
                                            totalBytesWritten);
         }
@@ -14,7 +14,7 @@
 #include "adios2/common/ADIOSConfig.h"
 #include "adios2/core/Engine.h"
 #include "adios2/helper/adiosComm.h"
-#include "adios2/toolkit/burstbuffer/FileDrainerSingleThread.h"
+#include "adios2/toolkit/burstbuffer/FileDrainer.h"
 #include "adios2/toolkit/format/bp/bp4/BP4Serializer.h"
 #include "adios2/toolkit/transportman/TransportMan.h"
 
@@ -69,8 +69,10 @@ private:
     bool m_WriteToBB = false;
     /** true if burst buffer is drained to disk  */
     bool m_DrainBB = true;
-    /** File drainer thread if burst buffer is used */
-    burstbuffer::FileDrainerSingleThread m_FileDrainer;
+    /** File drainer thread(s) if burst buffer is used, created in
+     * InitParameters when m_DrainBB, multi-threaded if
+     * BurstBufferDrainThreads > 1 */
+    std::unique_ptr<burstbuffer::FileDrainer> m_FileDrainer;
     /** m_Name modified with burst buffer path if BB is used,
      * == m_Name otherwise.
      * m_Name is a constant of Engine and is the user provided target path
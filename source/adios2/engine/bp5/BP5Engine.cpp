@@ -252,11 +252,15 @@ void BP5Engine::ParseParams(IO &io, struct BP5Params &Params)
             {
                 parameter = (int)BufferVType::ChunkVType;
             }
+            else if (value == "auto")
+            {
+                parameter = (int)BufferVType::Auto;
+            }
             else
             {
                 throw std::invalid_argument(
                     "ERROR: Unknown BP5 BufferVType parameter \"" + value +
-                    "\" (must be \"malloc\" or \"chunk\"");
+                    "\" (must be \"malloc\", \"chunk\" or \"auto\"");
             }
         }
     };
@@ -270,7 +274,7 @@ void BP5Engine::ParseParams(IO &io, struct BP5Params &Params)
             std::string value = itKey->second;
             std::transform(value.begin(), value.end(), value.begin(),
                            ::tolower);
-            if (value == "everyonewrites" || value == "auto")
+            if (value == "everyonewrites")
             {
                 parameter = (int)AggregationType::EveryoneWrites;
             }
@@ -282,6 +286,10 @@ void BP5Engine::ParseParams(IO &io, struct BP5Params &Params)
             {
                 parameter = (int)AggregationType::TwoLevelShm;
             }
+            else if (value == "auto")
+            {
+                parameter = (int)AggregationType::Auto;
+            }
             else
             {
                 throw std::invalid_argument(
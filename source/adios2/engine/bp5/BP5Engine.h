@@ -112,9 +112,14 @@ public:
     MACRO(StreamReader, Bool, bool, false)                                     \
     MACRO(BurstBufferDrain, Bool, bool, true)                                  \
     MACRO(BurstBufferPath, String, std::string, (char *)(intptr_t)0)           \
+    MACRO(BurstBufferDrainThreads, UInt, unsigned int, 1)                      \
+    MACRO(BurstBufferDrainBandwidth, SizeBytes, size_t, 0)                     \
     MACRO(NodeLocal, Bool, bool, false)                                        \
     MACRO(verbose, Int, int, 0)                                                \
     MACRO(CollectiveMetadata, Bool, bool, true)                                \
+    MACRO(NodeMetadataAggregation, Bool, bool, false)                          \
+    MACRO(MetadataDeltaInterval, UInt, unsigned int, 0)                        \
+    MACRO(DeferredCompression, Bool, bool, false)                              \
     MACRO(NumAggregators, UInt, unsigned int, 0)                               \
     MACRO(NumSubFiles, UInt, unsigned int, 999999)                             \
     MACRO(FileSystemPageSize, UInt, unsigned int, 4096)                        \
@@ -122,14 +127,30 @@ public:
           (int)AggregationType::TwoLevelShm)                                   \
     MACRO(AsyncOpen, Bool, bool, true)                                         \
     MACRO(AsyncWrite, AsyncWrite, int, (int)AsyncWrite::Sync)                  \
+    MACRO(AsyncMetadataWrite, Bool, bool, true)                                \
+    MACRO(MaxQueuedMetadataWrites, UInt, unsigned int, 16)                     \
+    MACRO(ConcurrentTransportWrites, Bool, bool, false)                        \
     MACRO(GrowthFactor, Float, float, DefaultBufferGrowthFactor)               \
     MACRO(InitialBufferSize, SizeBytes, size_t, DefaultInitialBufferSize)      \
     MACRO(MinDeferredSize, SizeBytes, size_t, DefaultMinDeferredSize)          \
     MACRO(BufferChunkSize, SizeBytes, size_t, DefaultBufferChunkSize)          \
+    MACRO(BufferChunkPoolSize, SizeBytes, size_t, 0)                           \
+    MACRO(BufferChunkHugePages, Bool, bool, false)                             \
+    MACRO(BufferChunkFirstTouch, Bool, bool, false)                            \
     MACRO(MaxShmSize, SizeBytes, size_t, DefaultMaxShmSize)                    \
+    MACRO(NumShmSlots, UInt, unsigned int, 2)                                  \
+    MACRO(AutoProbeSize, SizeBytes, size_t, 0)                                 \
     MACRO(BufferVType, BufferVType, int, (int)BufferVType::ChunkVType)         \
     MACRO(AppendAfterSteps, Int, int, INT_MAX)                                 \
-    MACRO(ReaderShortCircuitReads, Bool, bool, false)
+    MACRO(ReaderShortCircuitReads, Bool, bool, false)                          \
+    MACRO(ReaderThreads, UInt, unsigned int, 0)                                \
+    MACRO(CompressionThreads, UInt, unsigned int, 0)                           \
+    MACRO(StatsThreads, UInt, unsigned int, 1)                                 \
+    MACRO(ReadMergeGap, SizeBytes, size_t, 64 * 1024)                          \
+    MACRO(MaxReadSize, SizeBytes, size_t, DefaultBufferChunkSize)              \
+    MACRO(LazyMetadata, Bool, bool, false)                                     \
+    MACRO(LazyMetadataSteps, UInt, unsigned int, 64)                           \
+    MACRO(NodeSharedMetadata, Bool, bool, false)
 
     struct BP5Params
     {
@@ -11,7 +11,12 @@
 
 #include <adios2-perfstubs-interface.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <errno.h>
+#include <future>
+#include <thread>
 
 namespace adios2
 {
@@ -36,7 +41,8 @@ BP5Reader::~BP5Reader()
         delete m_BP5Deserializer;
 }
 
-void BP5Reader::InstallMetadataForTimestep(size_t Step)
+void BP5Reader::InstallMetadataForTimestep(size_t Step, bool Variables,
+                                           bool Attributes)
 {
     size_t pgstart = m_MetadataIndexTable[Step][0];
     size_t Position = pgstart + sizeof(uint64_t); // skip total data size
@@ -47,31 +53,55 @@ void BP5Reader::InstallMetadataForTimestep(size_t Step)
     {
         // variable metadata for timestep
         size_t ThisMDSize = helper::ReadValue<uint64_t>(
-            m_Metadata.m_Buffer, Position, m_Minifooter.IsLittleEndian);
-        char *ThisMD = m_Metadata.m_Buffer.data() + MDPosition;
-        if (m_OpenMode == Mode::ReadRandomAccess)
+            MetadataBuffer(), Position, m_Minifooter.IsLittleEndian);
+        char *ThisMD = MetadataBuffer() + MDPosition;
+        if (Variables && (m_OpenMode == Mode::ReadRandomAccess))
         {
             m_BP5Deserializer->InstallMetaData(ThisMD, ThisMDSize, WriterRank,
                                                Step);
         }
-        else
+        else if (Variables)
         {
             m_BP5Deserializer->InstallMetaData(ThisMD, ThisMDSize, WriterRank);
         }
         MDPosition += ThisMDSize;
     }
+    if (!Attributes)
+    {
+        return;
+    }
     for (size_t WriterRank = 0; WriterRank < WriterCount; WriterRank++)
     {
         // attribute metadata for timestep
         size_t ThisADSize = helper::ReadValue<uint64_t>(
-            m_Metadata.m_Buffer, Position, m_Minifooter.IsLittleEndian);
-        char *ThisAD = m_Metadata.m_Buffer.data() + MDPosition;
+            MetadataBuffer(), Position, m_Minifooter.IsLittleEndian);
+        char *ThisAD = MetadataBuffer() + MDPosition;
         if (ThisADSize > 0)
             m_BP5Deserializer->InstallAttributeData(ThisAD, ThisADSize);
         MDPosition += ThisADSize;
     }
 }
 
+bool BP5Reader::StepHasNewVariables(size_t Step)
+{
+    size_t Position = m_MetadataIndexTable[Step][0] + sizeof(uint64_t);
+    const uint64_t WriterCount =
+        m_WriterMap[m_WriterMapIndex[Step]].WriterCount;
+    size_t MDPosition = Position + 2 * sizeof(uint64_t) * WriterCount;
+    for (size_t WriterRank = 0; WriterRank < WriterCount; WriterRank++)
+    {
+        size_t ThisMDSize = helper::ReadValue<uint64_t>(
+            MetadataBuffer(), Position, m_Minifooter.IsLittleEndian);
+        if (m_BP5Deserializer->MetaDataHasNewVariables(MetadataBuffer() +
+                                                       MDPosition))
+        {
+            return true;
+        }
+        MDPosition += ThisMDSize;
+    }
+    return false;
+}
+
 StepStatus BP5Reader::BeginStep(StepMode mode, const float timeoutSeconds)
 {
     PERFSTUBS_SCOPED_TIMER("BP5Reader::BeginStep");
@@ -171,25 +201,20 @@ void BP5Reader::EndStep()
     PerformGets();
 }
 
-void BP5Reader::ReadData(const size_t WriterRank, const size_t Timestep,
-                         const size_t StartOffset, const size_t Length,
-                         char *Destination)
+void BP5Reader::GetDataExtents(const size_t WriterRank, const size_t Timestep,
+                               const size_t StartOffset, const size_t Length,
+                               char *Destination,
+                               std::vector<ReadExtent> &Extents)
 {
     size_t FlushCount = m_MetadataIndexTable[Timestep][2];
     size_t DataPosPos = m_MetadataIndexTable[Timestep][3];
     size_t SubfileNum = static_cast<size_t>(
         m_WriterMap[m_WriterMapIndex[Timestep]].RankToSubfile[WriterRank]);
 
-    // check if subfile is already opened
-    if (m_DataFileManager.m_Transports.count(SubfileNum) == 0)
-    {
-        const std::string subFileName = GetBPSubStreamName(
-            m_Name, SubfileNum, m_Minifooter.HasSubFiles, true);
-
-        m_DataFileManager.OpenFileID(subFileName, SubfileNum, Mode::Read,
-                                     {{"transport", "File"}}, false);
-    }
-
+    /* The writer's data for this step is laid out in FlushCount + 1
+     * contiguous pieces in the subfile.  StartOffset is relative to the
+     * concatenation of those pieces, so skip whole flushes that lie before
+     * it and read only the requested range. */
     size_t InfoStartPos =
         DataPosPos + (WriterRank * (2 * FlushCount + 1) * sizeof(uint64_t));
     size_t ThisFlushInfo = InfoStartPos;
@@ -205,11 +230,20 @@ void BP5Reader::ReadData(const size_t WriterRank, const size_t Timestep,
         size_t ThisDataSize =
             helper::ReadValue<uint64_t>(m_MetadataIndex.m_Buffer, ThisFlushInfo,
                                         m_Minifooter.IsLittleEndian);
+        if (Offset >= ThisDataSize)
+        {
+            Offset -= ThisDataSize;
+            continue;
+        }
+        ThisDataSize -= Offset;
         if (ThisDataSize > RemainingLength)
             ThisDataSize = RemainingLength;
-        m_DataFileManager.ReadFile(Destination, ThisDataSize,
-                                   ThisDataPos + Offset, SubfileNum);
-        Destination += ThisDataSize;
+        Extents.push_back(
+            {SubfileNum, ThisDataPos + Offset, ThisDataSize, Destination});
+        if (Destination)
+        {
+            Destination += ThisDataSize;
+        }
         RemainingLength -= ThisDataSize;
         Offset = 0;
         if (RemainingLength == 0)
@@ -217,19 +251,287 @@ void BP5Reader::ReadData(const size_t WriterRank, const size_t Timestep,
     }
     ThisDataPos = helper::ReadValue<uint64_t>(
         m_MetadataIndex.m_Buffer, ThisFlushInfo, m_Minifooter.IsLittleEndian);
-    m_DataFileManager.ReadFile(Destination, RemainingLength, ThisDataPos,
-                               SubfileNum);
+    Extents.push_back(
+        {SubfileNum, ThisDataPos + Offset, RemainingLength, Destination});
+}
+
+void BP5Reader::OpenSubfile(transportman::TransportMan &FileManager,
+                            const size_t SubfileNum)
+{
+    // check if subfile is already opened
+    if (FileManager.m_Transports.count(SubfileNum) == 0)
+    {
+        const std::string subFileName = GetBPSubStreamName(
+            m_Name, SubfileNum, m_Minifooter.HasSubFiles, true);
+
+        FileManager.OpenFileID(subFileName, SubfileNum, Mode::Read,
+                               SubfileParameters(), false);
+    }
+}
+
+Params BP5Reader::SubfileParameters() const
+{
+    /* the first transport as the user configured it (its Library and the
+     * library's options) but not its Name, which is the data file's; an
+     * unknown Library is rejected by the TransportMan */
+    Params parameters;
+    for (const auto &pair : m_IO.m_TransportsParameters[0])
+    {
+        if (helper::LowerCase(pair.first) != "name")
+        {
+            parameters[pair.first] = pair.second;
+        }
+    }
+    parameters["transport"] = "File";
+    return parameters;
+}
+
+const char *BP5Reader::MapData(const size_t WriterRank, const size_t Timestep,
+                               const size_t StartOffset, const size_t Length)
+{
+    if (!m_CanMapData)
+    {
+        return nullptr;
+    }
+    std::vector<ReadExtent> Extents;
+    GetDataExtents(WriterRank, Timestep, StartOffset, Length, nullptr,
+                   Extents);
+    if (Extents.size() != 1)
+    {
+        // spans several flushes, not contiguous in the subfile
+        return nullptr;
+    }
+    const ReadExtent &Extent = Extents[0];
+    OpenSubfile(m_DataFileManager, Extent.SubfileNum);
+    const char *Data = m_DataFileManager.MapFile(
+        Extent.FilePos, Extent.Length, Extent.SubfileNum);
+    if (Data == nullptr)
+    {
+        // all subfiles use the same transport, don't ask again
+        m_CanMapData = false;
+    }
+    return Data;
+}
+
+void BP5Reader::ReadExtentData(transportman::TransportMan &FileManager,
+                               const ReadExtent &Extent)
+{
+    OpenSubfile(FileManager, Extent.SubfileNum);
+    if (Extent.Scatter.empty())
+    {
+        FileManager.ReadFile(Extent.Destination, Extent.Length,
+                             Extent.FilePos, Extent.SubfileNum);
+    }
+    else
+    {
+        FileManager.ReadFile(Extent.Scatter.data(), Extent.Scatter.size(),
+                             Extent.FilePos, Extent.SubfileNum);
+    }
+}
+
+void BP5Reader::ScheduleReads(std::vector<ReadExtent> &Extents,
+                              std::vector<ReadExtent> &Tasks,
+                              std::vector<std::vector<char>> &MergeBuffers,
+                              std::vector<ReadCopyBack> &CopyBacks)
+{
+    std::sort(Extents.begin(), Extents.end(),
+              [](const ReadExtent &a, const ReadExtent &b) {
+                  if (a.SubfileNum != b.SubfileNum)
+                      return a.SubfileNum < b.SubfileNum;
+                  return a.FilePos < b.FilePos;
+              });
+
+    const size_t MaxReadSize =
+        m_Parameters.MaxReadSize ? m_Parameters.MaxReadSize : 1;
+    auto lf_AddTasks = [&](size_t SubfileNum, size_t FilePos, size_t Length,
+                           char *Destination) {
+        while (Length > 0)
+        {
+            const size_t ThisLength = std::min(Length, MaxReadSize);
+            Tasks.push_back({SubfileNum, FilePos, ThisLength, Destination});
+            FilePos += ThisLength;
+            Destination += ThisLength;
+            Length -= ThisLength;
+        }
+    };
+
+    size_t i = 0;
+    while (i < Extents.size())
+    {
+        const size_t Start = Extents[i].FilePos;
+        size_t End = Start + Extents[i].Length;
+        size_t j = i;
+        while ((j + 1 < Extents.size()) &&
+               (Extents[j + 1].SubfileNum == Extents[i].SubfileNum) &&
+               (Extents[j + 1].FilePos <= End + m_Parameters.ReadMergeGap))
+        {
+            j++;
+            End = std::max(End, Extents[j].FilePos + Extents[j].Length);
+        }
+        bool Disjoint = true;
+        for (size_t k = i; k < j; k++)
+        {
+            if (Extents[k + 1].FilePos < Extents[k].FilePos + Extents[k].Length)
+            {
+                Disjoint = false;
+                break;
+            }
+        }
+
+        if (j == i)
+        {
+            // nothing to coalesce with, read straight into the destination
+            lf_AddTasks(Extents[i].SubfileNum, Start, Extents[i].Length,
+                        Extents[i].Destination);
+        }
+        else if (Disjoint && (End - Start <= MaxReadSize))
+        {
+            ReadExtent Task(Extents[i].SubfileNum, Start, End - Start,
+                            nullptr);
+            /* the gap bytes are not needed, all gaps of this read go to
+             * one scratch buffer; tasks run on different threads so each
+             * gets its own */
+            size_t MaxGap = 0;
+            for (size_t k = i; k < j; k++)
+            {
+                MaxGap = std::max(MaxGap, Extents[k + 1].FilePos -
+                                              (Extents[k].FilePos +
+                                               Extents[k].Length));
+            }
+            char *GapBuffer = nullptr;
+            if (MaxGap > 0)
+            {
+                MergeBuffers.emplace_back(MaxGap);
+                GapBuffer = MergeBuffers.back().data();
+            }
+            size_t Pos = Start;
+            for (size_t k = i; k <= j; k++)
+            {
+                const size_t Gap = Extents[k].FilePos - Pos;
+                if (Gap > 0)
+                {
+                    Task.Scatter.push_back({GapBuffer, Gap});
+                }
+                Task.Scatter.push_back(
+                    {Extents[k].Destination, Extents[k].Length});
+                Pos = Extents[k].FilePos + Extents[k].Length;
+            }
+            Tasks.push_back(std::move(Task));
+        }
+        else
+        {
+            MergeBuffers.emplace_back(End - Start);
+            char *Buffer = MergeBuffers.back().data();
+            lf_AddTasks(Extents[i].SubfileNum, Start, End - Start, Buffer);
+            for (size_t k = i; k <= j; k++)
+            {
+                CopyBacks.push_back({Buffer + (Extents[k].FilePos - Start),
+                                     Extents[k].Destination,
+                                     Extents[k].Length});
+            }
+        }
+        i = j + 1;
+    }
+}
+
+void BP5Reader::ExecuteReads(const std::vector<ReadExtent> &Tasks)
+{
+    const size_t nThreads =
+        std::min(static_cast<size_t>(m_Threads), Tasks.size());
+    if (nThreads <= 1)
+    {
+        for (const auto &Task : Tasks)
+        {
+            ReadExtentData(m_DataFileManager, Task);
+        }
+        return;
+    }
+
+    while (m_ThreadFileManagers.size() < nThreads - 1)
+    {
+        m_ThreadFileManagers.emplace_back(
+            new transportman::TransportMan(m_Comm));
+    }
+
+    std::atomic<size_t> NextTask(0);
+    auto lf_Reader = [&](transportman::TransportMan &FileManager) {
+        size_t t;
+        while ((t = NextTask++) < Tasks.size())
+        {
+            ReadExtentData(FileManager, Tasks[t]);
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    futures.reserve(nThreads - 1);
+    for (size_t tid = 0; tid < nThreads - 1; tid++)
+    {
+        futures.push_back(std::async(std::launch::async, lf_Reader,
+                                     std::ref(*m_ThreadFileManagers[tid])));
+    }
+
+    std::exception_ptr Error;
+    try
+    {
+        lf_Reader(m_DataFileManager);
+    }
+    catch (...)
+    {
+        // stop the other threads from picking up new reads
+        NextTask = Tasks.size();
+        Error = std::current_exception();
+    }
+    for (auto &f : futures)
+    {
+        try
+        {
+            f.get();
+        }
+        catch (...)
+        {
+            if (!Error)
+            {
+                Error = std::current_exception();
+            }
+        }
+    }
+    if (Error)
+    {
+        std::rethrow_exception(Error);
+    }
 }
 
 void BP5Reader::PerformGets()
 {
     PERFSTUBS_SCOPED_TIMER("BP5Reader::PerformGets");
-    auto ReadRequests = m_BP5Deserializer->GenerateReadRequests();
-    // Potentially optimize read requests, make contiguous, etc.
-    for (const auto &Req : ReadRequests)
+    auto ReadRequests = m_BP5Deserializer->GenerateReadRequests(false);
+
+    std::vector<ReadExtent> Extents;
+    for (auto &Req : ReadRequests)
     {
-        ReadData(Req.WriterRank, Req.Timestep, Req.StartOffset, Req.ReadLength,
-                 Req.DestinationAddr);
+        const char *Mapped = MapData(Req.WriterRank, Req.Timestep,
+                                     Req.StartOffset, Req.ReadLength);
+        if (Mapped)
+        {
+            // FinalizeGets extracts the selection straight from the map
+            Req.DestinationAddr = const_cast<char *>(Mapped);
+            Req.Borrowed = true;
+            ++m_MappedReads;
+            continue;
+        }
+        Req.DestinationAddr = (char *)malloc(Req.ReadLength);
+        GetDataExtents(Req.WriterRank, Req.Timestep, Req.StartOffset,
+                       Req.ReadLength, Req.DestinationAddr, Extents);
+    }
+
+    std::vector<ReadExtent> Tasks;
+    std::vector<std::vector<char>> MergeBuffers;
+    std::vector<ReadCopyBack> CopyBacks;
+    ScheduleReads(Extents, Tasks, MergeBuffers, CopyBacks);
+    ExecuteReads(Tasks);
+    for (const auto &Copy : CopyBacks)
+    {
+        std::memcpy(Copy.Destination, Copy.Source, Copy.Length);
     }
 
     m_BP5Deserializer->FinalizeGets(ReadRequests);
@@ -250,6 +552,17 @@ void BP5Reader::Init()
     m_IO.m_ReadStreaming = false;
 
     ParseParams(m_IO, m_Parameters);
+    m_Threads = m_Parameters.ReaderThreads;
+    if (m_Threads == 0)
+    {
+        /* share the node's hardware threads among the reader processes
+         * running on it, but use at most 16 threads */
+        helper::Comm nodeComm = m_Comm.GroupByShm();
+        const unsigned int hwThreads = std::thread::hardware_concurrency();
+        const unsigned int nodeProcs =
+            static_cast<unsigned int>(nodeComm.Size());
+        m_Threads = std::max(1u, std::min(16u, hwThreads / nodeProcs));
+    }
     m_ReaderIsRowMajor = (m_IO.m_ArrayOrder == ArrayOrdering::RowMajor);
     InitTransports();
 
@@ -438,6 +751,14 @@ bool BP5Reader::VariableMinMax(const VariableBase &Var, const size_t Step,
     return m_BP5Deserializer->VariableMinMax(Var, Step, MinMax);
 }
 
+bool BP5Reader::VarShape(const VariableBase &Var, const size_t Step,
+                         Dims &Shape) const
+{
+    return m_BP5Deserializer->VarShape(Var, Step, Shape);
+}
+
+size_t BP5Reader::DebugGetMappedReads() const { return m_MappedReads; }
+
 void BP5Reader::InitTransports()
 {
     if (m_IO.m_TransportsParameters.empty())
@@ -562,8 +883,18 @@ void BP5Reader::InitBuffer(const TimePoint &timeoutInstant,
 
     if (newIdxSize > 0)
     {
-        // broadcast buffer to all ranks from zero
-        m_Comm.BroadcastVector(m_Metadata.m_Buffer);
+        const bool SharedMetadata = m_Parameters.NodeSharedMetadata &&
+                                    (m_OpenMode == Mode::ReadRandomAccess) &&
+                                    (m_Comm.Size() > 1);
+        if (SharedMetadata)
+        {
+            ShareMetadataOnNode();
+        }
+        else
+        {
+            // broadcast buffer to all ranks from zero
+            m_Comm.BroadcastVector(m_Metadata.m_Buffer);
+        }
 
         // broadcast metadata index buffer to all ranks from zero
         m_Comm.BroadcastVector(m_MetadataIndex.m_Buffer);
@@ -580,6 +911,8 @@ void BP5Reader::InitBuffer(const TimePoint &timeoutInstant,
             new format::BP5Deserializer(m_WriterIsRowMajor, m_ReaderIsRowMajor,
                                         (m_OpenMode == Mode::ReadRandomAccess));
         m_BP5Deserializer->m_Engine = this;
+        m_BP5Deserializer->m_Threads = m_Threads;
+        m_BP5Deserializer->m_ReadOnlyMetadata = (m_SharedMetadata != nullptr);
 
         InstallMetaMetaData(m_MetaMetadata);
 
@@ -587,12 +920,34 @@ void BP5Reader::InitBuffer(const TimePoint &timeoutInstant,
 
         if (m_OpenMode == Mode::ReadRandomAccess)
         {
+            /* decoding shared metadata needs a private copy of each step,
+             * only the lazy scheme keeps the number of copies bounded */
+            const bool Lazy =
+                m_Parameters.LazyMetadata || (m_SharedMetadata != nullptr);
+            if (Lazy)
+            {
+                m_BP5Deserializer->SetLazyMetadata(
+                    m_Parameters.LazyMetadataSteps, [this](size_t Step) {
+                        InstallMetadataForTimestep(Step, true, false);
+                    });
+            }
             for (size_t Step = 0; Step < m_MetadataIndexTable.size(); Step++)
             {
                 m_BP5Deserializer->SetupForStep(
                     Step,
                     m_WriterMap[m_WriterMapIndex[m_CurrentStep]].WriterCount);
-                InstallMetadataForTimestep(Step);
+                /* In lazy mode only steps that introduce variables are
+                 * decoded now, the rest on first use */
+                InstallMetadataForTimestep(Step, !Lazy, true);
+                if (Lazy && StepHasNewVariables(Step))
+                {
+                    m_BP5Deserializer->EnsureStepInstalled(Step);
+                }
+            }
+            if (Lazy)
+            {
+                m_BP5Deserializer->SetLazyStepCounts(
+                    m_MetadataIndexTable.size());
             }
         }
         // fills IO with Variables and Attributes
@@ -612,6 +967,72 @@ void BP5Reader::InitBuffer(const TimePoint &timeoutInstant,
     }
 }
 
+void BP5Reader::ShareMetadataOnNode()
+{
+    PERFSTUBS_SCOPED_TIMER("BP5Reader::ShareMetadataOnNode");
+    const size_t MetadataSize =
+        m_Comm.BroadcastValue(m_Metadata.m_Buffer.size(), 0);
+
+    m_MetadataNodeComm =
+        m_Comm.GroupByShm("creating node communicator in BP5Reader Open");
+    const bool NodeLeader = (m_MetadataNodeComm.Rank() == 0);
+    // rank 0 is always a node leader, it is rank 0 among the leaders too
+    helper::Comm LeaderComm = m_Comm.Split(
+        NodeLeader ? 0 : 1, m_Comm.Rank(),
+        "creating node leader communicator in BP5Reader Open");
+
+    char *Base = nullptr;
+    if (m_MetadataNodeComm.Size() > 1)
+    {
+        if (NodeLeader)
+        {
+            m_MetadataWin =
+                m_MetadataNodeComm.Win_allocate_shared(MetadataSize, 1, &Base);
+        }
+        else
+        {
+            m_MetadataWin = m_MetadataNodeComm.Win_allocate_shared(0, 1, &Base);
+            size_t ShmSize;
+            int DispUnit;
+            m_MetadataNodeComm.Win_shared_query(m_MetadataWin, 0, &ShmSize,
+                                                &DispUnit, &Base);
+        }
+        if (m_Comm.Rank() == 0)
+        {
+            std::memcpy(Base, m_Metadata.m_Buffer.data(), MetadataSize);
+        }
+    }
+    else
+    {
+        // alone on this node, a private buffer is just as good
+        m_Metadata.Resize(MetadataSize, "allocating metadata buffer, in call "
+                                        "to BP5Reader Open");
+        Base = m_Metadata.m_Buffer.data();
+    }
+
+    if (NodeLeader)
+    {
+        LeaderComm.Bcast(Base, MetadataSize, 0);
+    }
+
+    if (m_MetadataNodeComm.Size() > 1)
+    {
+        m_MetadataNodeComm.Barrier();
+        m_SharedMetadata = Base;
+        m_Metadata.m_Buffer.clear();
+        m_Metadata.m_Buffer.shrink_to_fit();
+    }
+}
+
+void BP5Reader::FreeSharedMetadata()
+{
+    if (m_SharedMetadata)
+    {
+        m_MetadataNodeComm.Win_free(m_MetadataWin);
+        m_SharedMetadata = nullptr;
+    }
+}
+
 void BP5Reader::ParseMetadataIndex(format::BufferSTL &bufferSTL,
                                    const size_t absoluteStartPos,
                                    const bool hasHeader, const bool oneStepOnly)
@@ -760,7 +1181,12 @@ void BP5Reader::DoClose(const int transportIndex)
 {
     PERFSTUBS_SCOPED_TIMER("BP5Reader::Close");
     m_DataFileManager.CloseFiles();
+    for (auto &FileManager : m_ThreadFileManagers)
+    {
+        FileManager->CloseFiles();
+    }
     m_MDFileManager.CloseFiles();
+    FreeSharedMetadata();
 }
 
 // DoBlocksInfo will not be called because MinBlocksInfo is operative
@@ -21,6 +21,7 @@
 
 #include <chrono>
 #include <map>
+#include <memory>
 #include <vector>
 
 namespace adios2
@@ -58,6 +59,10 @@ public:
     MinVarInfo *MinBlocksInfo(const VariableBase &, const size_t Step) const;
     bool VariableMinMax(const VariableBase &, const size_t Step,
                         MinMaxStruct &MinMax);
+    bool VarShape(const VariableBase &, const size_t Step,
+                  Dims &Shape) const;
+
+    size_t DebugGetMappedReads() const final;
 
 private:
     format::BP5Deserializer *m_BP5Deserializer = nullptr;
@@ -79,6 +84,17 @@ private:
     /* transport manager for managing data file(s) */
     transportman::TransportMan m_DataFileManager;
 
+    /* number of threads reading data in PerformGets */
+    unsigned int m_Threads = 1;
+    /* false once the data transport turned out not to support mapping */
+    bool m_CanMapData = true;
+    /* read requests served from the map, see DebugGetMappedReads */
+    size_t m_MappedReads = 0;
+    /* data file managers for the additional reader threads (m_Threads - 1),
+     * each thread keeps its own open subfiles */
+    std::vector<std::unique_ptr<transportman::TransportMan>>
+        m_ThreadFileManagers;
+
     /* transport manager for managing the metadata index file */
     transportman::TransportMan m_MDIndexFileManager;
     /* transport manager for managing the metadata index file */
@@ -199,13 +215,95 @@ private:
     format::BufferSTL m_MetadataIndex;
     format::BufferSTL m_MetaMetadata;
     format::BufferSTL m_Metadata;
+    /* with NodeSharedMetadata, md.0 lives in a read-only shared memory
+     * segment held once per node instead of in m_Metadata */
+    helper::Comm m_MetadataNodeComm;
+    helper::Comm::Win m_MetadataWin;
+    char *m_SharedMetadata = nullptr;
+    /** Base address of the md.0 contents */
+    char *MetadataBuffer()
+    {
+        return m_SharedMetadata ? m_SharedMetadata
+                                : m_Metadata.m_Buffer.data();
+    }
+    /** Distribute md.0 from rank 0 to one shared segment per node */
+    void ShareMetadataOnNode();
+    void FreeSharedMetadata();
     uint64_t MetadataExpectedMinFileSize(const std::string &IdxFileName,
                                          bool hasHeader);
     void InstallMetaMetaData(format::BufferSTL MetaMetadata);
-    void InstallMetadataForTimestep(size_t Step);
-    void ReadData(const size_t WriterRank, const size_t Timestep,
-                  const size_t StartOffset, const size_t Length,
-                  char *Destination);
+    void InstallMetadataForTimestep(size_t Step, bool Variables = true,
+                                    bool Attributes = true);
+    /** Check without decoding if a step's metadata defines variables that
+     * are not known yet (lazy metadata in random access mode) */
+    bool StepHasNewVariables(size_t Step);
+
+    /** A contiguous byte range in one subfile */
+    struct ReadExtent
+    {
+        ReadExtent(size_t SubfileNum, size_t FilePos, size_t Length,
+                   char *Destination)
+        : SubfileNum(SubfileNum), FilePos(FilePos), Length(Length),
+          Destination(Destination)
+        {
+        }
+        size_t SubfileNum;
+        size_t FilePos;
+        size_t Length;
+        char *Destination;
+        /** if not empty, the Length bytes are read into these buffers in one
+         * vectored read instead of into Destination */
+        std::vector<core::iovec> Scatter;
+    };
+
+    /** A piece of a coalesced read that belongs to a read request */
+    struct ReadCopyBack
+    {
+        const char *Source;
+        char *Destination;
+        size_t Length;
+    };
+
+    /** Translate a writer's (step, offset, length) data range into the
+     * subfile byte ranges holding it (one per flush it spans).
+     * Destination may be nullptr to only locate the data. */
+    void GetDataExtents(const size_t WriterRank, const size_t Timestep,
+                        const size_t StartOffset, const size_t Length,
+                        char *Destination, std::vector<ReadExtent> &Extents);
+
+    /** Open a data subfile in the given file manager if not open yet */
+    void OpenSubfile(transportman::TransportMan &FileManager,
+                     const size_t SubfileNum);
+
+    /** Transport parameters for data subfiles: those of the IO's first
+     * transport without its Name */
+    Params SubfileParameters() const;
+
+    /** Pointer to a writer's (step, offset, length) data range if it is
+     * contiguous in its subfile and the transport can map it (mmap
+     * library), nullptr otherwise */
+    const char *MapData(const size_t WriterRank, const size_t Timestep,
+                        const size_t StartOffset, const size_t Length);
+
+    /** Read one byte range using the given file manager, opening the
+     * subfile in it if necessary */
+    void ReadExtentData(transportman::TransportMan &FileManager,
+                        const ReadExtent &Extent);
+
+    /** Sort extents by subfile and position, coalesce ranges closer than
+     * ReadMergeGap and split ranges larger than MaxReadSize.
+     * Coalesced ranges that do not overlap and fit in MaxReadSize are read
+     * with a single vectored read straight into their destinations, the
+     * gaps between them into a scratch buffer of their own. Other coalesced
+     * ranges are read into MergeBuffers and copied to their destinations
+     * through CopyBacks afterwards. */
+    void ScheduleReads(std::vector<ReadExtent> &Extents,
+                       std::vector<ReadExtent> &Tasks,
+                       std::vector<std::vector<char>> &MergeBuffers,
+                       std::vector<ReadCopyBack> &CopyBacks);
+
+    /** Execute read tasks on up to m_Threads threads */
+    void ExecuteReads(const std::vector<ReadExtent> &Tasks);
 
     struct WriterMapStruct
     {
@@ -12,13 +12,20 @@
 #include "adios2/common/ADIOSMacros.h"
 #include "adios2/core/IO.h"
 #include "adios2/helper/adiosFunctions.h" //CheckIndexRange
+#include "adios2/toolkit/burstbuffer/FileDrainerSingleThread.h"
+#ifndef _WIN32
+#include "adios2/toolkit/burstbuffer/FileDrainerMultiThread.h"
+#endif
 #include "adios2/toolkit/format/buffer/chunk/ChunkV.h"
 #include "adios2/toolkit/format/buffer/malloc/MallocV.h"
 #include "adios2/toolkit/transport/file/FileFStream.h"
 #include <adios2-perfstubs-interface.h>
 
+#include <algorithm> // std::max
 #include <ctime>
 #include <iostream>
+#include <numeric> // std::accumulate
+#include <thread>
 
 namespace adios2
 {
@@ -43,6 +50,20 @@ BP5Writer::BP5Writer(IO &io, const std::string &name, const Mode mode,
     Init();
 }
 
+BP5Writer::~BP5Writer()
+{
+    // Close() has joined the metadata thread unless it threw
+    if (m_MetadataThread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_MetadataMutex);
+            m_MetadataThreadFinish = true;
+            m_MetadataCV.notify_all();
+        }
+        m_MetadataThread.join();
+    }
+}
+
 StepStatus BP5Writer::BeginStep(StepMode mode, const float timeoutSeconds)
 {
     if (m_BetweenStepPairs)
@@ -92,18 +113,7 @@ StepStatus BP5Writer::BeginStep(StepMode mode, const float timeoutSeconds)
         }
     }
 
-    if (m_Parameters.BufferVType == (int)BufferVType::MallocVType)
-    {
-        m_BP5Serializer.InitStep(new MallocV("BP5Writer", false,
-                                             m_Parameters.InitialBufferSize,
-                                             m_Parameters.GrowthFactor));
-    }
-    else
-    {
-        m_BP5Serializer.InitStep(new ChunkV("BP5Writer",
-                                            false /* always copy */,
-                                            m_Parameters.BufferChunkSize));
-    }
+    m_BP5Serializer.InitStep(NewDataBuffer());
     m_ThisTimestepDataSize = 0;
 
     ts = Now() - m_EngineStart;
@@ -139,11 +149,29 @@ void BP5Writer::WriteMetaMetadata(
 }
 
 uint64_t
-BP5Writer::WriteMetadata(const std::vector<core::iovec> &MetaDataBlocks,
-                         const std::vector<core::iovec> &AttributeBlocks)
+BP5Writer::MetadataSize(const std::vector<core::iovec> &MetaDataBlocks,
+                        const std::vector<core::iovec> &AttributeBlocks) const
+{
+    // must match what WriteMetadata accounts for
+    uint64_t MetaDataSize = sizeof(uint64_t);
+    MetaDataSize += 2 * sizeof(uint64_t) * AttributeBlocks.size();
+    for (auto &b : MetaDataBlocks)
+    {
+        if (b.iov_base)
+            MetaDataSize += b.iov_len;
+    }
+    for (auto &b : AttributeBlocks)
+    {
+        if (b.iov_base)
+            MetaDataSize += b.iov_len;
+    }
+    return MetaDataSize;
+}
+
+void BP5Writer::WriteMetadata(const std::vector<core::iovec> &MetaDataBlocks,
+                              const std::vector<core::iovec> &AttributeBlocks)
 {
     uint64_t MDataTotalSize = 0;
-    uint64_t MetaDataSize = 0;
     std::vector<uint64_t> SizeVector;
     std::vector<uint64_t> AttrSizeVector;
     SizeVector.reserve(MetaDataBlocks.size());
@@ -157,21 +185,16 @@ BP5Writer::WriteMetadata(const std::vector<core::iovec> &MetaDataBlocks,
         MDataTotalSize += sizeof(uint64_t) + b.iov_len;
         AttrSizeVector.push_back(b.iov_len);
     }
-    MetaDataSize = 0;
     m_FileMetadataManager.WriteFiles((char *)&MDataTotalSize, sizeof(uint64_t));
-    MetaDataSize += sizeof(uint64_t);
     m_FileMetadataManager.WriteFiles((char *)SizeVector.data(),
                                      sizeof(uint64_t) * SizeVector.size());
-    MetaDataSize += sizeof(uint64_t) * AttrSizeVector.size();
     m_FileMetadataManager.WriteFiles((char *)AttrSizeVector.data(),
                                      sizeof(uint64_t) * AttrSizeVector.size());
-    MetaDataSize += sizeof(uint64_t) * AttrSizeVector.size();
     for (auto &b : MetaDataBlocks)
     {
         if (!b.iov_base)
             continue;
         m_FileMetadataManager.WriteFiles((char *)b.iov_base, b.iov_len);
-        MetaDataSize += b.iov_len;
     }
 
     for (auto &b : AttributeBlocks)
@@ -179,11 +202,92 @@ BP5Writer::WriteMetadata(const std::vector<core::iovec> &MetaDataBlocks,
         if (!b.iov_base)
             continue;
         m_FileMetadataManager.WriteFiles((char *)b.iov_base, b.iov_len);
-        MetaDataSize += b.iov_len;
     }
+}
 
-    m_MetaDataPos += MetaDataSize;
-    return MetaDataSize;
+void BP5Writer::QueueMetadataWrite(std::function<void()> &&write)
+{
+    if (!m_Parameters.AsyncMetadataWrite)
+    {
+        write();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_MetadataMutex);
+    if (!m_MetadataThread.joinable())
+    {
+        m_MetadataThreadFinish = false;
+        m_MetadataThread = std::thread(&BP5Writer::MetadataThread, this);
+    }
+    m_MetadataCV.wait(lock, [&] {
+        return m_MetadataQueue.size() <
+                   m_Parameters.MaxQueuedMetadataWrites ||
+               m_MetadataError;
+    });
+    if (m_MetadataError)
+    {
+        std::exception_ptr error = m_MetadataError;
+        m_MetadataError = nullptr;
+        std::rethrow_exception(error);
+    }
+    m_MetadataQueue.push_back(std::move(write));
+    m_MetadataCV.notify_all();
+}
+
+void BP5Writer::WaitForMetadataWrites()
+{
+    if (!m_MetadataThread.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_MetadataMutex);
+        m_MetadataThreadFinish = true;
+        m_MetadataCV.notify_all();
+    }
+    m_MetadataThread.join();
+    if (m_MetadataError)
+    {
+        std::exception_ptr error = m_MetadataError;
+        m_MetadataError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void BP5Writer::MetadataThread()
+{
+    std::unique_lock<std::mutex> lock(m_MetadataMutex);
+    while (true)
+    {
+        m_MetadataCV.wait(lock, [&] {
+            return !m_MetadataQueue.empty() || m_MetadataThreadFinish;
+        });
+        if (m_MetadataQueue.empty())
+        {
+            break;
+        }
+        std::function<void()> write = std::move(m_MetadataQueue.front());
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            write();
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        m_MetadataQueue.pop_front();
+        if (error)
+        {
+            // later writes, e.g. the index entry of this metadata, must not
+            // make it to the files
+            m_MetadataError = error;
+            m_MetadataQueue.clear();
+        }
+        m_MetadataCV.notify_all();
+    }
 }
 
 void BP5Writer::AsyncWriteDataCleanup()
@@ -311,9 +415,12 @@ void BP5Writer::WriteData_EveryoneWrites(format::BufferV *Data,
 void BP5Writer::WriteMetadataFileIndex(uint64_t MetaDataPos,
                                        uint64_t MetaDataSize)
 {
-    m_FileMetadataManager.FlushFiles();
-
-    std::vector<uint64_t> buf(
+    // the entry is built from the current step's state, it is written after
+    // all metadata queued before it
+    std::shared_ptr<std::vector<uint64_t>> index =
+        std::make_shared<std::vector<uint64_t>>();
+    std::vector<uint64_t> &buf = *index;
+    buf.resize(
         4 + ((FlushPosSizeInfo.size() * 2) + 1) * m_Comm.Size() + 3 +
         m_Comm.Size());
     buf.resize(4 + ((FlushPosSizeInfo.size() * 2) + 1) * m_Comm.Size());
@@ -351,8 +458,11 @@ void BP5Writer::WriteMetadataFileIndex(uint64_t MetaDataPos,
         pos += (FlushPosSizeInfo.size() * 2) + 1;
     }
 
-    m_FileMetadataIndexManager.WriteFiles((char *)buf.data(),
-                                          buf.size() * sizeof(uint64_t));
+    QueueMetadataWrite([this, index]() {
+        m_FileMetadataManager.FlushFiles();
+        m_FileMetadataIndexManager.WriteFiles(
+            (char *)index->data(), index->size() * sizeof(uint64_t));
+    });
 
 #ifdef DUMPDATALOCINFO
     std::cout << "Flush count is :" << FlushPosSizeInfo.size() << std::endl;
@@ -472,6 +582,11 @@ void BP5Writer::EndStep()
     /* the first */
 
     m_ThisTimestepDataSize += TSInfo.DataBuffer->Size();
+    if (m_Parameters.BufferVType == (int)BufferVType::Auto &&
+        !m_AutoBufferVSelected)
+    {
+        SelectAutoBufferV();
+    }
 
     m_Profiler.Start("AWD");
     // TSInfo destructor would delete the DataBuffer so we need to save it
@@ -488,22 +603,32 @@ void BP5Writer::EndStep()
         TSInfo.NewMetaMetaBlocks, TSInfo.MetaEncodeBuffer,
         TSInfo.AttributeEncodeBuffer, m_ThisTimestepDataSize, m_StartDataPos);
 
-    size_t LocalSize = MetaBuffer.size();
-    std::vector<size_t> RecvCounts = m_Comm.GatherValues(LocalSize, 0);
-
-    std::vector<char> *RecvBuffer = new std::vector<char>;
-    if (m_Comm.Rank() == 0)
+    std::vector<size_t> RecvCounts;
+    // on rank 0 the metadata blocks point into RecvBuffer until written
+    std::shared_ptr<std::vector<char>> RecvBuffer =
+        std::make_shared<std::vector<char>>();
+    if (m_Parameters.NodeMetadataAggregation)
     {
-        uint64_t TotalSize = 0;
-        for (auto &n : RecvCounts)
-            TotalSize += n;
-        RecvBuffer->resize(TotalSize);
+        GatherMetadataByNode(MetaBuffer, *RecvBuffer, RecvCounts);
     }
+    else
+    {
+        size_t LocalSize = MetaBuffer.size();
+        RecvCounts = m_Comm.GatherValues(LocalSize, 0);
 
-    m_Profiler.Start("meta_gather");
-    m_Comm.GathervArrays(MetaBuffer.data(), LocalSize, RecvCounts.data(),
-                         RecvCounts.size(), RecvBuffer->data(), 0);
-    m_Profiler.Stop("meta_gather");
+        if (m_Comm.Rank() == 0)
+        {
+            uint64_t TotalSize = 0;
+            for (auto &n : RecvCounts)
+                TotalSize += n;
+            RecvBuffer->resize(TotalSize);
+        }
+
+        m_Profiler.Start("meta_gather");
+        m_Comm.GathervArrays(MetaBuffer.data(), LocalSize, RecvCounts.data(),
+                             RecvCounts.size(), RecvBuffer->data(), 0);
+        m_Profiler.Stop("meta_gather");
+    }
 
     if (m_Comm.Rank() == 0)
     {
@@ -511,33 +636,42 @@ void BP5Writer::EndStep()
         std::vector<uint64_t> DataSizes;
         std::vector<core::iovec> AttributeBlocks;
         auto Metadata = m_BP5Serializer.BreakoutContiguousMetadata(
-            RecvBuffer, RecvCounts, UniqueMetaMetaBlocks, AttributeBlocks,
-            DataSizes, m_WriterDataPos);
+            RecvBuffer.get(), RecvCounts, UniqueMetaMetaBlocks, AttributeBlocks,
+            DataSizes, m_WriterDataPos, m_MetadataBlockRanks);
+        std::shared_ptr<format::BufferSTL> b, bi;
         if (m_MetaDataPos == 0)
         {
             //  First time, write the headers
-            format::BufferSTL b;
-            MakeHeader(b, "Metadata", false);
-            m_FileMetadataManager.WriteFiles(b.m_Buffer.data(), b.m_Position);
-            m_MetaDataPos = b.m_Position;
-            format::BufferSTL bi;
-            MakeHeader(bi, "Index Table", true);
-            m_FileMetadataIndexManager.WriteFiles(bi.m_Buffer.data(),
-                                                  bi.m_Position);
-            // where each rank's data will end up
-            m_FileMetadataIndexManager.WriteFiles((char *)m_Assignment.data(),
-                                                  sizeof(m_Assignment[0]) *
-                                                      m_Assignment.size());
+            b = std::make_shared<format::BufferSTL>();
+            MakeHeader(*b, "Metadata", false);
+            m_MetaDataPos = b->m_Position;
+            bi = std::make_shared<format::BufferSTL>();
+            MakeHeader(*bi, "Index Table", true);
         }
-        WriteMetaMetadata(UniqueMetaMetaBlocks);
         m_LatestMetaDataPos = m_MetaDataPos;
-        m_LatestMetaDataSize = WriteMetadata(Metadata, AttributeBlocks);
+        m_LatestMetaDataSize = MetadataSize(Metadata, AttributeBlocks);
+        m_MetaDataPos += m_LatestMetaDataSize;
+        QueueMetadataWrite([this, RecvBuffer, b, bi, UniqueMetaMetaBlocks,
+                            Metadata, AttributeBlocks]() {
+            if (b)
+            {
+                m_FileMetadataManager.WriteFiles(b->m_Buffer.data(),
+                                                 b->m_Position);
+                m_FileMetadataIndexManager.WriteFiles(bi->m_Buffer.data(),
+                                                      bi->m_Position);
+                // where each rank's data will end up
+                m_FileMetadataIndexManager.WriteFiles(
+                    (char *)m_Assignment.data(),
+                    sizeof(m_Assignment[0]) * m_Assignment.size());
+            }
+            WriteMetaMetadata(UniqueMetaMetaBlocks);
+            WriteMetadata(Metadata, AttributeBlocks);
+        });
         if (!m_Parameters.AsyncWrite)
         {
             WriteMetadataFileIndex(m_LatestMetaDataPos, m_LatestMetaDataSize);
         }
     }
-    delete RecvBuffer;
 
     if (m_Parameters.AsyncWrite)
     {
@@ -576,6 +710,28 @@ void BP5Writer::InitParameters()
     m_WriteToBB = !(m_Parameters.BurstBufferPath.empty());
     m_DrainBB = m_WriteToBB && m_Parameters.BurstBufferDrain;
 
+    if (m_DrainBB)
+    {
+#ifndef _WIN32
+        if (m_Parameters.BurstBufferDrainThreads > 1 ||
+            m_Parameters.BurstBufferDrainBandwidth > 0)
+        {
+            m_FileDrainer.reset(new burstbuffer::FileDrainerMultiThread(
+                m_Parameters.BurstBufferDrainThreads,
+                m_Parameters.BurstBufferDrainBandwidth));
+        }
+        else
+#endif
+        {
+            m_FileDrainer.reset(new burstbuffer::FileDrainerSingleThread());
+        }
+    }
+
+    if (m_Parameters.AggregationType == (int)AggregationType::Auto)
+    {
+        InitAutoAggregation();
+    }
+
     if (m_Parameters.NumAggregators > static_cast<unsigned int>(m_Comm.Size()))
     {
         m_Parameters.NumAggregators = static_cast<unsigned int>(m_Comm.Size());
@@ -595,6 +751,43 @@ void BP5Writer::InitParameters()
         // Limiting to max 64MB page size
         m_Parameters.FileSystemPageSize = 67108864;
     }
+
+    m_BP5Serializer.m_StatsThreads = std::max(1u, m_Parameters.StatsThreads);
+
+    m_Parameters.MaxQueuedMetadataWrites =
+        std::max(1u, m_Parameters.MaxQueuedMetadataWrites);
+
+    m_BP5Serializer.m_MetadataDeltaInterval =
+        m_Parameters.MetadataDeltaInterval;
+    m_BP5Serializer.m_DeferredCompression = m_Parameters.DeferredCompression;
+    if (m_Parameters.DeferredCompression)
+    {
+        unsigned int CompressionThreads = m_Parameters.CompressionThreads;
+        if (CompressionThreads == 0)
+        {
+            /* share the node's hardware threads among the writer processes
+             * running on it, but use at most 16 threads */
+            helper::Comm nodeComm = m_Comm.GroupByShm();
+            const unsigned int hwThreads = std::thread::hardware_concurrency();
+            const unsigned int nodeProcs =
+                static_cast<unsigned int>(nodeComm.Size());
+            CompressionThreads =
+                std::max(1u, std::min(16u, hwThreads / nodeProcs));
+        }
+        m_BP5Serializer.m_CompressionThreads = CompressionThreads;
+    }
+
+    // BufferVType=Auto starts with ChunkV until SelectAutoBufferV()
+    UseBufferV = (m_Parameters.BufferVType == (int)BufferVType::MallocVType)
+                     ? BufferVType::MallocVType
+                     : BufferVType::ChunkVType;
+    if ((UseBufferV == BufferVType::ChunkVType) &&
+        (m_Parameters.BufferChunkPoolSize > 0))
+    {
+        m_ChunkPool.reset(new format::ChunkPool(
+            m_Parameters.BufferChunkPoolSize, m_Parameters.BufferChunkHugePages,
+            m_Parameters.BufferChunkFirstTouch));
+    }
 }
 
 uint64_t BP5Writer::CountStepsInMetadataIndex(format::BufferSTL &bufferSTL)
@@ -819,8 +1012,11 @@ void BP5Writer::InitAggregator()
     }
     else
     {
-        size_t numNodes = m_AggregatorTwoLevelShm.PreInit(m_Comm);
-        (void)numNodes;
+        // PreInit may have been called already by InitAutoAggregation
+        if (!m_AggregatorTwoLevelShm.PreInitCalled)
+        {
+            m_AggregatorTwoLevelShm.PreInit(m_Comm);
+        }
         m_AggregatorTwoLevelShm.Init(m_Parameters.NumAggregators,
                                      m_Parameters.NumSubFiles, m_Comm);
 
@@ -841,6 +1037,91 @@ void BP5Writer::InitAggregator()
         m_Aggregator =
             static_cast<aggregator::MPIAggregator *>(&m_AggregatorTwoLevelShm);
     }
+
+    if (m_Parameters.NodeMetadataAggregation)
+    {
+        InitMetadataAggregation();
+    }
+}
+
+void BP5Writer::InitMetadataAggregation()
+{
+    // reuse the node communicators of the two-level aggregator
+    if (!m_AggregatorTwoLevelShm.PreInitCalled)
+    {
+        m_AggregatorTwoLevelShm.PreInit(m_Comm);
+    }
+    helper::Comm &NodeComm = m_AggregatorTwoLevelShm.m_NodeComm;
+    helper::Comm &LeaderComm = m_AggregatorTwoLevelShm.m_OnePerNodeComm;
+
+    std::vector<size_t> NodeRanks =
+        NodeComm.GatherValues(static_cast<size_t>(m_Comm.Rank()), 0);
+    if (NodeComm.Rank() == 0)
+    {
+        m_MetadataNodeSizes = LeaderComm.GatherValues(NodeRanks.size(), 0);
+        if (LeaderComm.Rank() == 0)
+        {
+            m_MetadataBlockRanks.resize(m_Comm.Size());
+        }
+        LeaderComm.GathervArrays(NodeRanks.data(), NodeRanks.size(),
+                                 m_MetadataNodeSizes.data(),
+                                 m_MetadataNodeSizes.size(),
+                                 m_MetadataBlockRanks.data(), 0);
+    }
+}
+
+void BP5Writer::GatherMetadataByNode(const std::vector<char> &MetaBuffer,
+                                     std::vector<char> &RecvBuffer,
+                                     std::vector<size_t> &RecvCounts)
+{
+    helper::Comm &NodeComm = m_AggregatorTwoLevelShm.m_NodeComm;
+    helper::Comm &LeaderComm = m_AggregatorTwoLevelShm.m_OnePerNodeComm;
+
+    m_Profiler.Start("meta_gather_node");
+    std::vector<size_t> NodeCounts =
+        NodeComm.GatherValues(MetaBuffer.size(), 0);
+    std::vector<char> NodeBuffer;
+    if (NodeComm.Rank() == 0)
+    {
+        NodeBuffer.resize(
+            std::accumulate(NodeCounts.begin(), NodeCounts.end(), size_t(0)));
+    }
+    NodeComm.GathervArrays(MetaBuffer.data(), MetaBuffer.size(),
+                           NodeCounts.data(), NodeCounts.size(),
+                           NodeBuffer.data(), 0);
+    m_Profiler.Stop("meta_gather_node");
+
+    if (NodeComm.Rank() != 0)
+    {
+        return;
+    }
+
+    m_Profiler.Start("meta_dedup");
+    std::vector<char> NodeMetadata =
+        m_BP5Serializer.DeduplicateContiguousMetadata(NodeBuffer, NodeCounts);
+    std::vector<char>().swap(NodeBuffer);
+    m_Profiler.Stop("meta_dedup");
+
+    m_Profiler.Start("meta_gather");
+    // first the size of each block, then the blocks of every node
+    if (LeaderComm.Rank() == 0)
+    {
+        RecvCounts.resize(m_Comm.Size());
+    }
+    LeaderComm.GathervArrays(NodeCounts.data(), NodeCounts.size(),
+                             m_MetadataNodeSizes.data(),
+                             m_MetadataNodeSizes.size(), RecvCounts.data(), 0);
+    std::vector<size_t> NodeTotals =
+        LeaderComm.GatherValues(NodeMetadata.size(), 0);
+    if (LeaderComm.Rank() == 0)
+    {
+        RecvBuffer.resize(
+            std::accumulate(NodeTotals.begin(), NodeTotals.end(), size_t(0)));
+    }
+    LeaderComm.GathervArrays(NodeMetadata.data(), NodeMetadata.size(),
+                             NodeTotals.data(), NodeTotals.size(),
+                             RecvBuffer.data(), 0);
+    m_Profiler.Stop("meta_gather");
 }
 
 void BP5Writer::InitTransports()
@@ -886,10 +1167,10 @@ void BP5Writer::InitTransports()
             m_DrainSubStreamNames = GetBPSubStreamNames(
                 drainTransportNames, m_Aggregator->m_SubStreamIndex);
             /* start up BB thread */
-            //            m_FileDrainer.SetVerbose(
+            //            m_FileDrainer->SetVerbose(
             //				     m_Parameters.BurstBufferVerbose,
             //				     m_Comm.Rank());
-            m_FileDrainer.Start();
+            m_FileDrainer->Start();
         }
     }
 
@@ -931,6 +1212,8 @@ void BP5Writer::InitTransports()
         m_FileDataManager.OpenFiles(m_SubStreamNames, m_OpenMode,
                                     m_IO.m_TransportsParameters, useProfiler,
                                     *DataWritingComm);
+        m_FileDataManager.m_ConcurrentWrites =
+            m_Parameters.ConcurrentTransportWrites;
     }
 
     if (m_IAmDraining)
@@ -939,7 +1222,7 @@ void BP5Writer::InitTransports()
         {
             for (const auto &name : m_DrainSubStreamNames)
             {
-                m_FileDrainer.AddOperationOpen(name, m_OpenMode);
+                m_FileDrainer->AddOperationOpen(name, m_OpenMode);
             }
         }
     }
@@ -970,11 +1253,11 @@ void BP5Writer::InitTransports()
 
             for (const auto &name : m_DrainMetadataFileNames)
             {
-                m_FileDrainer.AddOperationOpen(name, m_OpenMode);
+                m_FileDrainer->AddOperationOpen(name, m_OpenMode);
             }
             for (const auto &name : m_DrainMetadataIndexFileNames)
             {
-                m_FileDrainer.AddOperationOpen(name, m_OpenMode);
+                m_FileDrainer->AddOperationOpen(name, m_OpenMode);
             }
         }
     }
@@ -1113,10 +1396,10 @@ void BP5Writer::UpdateActiveFlag(const bool active)
     {
         for (size_t i = 0; i < m_MetadataIndexFileNames.size(); ++i)
         {
-            m_FileDrainer.AddOperationWriteAt(m_DrainMetadataIndexFileNames[i],
+            m_FileDrainer->AddOperationWriteAt(m_DrainMetadataIndexFileNames[i],
                                               m_ActiveFlagPosition, 1,
                                               &activeChar);
-            m_FileDrainer.AddOperationSeekEnd(m_DrainMetadataIndexFileNames[i]);
+            m_FileDrainer->AddOperationSeekEnd(m_DrainMetadataIndexFileNames[i]);
         }
     }
 }
@@ -1286,19 +1569,7 @@ void BP5Writer::ExitComputationBlock() noexcept
 
 void BP5Writer::FlushData(const bool isFinal)
 {
-    BufferV *DataBuf;
-    if (m_Parameters.BufferVType == (int)BufferVType::MallocVType)
-    {
-        DataBuf = m_BP5Serializer.ReinitStepData(
-            new MallocV("BP5Writer", false, m_Parameters.InitialBufferSize,
-                        m_Parameters.GrowthFactor));
-    }
-    else
-    {
-        DataBuf = m_BP5Serializer.ReinitStepData(
-            new ChunkV("BP5Writer", false /* always copy */,
-                       m_Parameters.BufferChunkSize));
-    }
+    BufferV *DataBuf = m_BP5Serializer.ReinitStepData(NewDataBuffer());
 
     auto databufsize = DataBuf->Size();
     WriteData(DataBuf);
@@ -1359,11 +1630,13 @@ void BP5Writer::DoClose(const int transportIndex)
 
     if (m_Comm.Rank() == 0)
     {
-        // close metadata file
-        m_FileMetadataManager.CloseFiles();
+        QueueMetadataWrite([this]() {
+            // close metadata file
+            m_FileMetadataManager.CloseFiles();
 
-        // close metametadata file
-        m_FileMetaMetadataManager.CloseFiles();
+            // close metametadata file
+            m_FileMetaMetadataManager.CloseFiles();
+        });
     }
 
     if (m_Parameters.AsyncWrite)
@@ -1386,6 +1659,7 @@ void BP5Writer::DoClose(const int transportIndex)
         {
             WriteMetadataFileIndex(m_LatestMetaDataPos, m_LatestMetaDataSize);
         }
+        WaitForMetadataWrites();
         // close metadata index file
         UpdateActiveFlag(false);
         m_FileMetadataIndexManager.CloseFiles();
@@ -1405,6 +1679,7 @@ void BP5Writer::FlushProfiler()
         if (transportTypes[i].compare(0, 4, "File") == 0)
         {
             fileTransportIdx = static_cast<int>(i);
+            break;
         }
     }
 
@@ -1422,9 +1697,15 @@ void BP5Writer::FlushProfiler()
 
     // m_Profiler.WriteOut(transportTypes, transportProfilers);
 
-    const std::string lineJSON(
-        m_Profiler.GetRankProfilingJSON(transportTypes, transportProfilers) +
-        ",\n");
+    std::string rankLog(
+        m_Profiler.GetRankProfilingJSON(transportTypes, transportProfilers));
+    if (m_DrainBB && m_IAmDraining)
+    {
+        // drain progress so far, as the last entry of this rank
+        rankLog.insert(rankLog.size() - 2,
+                       ", " + m_FileDrainer->GetProfilingJSON());
+    }
+    const std::string lineJSON(rankLog + ",\n");
 
     const std::vector<char> profilingJSON(
         m_Profiler.AggregateProfilingJSON(lineJSON));
@@ -1446,7 +1727,7 @@ void BP5Writer::FlushProfiler()
             {
                 profileFileName = bpTargetNames[0] + "_profiling.json";
             }
-            m_FileDrainer.AddOperationWrite(
+            m_FileDrainer->AddOperationWrite(
                 profileFileName, profilingJSON.size(), profilingJSON.data());
         }
         else
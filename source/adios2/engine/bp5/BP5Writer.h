@@ -17,13 +17,21 @@
 #include "adios2/helper/adiosMemory.h" // PaddingToAlignOffset
 #include "adios2/toolkit/aggregator/mpi/MPIChain.h"
 #include "adios2/toolkit/aggregator/mpi/MPIShmChain.h"
-#include "adios2/toolkit/burstbuffer/FileDrainerSingleThread.h"
+#include "adios2/toolkit/burstbuffer/FileDrainer.h"
 #include "adios2/toolkit/format/bp5/BP5Serializer.h"
 #include "adios2/toolkit/format/buffer/BufferV.h"
+#include "adios2/toolkit/format/buffer/chunk/ChunkPool.h"
 #include "adios2/toolkit/shm/Spinlock.h"
 #include "adios2/toolkit/shm/TokenChain.h"
 #include "adios2/toolkit/transportman/TransportMan.h"
 
+#include <condition_variable>
+#include <deque>
+#include <exception> // std::exception_ptr
+#include <functional>
+#include <mutex>
+#include <thread>
+
 namespace adios2
 {
 namespace core
@@ -44,7 +52,7 @@ public:
     BP5Writer(IO &io, const std::string &name, const Mode mode,
               helper::Comm comm);
 
-    ~BP5Writer() = default;
+    ~BP5Writer();
 
     StepStatus BeginStep(StepMode mode,
                          const float timeoutSeconds = -1.0) final;
@@ -56,6 +64,10 @@ public:
     size_t DebugGetDataBufferSize() const final;
 
 private:
+    /** Recycles ChunkV chunks across steps when BufferChunkPoolSize > 0.
+     * Declared before the serializer so that it outlives the buffers. */
+    std::unique_ptr<format::ChunkPool> m_ChunkPool;
+
     /** Single object controlling BP buffering */
     format::BP5Serializer m_BP5Serializer;
 
@@ -78,8 +90,10 @@ private:
     bool m_WriteToBB = false;
     /** true if burst buffer is drained to disk  */
     bool m_DrainBB = true;
-    /** File drainer thread if burst buffer is used */
-    burstbuffer::FileDrainerSingleThread m_FileDrainer;
+    /** File drainer thread(s) if burst buffer is used, created in
+     * InitParameters when m_DrainBB, multi-threaded if
+     * BurstBufferDrainThreads > 1 */
+    std::unique_ptr<burstbuffer::FileDrainer> m_FileDrainer;
     /** m_Name modified with burst buffer path if BB is used,
      * == m_Name otherwise.
      * m_Name is a constant of Engine and is the user provided target path
@@ -106,6 +120,22 @@ private:
     void InitParameters() final;
     /** Set up the aggregator */
     void InitAggregator();
+    /** Set up two-level metadata aggregation (NodeMetadataAggregation) */
+    void InitMetadataAggregation();
+    /** AggregationType=Auto: choose the aggregation strategy, the number of
+     * aggregators and subfiles from the node topology and, if AutoProbeSize
+     * is set, a bandwidth probe of the target directory */
+    void InitAutoAggregation();
+    /** Time concurrent writes of AutoProbeSize bytes on each node leader and
+     * return how many streams per node pay off (same on all processes) */
+    unsigned int ProbeStreamsPerNode(const unsigned int maxStreams,
+                                     double &bandwidth);
+    /** BufferVType=Auto: choose the buffer type from the data size of the
+     * first non-empty step */
+    void SelectAutoBufferV();
+    bool m_AutoBufferVSelected = false;
+    /** New data buffer of type UseBufferV for the serializer */
+    format::BufferV *NewDataBuffer();
     /** Complete opening/createing metadata and data files */
     void InitTransports() final;
     /** Allocates memory and starts a PG group */
@@ -155,13 +185,47 @@ private:
      * profilers*/
     void WriteProfilingJSONFile();
 
+    /** Gather the contiguous metadata of all processes on their node
+     * leader, which removes duplicate meta-meta blocks and forwards the
+     * node's metadata to rank 0. On rank 0 RecvCounts holds the block sizes
+     * in the order of m_MetadataBlockRanks. */
+    void GatherMetadataByNode(const std::vector<char> &MetaBuffer,
+                              std::vector<char> &RecvBuffer,
+                              std::vector<size_t> &RecvCounts);
+
     void WriteMetaMetadata(
         const std::vector<format::BP5Base::MetaMetaInfoBlock> MetaMetaBlocks);
 
+    /** Queue the index entry of a step, built from FlushPosSizeInfo and
+     * m_WriterDataPos now, to be written after the queued metadata */
     void WriteMetadataFileIndex(uint64_t MetaDataPos, uint64_t MetaDataSize);
 
-    uint64_t WriteMetadata(const std::vector<core::iovec> &MetaDataBlocks,
-                           const std::vector<core::iovec> &AttributeBlocks);
+    /** bytes WriteMetadata puts into md.0 for these blocks */
+    uint64_t MetadataSize(const std::vector<core::iovec> &MetaDataBlocks,
+                          const std::vector<core::iovec> &AttributeBlocks) const;
+
+    void WriteMetadata(const std::vector<core::iovec> &MetaDataBlocks,
+                       const std::vector<core::iovec> &AttributeBlocks);
+
+    /** Rank 0 writes md.0, mmd.0 and md.idx through this queue. With
+     * AsyncMetadataWrite it is drained in order by one background thread,
+     * so an index entry never reaches the file before its metadata,
+     * otherwise each write runs immediately. With MaxQueuedMetadataWrites
+     * writes pending it blocks. A failed write stops the thread and is
+     * rethrown by the next call on the main thread. */
+    void QueueMetadataWrite(std::function<void()> &&write);
+
+    /** Block until all queued metadata writes are done, join the thread */
+    void WaitForMetadataWrites();
+
+    void MetadataThread();
+
+    std::thread m_MetadataThread;
+    std::deque<std::function<void()>> m_MetadataQueue;
+    bool m_MetadataThreadFinish = false;
+    std::exception_ptr m_MetadataError;
+    std::mutex m_MetadataMutex;
+    std::condition_variable m_MetadataCV;
 
     /** Write Data to disk, in an aggregator chain */
     void WriteData(format::BufferV *Data);
@@ -230,6 +294,12 @@ private:
      */
     std::vector<uint64_t> m_WriterDataPos;
 
+    /** with NodeMetadataAggregation, rank 0 keeps the number of processes
+     * per node and the writer rank of each block in the gathered metadata
+     */
+    std::vector<size_t> m_MetadataNodeSizes;
+    std::vector<size_t> m_MetadataBlockRanks;
+
     bool m_MarshalAttributesNecessary = true;
 
     // where each writer rank writes its data, init in InitBPBuffer;
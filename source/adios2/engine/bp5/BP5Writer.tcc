@@ -52,7 +52,10 @@ void BP5Writer::PutCommon(Variable<T> &variable, const T *values, bool sync)
         /* If arrays is small, force copying to internal buffer to aggregate
          * small writes */
         size_t n = helper::GetTotalSize(variable.m_Count) * sizeof(T);
-        if (n < m_Parameters.MinDeferredSize)
+        /* unless the block is compressed later with the other blocks */
+        const bool compressLater = m_Parameters.DeferredCompression &&
+                                   !variable.m_Operations.empty();
+        if ((n < m_Parameters.MinDeferredSize) && !compressLater)
         {
             sync = true;
         }
@@ -0,0 +1,252 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * BP5Writer_Auto.cpp
+ *
+ * Selection of the aggregation strategy and buffer type in Auto mode
+ */
+
+#include "BP5Writer.h"
+
+#include "adios2/helper/adiosFunctions.h" // CreateDirectory, PathSeparator
+#include "adios2/toolkit/format/buffer/chunk/ChunkV.h"
+#include "adios2/toolkit/format/buffer/malloc/MallocV.h"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace adios2
+{
+namespace core
+{
+namespace engine
+{
+
+using namespace adios2::format;
+
+namespace
+{
+/** max concurrent streams per node tried by the bandwidth probe */
+constexpr unsigned int MaxProbeStreams = 8;
+/** more streams are only used if they improve bandwidth by this factor */
+constexpr double ProbeSpeedup = 1.25;
+} // end anonymous namespace
+
+void BP5Writer::InitAutoAggregation()
+{
+    const size_t numNodes = m_AggregatorTwoLevelShm.PreInit(m_Comm);
+    helper::Comm &NodeComm = m_AggregatorTwoLevelShm.m_NodeComm;
+    const int nodeSize = NodeComm.Size();
+    int minNodeSize, maxNodeSize;
+    m_Comm.Allreduce(&nodeSize, &minNodeSize, 1, helper::Comm::Op::Min);
+    m_Comm.Allreduce(&nodeSize, &maxNodeSize, 1, helper::Comm::Op::Max);
+
+    unsigned int streamsPerNode = 1;
+    double probeBandwidth = 0.0;
+    if (maxNodeSize == 1)
+    {
+        // one process per node, there is nothing to aggregate through
+        // shared memory, every process writes its own subfile
+        m_Parameters.AggregationType = (int)AggregationType::EveryoneWrites;
+        if (!m_Parameters.NumAggregators)
+        {
+            m_Parameters.NumAggregators =
+                static_cast<unsigned int>(m_Comm.Size());
+        }
+    }
+    else
+    {
+        m_Parameters.AggregationType = (int)AggregationType::TwoLevelShm;
+        if (m_Parameters.AutoProbeSize > 0)
+        {
+            streamsPerNode = ProbeStreamsPerNode(
+                std::min(static_cast<unsigned int>(minNodeSize),
+                         MaxProbeStreams),
+                probeBandwidth);
+        }
+        if (!m_Parameters.NumAggregators)
+        {
+            m_Parameters.NumAggregators =
+                static_cast<unsigned int>(numNodes) * streamsPerNode;
+        }
+    }
+    // one subfile per aggregator unless the user asked for fewer
+    if (m_Parameters.NumSubFiles > m_Parameters.NumAggregators)
+    {
+        m_Parameters.NumSubFiles = m_Parameters.NumAggregators;
+    }
+
+    if (m_Parameters.verbose > 0 && m_Comm.Rank() == 0)
+    {
+        std::cout << "BP5 AggregationType=Auto: " << numNodes << " node(s), "
+                  << minNodeSize << "-" << maxNodeSize
+                  << " process(es) per node";
+        if (probeBandwidth > 0.0)
+        {
+            std::cout << ", probe " << static_cast<size_t>(probeBandwidth)
+                      << " MB/s with " << streamsPerNode
+                      << " stream(s) per node";
+        }
+        std::cout << " -> "
+                  << (m_Parameters.AggregationType ==
+                              (int)AggregationType::TwoLevelShm
+                          ? "TwoLevelShm"
+                          : "EveryoneWrites")
+                  << ", NumAggregators=" << m_Parameters.NumAggregators
+                  << ", NumSubFiles=" << m_Parameters.NumSubFiles
+                  << std::endl;
+    }
+}
+
+unsigned int BP5Writer::ProbeStreamsPerNode(const unsigned int maxStreams,
+                                            double &bandwidth)
+{
+    helper::Comm &NodeComm = m_AggregatorTwoLevelShm.m_NodeComm;
+    helper::Comm &LeaderComm = m_AggregatorTwoLevelShm.m_OnePerNodeComm;
+    unsigned int streams = 1;
+    bandwidth = 0.0;
+
+#ifndef _WIN32
+    if (NodeComm.Rank() == 0)
+    {
+        const std::string dir =
+            m_WriteToBB ? m_Parameters.BurstBufferPath : m_Name;
+        helper::CreateDirectory(dir);
+        const std::string prefix = dir + PathSeparator + ".adios2-probe." +
+                                   std::to_string(m_Comm.Rank()) + ".";
+        const size_t size = m_Parameters.AutoProbeSize;
+        const std::vector<char> block(std::min(size, size_t(4194304)), 'x');
+
+        /* write size bytes to each of n files concurrently and make sure
+         * they reach the device, returns the aggregate MB/s or 0 on error */
+        auto lf_Probe = [&](const unsigned int n) -> double {
+            std::vector<int> ok(n, 0);
+            std::vector<std::thread> threads;
+            const TimePoint start = Now();
+            for (unsigned int i = 0; i < n; ++i)
+            {
+                threads.emplace_back([&, i]() {
+                    const std::string name = prefix + std::to_string(i);
+                    int fd = open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+                                  0644);
+                    if (fd == -1)
+                    {
+                        return;
+                    }
+                    size_t written = 0;
+                    while (written < size)
+                    {
+                        const size_t len =
+                            std::min(block.size(), size - written);
+                        const ssize_t w = write(fd, block.data(), len);
+                        if (w <= 0)
+                        {
+                            break;
+                        }
+                        written += static_cast<size_t>(w);
+                    }
+                    ok[i] = (written == size && fsync(fd) == 0);
+                    close(fd);
+                    unlink(name.c_str());
+                });
+            }
+            for (auto &t : threads)
+            {
+                t.join();
+            }
+            const Seconds elapsed = Now() - start;
+            if (std::count(ok.begin(), ok.end(), 0) > 0 ||
+                elapsed.count() <= 0.0)
+            {
+                return 0.0;
+            }
+            return static_cast<double>(n * size) / 1048576.0 /
+                   elapsed.count();
+        };
+
+        bandwidth = lf_Probe(1);
+        while (bandwidth > 0.0 && streams * 2 <= maxStreams)
+        {
+            const double bw = lf_Probe(streams * 2);
+            if (bw < bandwidth * ProbeSpeedup)
+            {
+                break;
+            }
+            streams *= 2;
+            bandwidth = bw;
+        }
+
+        // every node must use the same number of aggregators
+        unsigned int minStreams;
+        LeaderComm.Allreduce(&streams, &minStreams, 1, helper::Comm::Op::Min);
+        streams = minStreams;
+    }
+#endif
+    streams = NodeComm.BroadcastValue<unsigned int>(streams, 0);
+    bandwidth = NodeComm.BroadcastValue<double>(bandwidth, 0);
+    return streams;
+}
+
+void BP5Writer::SelectAutoBufferV()
+{
+    if (m_ThisTimestepDataSize == 0)
+    {
+        // nothing to learn from an empty step, decide at the next one
+        return;
+    }
+    m_AutoBufferVSelected = true;
+
+    /* Data that fits into one chunk is better served by a single buffer
+     * allocated with the right size right away (ChunkV would allocate a
+     * full chunk). Larger data stays in ChunkV, which avoids reallocating
+     * and copying a huge contiguous buffer when it grows. */
+    if (!m_ChunkPool && m_ThisTimestepDataSize <= m_Parameters.BufferChunkSize)
+    {
+        UseBufferV = BufferVType::MallocVType;
+        // leave some room for growth
+        m_Parameters.InitialBufferSize =
+            std::max(m_Parameters.InitialBufferSize,
+                     static_cast<size_t>(m_ThisTimestepDataSize +
+                                         m_ThisTimestepDataSize / 8));
+    }
+    else
+    {
+        UseBufferV = BufferVType::ChunkVType;
+    }
+
+    if (m_Parameters.verbose > 0 && m_Comm.Rank() == 0)
+    {
+        std::cout << "BP5 BufferVType=Auto: " << m_ThisTimestepDataSize
+                  << " bytes in step " << m_WriterStep << " on rank 0 -> "
+                  << (UseBufferV == BufferVType::MallocVType ? "malloc"
+                                                             : "chunk");
+        if (UseBufferV == BufferVType::MallocVType)
+        {
+            std::cout << ", InitialBufferSize="
+                      << m_Parameters.InitialBufferSize;
+        }
+        std::cout << std::endl;
+    }
+}
+
+BufferV *BP5Writer::NewDataBuffer()
+{
+    if (UseBufferV == BufferVType::MallocVType)
+    {
+        return new MallocV("BP5Writer", false, m_Parameters.InitialBufferSize,
+                           m_Parameters.GrowthFactor);
+    }
+    return new ChunkV("BP5Writer", false /* always copy */,
+                      m_Parameters.BufferChunkSize, m_ChunkPool.get());
+}
+
+} // end namespace engine
+} // end namespace core
+} // end namespace adios2
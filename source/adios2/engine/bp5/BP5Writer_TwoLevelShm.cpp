@@ -59,7 +59,8 @@ void BP5Writer::WriteData_TwoLevelShm(format::BufferV *Data)
 
     if (a->m_Comm.Size() > 1)
     {
-        a->CreateShm(static_cast<size_t>(maxSize), m_Parameters.MaxShmSize);
+        a->CreateShm(static_cast<size_t>(maxSize), m_Parameters.MaxShmSize,
+                     m_Parameters.NumShmSlots);
     }
 
     shm::TokenChain<uint64_t> tokenChain(&a->m_Comm);
@@ -196,7 +196,8 @@ void BP5Writer::WriteData_TwoLevelShm_Async(format::BufferV *Data)
 
     if (a->m_Comm.Size() > 1)
     {
-        a->CreateShm(static_cast<size_t>(maxSize), m_Parameters.MaxShmSize);
+        a->CreateShm(static_cast<size_t>(maxSize), m_Parameters.MaxShmSize,
+                     m_Parameters.NumShmSlots);
     }
 
     if (a->m_IsAggregator)
@@ -13,8 +13,10 @@
 
 #include "adios2/common/ADIOSTypes.h"
 #include "adios2/core/IO.h"
+#include <deque>
 #include <mpi.h>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace adios2
@@ -35,6 +37,23 @@ public:
         m_Capacity = capacity;
         m_Size = 0;
     }
+    Buffer(const Buffer &) = delete;
+    Buffer &operator=(const Buffer &) = delete;
+    Buffer(Buffer &&other) noexcept
+    : m_Capacity(other.m_Capacity), m_Size(other.m_Size),
+      m_Buffer(other.m_Buffer)
+    {
+        other.m_Capacity = 0;
+        other.m_Size = 0;
+        other.m_Buffer = nullptr;
+    }
+    Buffer &operator=(Buffer &&other) noexcept
+    {
+        std::swap(m_Capacity, other.m_Capacity);
+        std::swap(m_Size, other.m_Size);
+        std::swap(m_Buffer, other.m_Buffer);
+        return *this;
+    }
     ~Buffer()
     {
         if (m_Buffer)
@@ -130,6 +149,18 @@ using BlockVecVec = std::vector<BlockVec>;
 using RankPosMap = std::unordered_map<int, std::pair<size_t, size_t>>;
 using MpiInfo = std::vector<std::vector<int>>;
 
+// buffer of one step and the point to point requests sending or receiving it
+struct QueuedStep
+{
+    Buffer buffer;
+    std::vector<MPI_Request> requests;
+};
+using StepQueue = std::deque<QueuedStep>;
+
+// every writer buffer starts with a byte that is 1 in the final message, then
+// the writer step number, so that readers see the steps a writer discarded
+constexpr size_t BufferHeaderSize = 1 + sizeof(uint64_t);
+
 void PrintDims(const Dims &dims, const std::string &label = std::string());
 void PrintBlock(const BlockInfo &b, const std::string &label = std::string());
 void PrintBlockVec(const BlockVec &bv,
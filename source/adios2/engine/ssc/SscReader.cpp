@@ -30,6 +30,15 @@ SscReader::SscReader(IO &io, const std::string &name, const Mode mode,
     helper::GetParameter(m_IO.m_Parameters, "Threading", m_Threading);
     helper::GetParameter(m_IO.m_Parameters, "OpenTimeoutSecs",
                          m_OpenTimeoutSecs);
+    helper::GetParameter(m_IO.m_Parameters, "PersistentWindow",
+                         m_PersistentWindow);
+    helper::GetParameter(m_IO.m_Parameters, "QueueLimit", m_QueueLimit);
+    if (m_QueueLimit < 0)
+    {
+        helper::Log("Engine", "SSCReader", "Open",
+                    "QueueLimit must not be negative", -1, m_Comm.Rank(), 0,
+                    m_Verbosity, helper::LogMode::EXCEPTION);
+    }
 
     helper::Log("Engine", "SSCReader", "Open", m_Name, 0, m_Comm.Rank(), 5,
                 m_Verbosity, helper::LogMode::INFO);
@@ -41,9 +50,29 @@ SscReader::~SscReader() { PERFSTUBS_SCOPED_TIMER_FUNC(); }
 
 void SscReader::BeginStepConsequentFixed()
 {
-    MPI_Waitall(static_cast<int>(m_MpiRequests.size()), m_MpiRequests.data(),
-                MPI_STATUS_IGNORE);
-    m_MpiRequests.clear();
+    if (m_QueueLimit > 0)
+    {
+        auto &step = m_Queue.front();
+        MPI_Waitall(static_cast<int>(step.requests.size()),
+                    step.requests.data(), MPI_STATUSES_IGNORE);
+        std::swap(m_Buffer, step.buffer);
+        m_SpareBuffer = std::move(step.buffer);
+        m_Queue.pop_front();
+    }
+    else
+    {
+        MPI_Waitall(static_cast<int>(m_MpiRequests.size()),
+                    m_MpiRequests.data(), MPI_STATUS_IGNORE);
+        m_MpiRequests.clear();
+    }
+
+    // report the writer step, which skips the steps the writer discarded
+    if (m_Buffer[0] == 0)
+    {
+        uint64_t step;
+        std::memcpy(&step, m_Buffer.data(1), sizeof(step));
+        m_CurrentStep = static_cast<int64_t>(step);
+    }
 }
 
 void SscReader::BeginStepFlexible(StepStatus &status)
@@ -61,7 +90,37 @@ void SscReader::BeginStepFlexible(StepStatus &status)
         status = StepStatus::EndOfStream;
         return;
     }
-    MPI_Win_create(NULL, 0, 1, MPI_INFO_NULL, m_StreamComm, &m_MpiWin);
+    OpenWindow();
+}
+
+void SscReader::OpenWindow()
+{
+    if (m_PersistentWindow)
+    {
+        // writers attach their buffers to the dynamic window and publish
+        // the addresses
+        MPI_Aint address = 0;
+        m_WindowAddresses.resize(m_StreamSize);
+        MPI_Allgather(&address, 1, MPI_AINT, m_WindowAddresses.data(), 1,
+                      MPI_AINT, m_StreamComm);
+    }
+    else
+    {
+        MPI_Win_create(NULL, 0, 1, MPI_INFO_NULL, m_StreamComm, &m_MpiWin);
+    }
+}
+
+void SscReader::CloseWindow()
+{
+    if (m_PersistentWindow)
+    {
+        // tells the writers we are done getting from their buffers
+        MPI_Barrier(m_StreamComm);
+    }
+    else
+    {
+        MPI_Win_free(&m_MpiWin);
+    }
 }
 
 StepStatus SscReader::BeginStep(const StepMode stepMode,
@@ -190,10 +249,13 @@ void SscReader::PerformGets()
             m_Buffer.resize(totalDataSize);
             for (const auto &i : m_AllReceivingWriterRanks)
             {
+                const MPI_Aint disp =
+                    m_PersistentWindow ? m_WindowAddresses[i.first] : 0;
                 MPI_Win_lock(MPI_LOCK_SHARED, i.first, 0, m_MpiWin);
                 MPI_Get(m_Buffer.data() + i.second.first,
-                        static_cast<int>(i.second.second), MPI_CHAR, i.first, 0,
-                        static_cast<int>(i.second.second), MPI_CHAR, m_MpiWin);
+                        static_cast<int>(i.second.second), MPI_CHAR, i.first,
+                        disp, static_cast<int>(i.second.second), MPI_CHAR,
+                        m_MpiWin);
                 MPI_Win_unlock(i.first, m_MpiWin);
             }
         }
@@ -268,9 +330,14 @@ void SscReader::EndStepFixed()
 {
     if (m_CurrentStep == 0)
     {
-        MPI_Win_free(&m_MpiWin);
+        CloseWindow();
         SyncReadPattern();
     }
+    if (m_QueueLimit > 0)
+    {
+        PostQueuedReceives();
+        return;
+    }
     for (const auto &i : m_AllReceivingWriterRanks)
     {
         m_MpiRequests.emplace_back();
@@ -280,16 +347,52 @@ void SscReader::EndStepFixed()
     }
 }
 
+void SscReader::PostQueuedReceives()
+{
+    // receive the following steps into their own buffers while the
+    // application is still busy with the current one, so that the sends of
+    // the writers complete without waiting for this reader
+    while (m_Queue.size() < static_cast<size_t>(m_QueueLimit))
+    {
+        m_Queue.emplace_back();
+        auto &step = m_Queue.back();
+        step.buffer = std::move(m_SpareBuffer);
+        step.buffer.resize(m_Buffer.size());
+        for (const auto &i : m_AllReceivingWriterRanks)
+        {
+            step.requests.emplace_back();
+            MPI_Irecv(step.buffer.data() + i.second.first,
+                      static_cast<int>(i.second.second), MPI_CHAR, i.first, 0,
+                      m_StreamComm, &step.requests.back());
+        }
+    }
+}
+
+void SscReader::CancelQueuedReceives()
+{
+    // the writers have closed the stream, nothing matches these anymore
+    for (auto &step : m_Queue)
+    {
+        for (auto &request : step.requests)
+        {
+            MPI_Cancel(&request);
+        }
+        MPI_Waitall(static_cast<int>(step.requests.size()),
+                    step.requests.data(), MPI_STATUSES_IGNORE);
+    }
+    m_Queue.clear();
+}
+
 void SscReader::EndStepFirstFlexible()
 {
-    MPI_Win_free(&m_MpiWin);
+    CloseWindow();
     SyncReadPattern();
     BeginStepFlexible(m_StepStatus);
 }
 
 void SscReader::EndStepConsequentFlexible()
 {
-    MPI_Win_free(&m_MpiWin);
+    CloseWindow();
     BeginStepFlexible(m_StepStatus);
 }
 
@@ -316,7 +419,7 @@ void SscReader::EndStep()
             }
             else
             {
-                MPI_Win_free(&m_MpiWin);
+                CloseWindow();
                 SyncReadPattern();
             }
         }
@@ -329,7 +432,7 @@ void SscReader::EndStep()
             }
             else
             {
-                MPI_Win_free(&m_MpiWin);
+                CloseWindow();
             }
         }
     }
@@ -365,6 +468,16 @@ void SscReader::SyncMpiPattern()
     }
     MPI_Allreduce(&readerMasterStreamRank, &m_ReaderMasterStreamRank, 1,
                   MPI_INT, MPI_MAX, m_StreamComm);
+
+    // the window is used if either side asks for it
+    int persistentWindow = m_PersistentWindow ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &persistentWindow, 1, MPI_INT, MPI_MAX,
+                  m_StreamComm);
+    m_PersistentWindow = persistentWindow;
+    if (m_PersistentWindow)
+    {
+        MPI_Win_create_dynamic(MPI_INFO_NULL, m_StreamComm, &m_MpiWin);
+    }
 }
 
 bool SscReader::SyncWritePattern()
@@ -465,8 +578,9 @@ void SscReader::CalculatePosition(ssc::BlockVecVec &bvv,
                 b.bufferStart += bufferPosition;
             }
             size_t currentRankTotalSize = ssc::TotalDataSize(bv);
-            allRanks[rank].second = currentRankTotalSize + 1;
-            bufferPosition += currentRankTotalSize + 1;
+            allRanks[rank].second =
+                currentRankTotalSize + ssc::BufferHeaderSize;
+            bufferPosition += currentRankTotalSize + ssc::BufferHeaderSize;
         }
     }
 }
@@ -504,6 +618,13 @@ void SscReader::DoClose(const int transportIndex)
     {
         BeginStep();
     }
+
+    CancelQueuedReceives();
+
+    if (m_PersistentWindow)
+    {
+        MPI_Win_free(&m_MpiWin);
+    }
 }
 
 } // end namespace engine
@@ -49,10 +49,16 @@ private:
     ssc::RankPosMap m_AllReceivingWriterRanks;
     ssc::Buffer m_Buffer;
     MPI_Win m_MpiWin;
+    // buffer address of each stream rank in the dynamic window
+    std::vector<MPI_Aint> m_WindowAddresses;
     MPI_Group m_WriterGroup;
     MPI_Comm m_StreamComm;
     MPI_Comm m_ReaderComm;
     std::vector<MPI_Request> m_MpiRequests;
+    // steps being received ahead when QueueLimit is set, oldest first
+    ssc::StepQueue m_Queue;
+    // buffer of the last step taken from the queue, reused for the next one
+    ssc::Buffer m_SpareBuffer;
     StepStatus m_StepStatus;
     std::thread m_EndStepThread;
 
@@ -69,8 +75,12 @@ private:
     void BeginStepConsequentFixed();
     void BeginStepFlexible(StepStatus &status);
     void EndStepFixed();
+    void PostQueuedReceives();
+    void CancelQueuedReceives();
     void EndStepFirstFlexible();
     void EndStepConsequentFlexible();
+    void OpenWindow();
+    void CloseWindow();
 
 #define declare_type(T)                                                        \
     void DoGetSync(Variable<T> &, T *) final;                                  \
@@ -98,6 +108,8 @@ private:
     int m_Verbosity = 0;
     int m_OpenTimeoutSecs = 10;
     bool m_Threading = false;
+    bool m_PersistentWindow = false;
+    int m_QueueLimit = 0;
 };
 
 } // end namespace engine
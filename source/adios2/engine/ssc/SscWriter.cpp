@@ -28,6 +28,28 @@ SscWriter::SscWriter(IO &io, const std::string &name, const Mode mode,
     helper::GetParameter(m_IO.m_Parameters, "Threading", m_Threading);
     helper::GetParameter(m_IO.m_Parameters, "OpenTimeoutSecs",
                          m_OpenTimeoutSecs);
+    helper::GetParameter(m_IO.m_Parameters, "PersistentWindow",
+                         m_PersistentWindow);
+    helper::GetParameter(m_IO.m_Parameters, "QueueLimit", m_QueueLimit);
+    if (m_QueueLimit < 0)
+    {
+        helper::Log("Engine", "SSCWriter", "Open",
+                    "QueueLimit must not be negative", -1, m_Comm.Rank(), 0,
+                    m_Verbosity, helper::LogMode::EXCEPTION);
+    }
+    std::string queueFullPolicy = "block";
+    helper::GetParameter(m_IO.m_Parameters, "QueueFullPolicy",
+                         queueFullPolicy);
+    if (queueFullPolicy == "discard")
+    {
+        m_QueueDiscard = true;
+    }
+    else if (queueFullPolicy != "block")
+    {
+        helper::Log("Engine", "SSCWriter", "Open",
+                    "unknown QueueFullPolicy " + queueFullPolicy, -1,
+                    m_Comm.Rank(), 0, m_Verbosity, helper::LogMode::EXCEPTION);
+    }
 
     helper::Log("Engine", "SSCWriter", "Open", m_Name, 0, m_Comm.Rank(), 5,
                 m_Verbosity, helper::LogMode::INFO);
@@ -64,7 +86,7 @@ StepStatus SscWriter::BeginStep(StepMode mode, const float timeoutSeconds)
     if (m_CurrentStep == 0 || m_WriterDefinitionsLocked == false ||
         m_ReaderSelectionsLocked == false)
     {
-        m_Buffer.resize(1);
+        m_Buffer.resize(ssc::BufferHeaderSize);
         m_Buffer[0] = 0;
         m_GlobalWritePattern.clear();
         m_GlobalWritePattern.resize(m_StreamSize);
@@ -82,7 +104,7 @@ StepStatus SscWriter::BeginStep(StepMode mode, const float timeoutSeconds)
         }
         else
         {
-            MPI_Win_free(&m_MpiWin);
+            UnexposeBuffer();
         }
     }
 
@@ -103,15 +125,19 @@ void SscWriter::EndStepFirst()
     PERFSTUBS_SCOPED_TIMER_FUNC();
 
     SyncWritePattern();
-    MPI_Win_create(m_Buffer.data(), m_Buffer.size(), 1, MPI_INFO_NULL,
-                   m_StreamComm, &m_MpiWin);
-    MPI_Win_free(&m_MpiWin);
+    ExposeBuffer();
+    UnexposeBuffer();
     SyncReadPattern();
 }
 
 void SscWriter::EndStepConsequentFixed()
 {
     PERFSTUBS_SCOPED_TIMER_FUNC();
+    if (m_QueueLimit > 0)
+    {
+        EndStepQueued();
+        return;
+    }
     for (const auto &i : m_AllSendingReaderRanks)
     {
         m_MpiRequests.emplace_back();
@@ -120,12 +146,123 @@ void SscWriter::EndStepConsequentFixed()
     }
 }
 
+void SscWriter::EndStepQueued()
+{
+    PERFSTUBS_SCOPED_TIMER_FUNC();
+
+    if (m_QueueDiscard)
+    {
+        ReleaseSentSteps(m_Queue.size());
+        // all writers have to drop the same step, otherwise a reader would
+        // receive blocks of different steps
+        int queueFull = m_Queue.size() >= static_cast<size_t>(m_QueueLimit);
+        MPI_Allreduce(MPI_IN_PLACE, &queueFull, 1, MPI_INT, MPI_MAX,
+                      m_WriterComm);
+        if (queueFull)
+        {
+            helper::Log("Engine", "SSCWriter", "EndStep",
+                        "queue full, discarding step " +
+                            std::to_string(CurrentStep()),
+                        0, m_Comm.Rank(), 5, m_Verbosity,
+                        helper::LogMode::INFO);
+            return;
+        }
+    }
+    else
+    {
+        ReleaseSentSteps(static_cast<size_t>(m_QueueLimit) - 1);
+    }
+
+    // m_Buffer keeps collecting the puts of the next step, so the step is
+    // sent from a copy that stays in the queue until the sends complete
+    m_Queue.emplace_back();
+    auto &step = m_Queue.back();
+    step.buffer = std::move(m_SpareBuffer);
+    step.buffer.resize(m_Buffer.size());
+    std::memcpy(step.buffer.data(), m_Buffer.data(), m_Buffer.size());
+    for (const auto &i : m_AllSendingReaderRanks)
+    {
+        step.requests.emplace_back();
+        MPI_Isend(step.buffer.data(), static_cast<int>(step.buffer.size()),
+                  MPI_CHAR, i.first, 0, m_StreamComm, &step.requests.back());
+    }
+}
+
+void SscWriter::ReleaseSentSteps(const size_t maxQueued)
+{
+    PERFSTUBS_SCOPED_TIMER_FUNC();
+    while (!m_Queue.empty())
+    {
+        auto &requests = m_Queue.front().requests;
+        int completed = 1;
+        if (m_Queue.size() > maxQueued)
+        {
+            MPI_Waitall(static_cast<int>(requests.size()), requests.data(),
+                        MPI_STATUSES_IGNORE);
+        }
+        else
+        {
+            MPI_Testall(static_cast<int>(requests.size()), requests.data(),
+                        &completed, MPI_STATUSES_IGNORE);
+        }
+        if (!completed)
+        {
+            break;
+        }
+        m_SpareBuffer = std::move(m_Queue.front().buffer);
+        m_Queue.pop_front();
+    }
+}
+
 void SscWriter::EndStepConsequentFlexible()
 {
     PERFSTUBS_SCOPED_TIMER_FUNC();
     SyncWritePattern();
-    MPI_Win_create(m_Buffer.data(), m_Buffer.size(), 1, MPI_INFO_NULL,
-                   m_StreamComm, &m_MpiWin);
+    ExposeBuffer();
+}
+
+void SscWriter::ExposeBuffer()
+{
+    PERFSTUBS_SCOPED_TIMER_FUNC();
+    if (m_PersistentWindow)
+    {
+        // the window was created once in SyncMpiPattern, attach this step's
+        // buffer and let the readers know where it is
+        MPI_Win_attach(m_MpiWin, m_Buffer.data(), m_Buffer.size());
+        m_AttachedBuffer = m_Buffer.data();
+        MPI_Aint address;
+        MPI_Get_address(m_AttachedBuffer, &address);
+        std::vector<MPI_Aint> addresses(m_StreamSize);
+        MPI_Allgather(&address, 1, MPI_AINT, addresses.data(), 1, MPI_AINT,
+                      m_StreamComm);
+    }
+    else
+    {
+        MPI_Win_create(m_Buffer.data(), m_Buffer.size(), 1, MPI_INFO_NULL,
+                       m_StreamComm, &m_MpiWin);
+    }
+    m_BufferExposed = true;
+}
+
+void SscWriter::UnexposeBuffer()
+{
+    PERFSTUBS_SCOPED_TIMER_FUNC();
+    if (!m_BufferExposed)
+    {
+        return;
+    }
+    if (m_PersistentWindow)
+    {
+        // readers are done with the buffer once they reach the barrier
+        MPI_Barrier(m_StreamComm);
+        MPI_Win_detach(m_MpiWin, m_AttachedBuffer);
+        m_AttachedBuffer = nullptr;
+    }
+    else
+    {
+        MPI_Win_free(&m_MpiWin);
+    }
+    m_BufferExposed = false;
 }
 
 void SscWriter::EndStep()
@@ -135,6 +272,9 @@ void SscWriter::EndStep()
     helper::Log("Engine", "SSCWriter", "EndStep", std::to_string(CurrentStep()),
                 0, m_Comm.Rank(), 5, m_Verbosity, helper::LogMode::INFO);
 
+    const uint64_t step = static_cast<uint64_t>(m_CurrentStep);
+    std::memcpy(m_Buffer.data(1), &step, sizeof(step));
+
     if (m_CurrentStep == 0)
     {
         if (m_Threading)
@@ -203,6 +343,16 @@ void SscWriter::SyncMpiPattern()
     int readerMasterStreamRank = -1;
     MPI_Allreduce(&readerMasterStreamRank, &m_ReaderMasterStreamRank, 1,
                   MPI_INT, MPI_MAX, m_StreamComm);
+
+    // the window is used if either side asks for it
+    int persistentWindow = m_PersistentWindow ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &persistentWindow, 1, MPI_INT, MPI_MAX,
+                  m_StreamComm);
+    m_PersistentWindow = persistentWindow;
+    if (m_PersistentWindow)
+    {
+        MPI_Win_create_dynamic(MPI_INFO_NULL, m_StreamComm, &m_MpiWin);
+    }
 }
 
 void SscWriter::SyncWritePattern(bool finalStep)
@@ -302,7 +452,8 @@ void SscWriter::CalculatePosition(ssc::BlockVecVec &writerVecVec,
             {
                 currentReaderOverlapWriterRanks[rank].first = bufferPosition;
                 auto &bv = writerVecVec[rank];
-                size_t currentRankTotalSize = TotalDataSize(bv) + 1;
+                size_t currentRankTotalSize =
+                    TotalDataSize(bv) + ssc::BufferHeaderSize;
                 currentReaderOverlapWriterRanks[rank].second =
                     currentRankTotalSize;
                 bufferPosition += currentRankTotalSize;
@@ -349,6 +500,7 @@ void SscWriter::DoClose(const int transportIndex)
             MPI_Waitall(static_cast<int>(m_MpiRequests.size()),
                         m_MpiRequests.data(), MPI_STATUSES_IGNORE);
             m_MpiRequests.clear();
+            ReleaseSentSteps(0);
         }
 
         m_Buffer[0] = 1;
@@ -365,9 +517,14 @@ void SscWriter::DoClose(const int transportIndex)
     }
     else
     {
-        MPI_Win_free(&m_MpiWin);
+        UnexposeBuffer();
         SyncWritePattern(true);
     }
+
+    if (m_PersistentWindow)
+    {
+        MPI_Win_free(&m_MpiWin);
+    }
 }
 
 } // end namespace engine
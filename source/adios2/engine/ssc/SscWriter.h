@@ -48,10 +48,18 @@ private:
     ssc::RankPosMap m_AllSendingReaderRanks;
     ssc::Buffer m_Buffer;
     MPI_Win m_MpiWin;
+    // m_Buffer is accessible through m_MpiWin (created or attached)
+    bool m_BufferExposed = false;
+    // address of m_Buffer attached to the dynamic window
+    void *m_AttachedBuffer = nullptr;
     MPI_Group m_ReaderGroup;
     MPI_Comm m_StreamComm;
     MPI_Comm m_WriterComm;
     std::vector<MPI_Request> m_MpiRequests;
+    // steps still being sent when QueueLimit is set, oldest first
+    ssc::StepQueue m_Queue;
+    // buffer of the last step that left the queue, reused for the next one
+    ssc::Buffer m_SpareBuffer;
     std::thread m_EndStepThread;
 
     int m_StreamRank;
@@ -67,6 +75,10 @@ private:
     void EndStepFirst();
     void EndStepConsequentFixed();
     void EndStepConsequentFlexible();
+    void EndStepQueued();
+    void ReleaseSentSteps(const size_t maxQueued);
+    void ExposeBuffer();
+    void UnexposeBuffer();
 
 #define declare_type(T)                                                        \
     void DoPutSync(Variable<T> &, const T *) final;                            \
@@ -86,6 +98,9 @@ private:
     int m_Verbosity = 0;
     int m_OpenTimeoutSecs = 10;
     bool m_Threading = false;
+    bool m_PersistentWindow = false;
+    int m_QueueLimit = 0;
+    bool m_QueueDiscard = false;
 };
 
 } // end namespace engine
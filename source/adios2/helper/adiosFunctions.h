@@ -19,6 +19,7 @@
 #include "adios2/helper/adiosNetwork.h" //network and staging functions
 #include "adios2/helper/adiosString.h"  //std::string manipulation
 #include "adios2/helper/adiosSystem.h"  //OS functionality, POSIX, filesystem
+#include "adios2/helper/adiosThreads.h" //concurrent calls
 #include "adios2/helper/adiosType.h"    //Type casting, conversion, checks, etc.
 #include "adios2/helper/adiosXML.h"     //XML parsing
 #include "adios2/helper/adiosYAML.h"    //YAML parsing
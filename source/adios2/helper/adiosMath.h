@@ -96,6 +96,35 @@ template <class T>
 void GetMinMaxThreads(const std::complex<T> *values, const size_t size, T &min,
                       T &max, const unsigned int threads = 1) noexcept;
 
+/**
+ * Gets the min and max from a values array of primitive types (not including
+ * complex) and, if destination is not nullptr, copies values to destination
+ * in the same pass. Independent running min/max lanes let the compiler
+ * vectorize the loop for the target instruction set.
+ * @param values input array
+ * @param size of values array
+ * @param destination nullptr or array of size elements receiving a copy
+ * @param min of values
+ * @param max of values
+ */
+template <class T>
+void CopyGetMinMax(const T *values, const size_t size, T *destination, T &min,
+                   T &max) noexcept;
+
+/**
+ * Threaded version of CopyGetMinMax
+ * @param values input array
+ * @param size of values array
+ * @param destination nullptr or array of size elements receiving a copy
+ * @param min of values
+ * @param max of values
+ * @param threads used for parallel computation of large arrays
+ */
+template <class T>
+void CopyGetMinMaxThreads(const T *values, const size_t size, T *destination,
+                          T &min, T &max,
+                          const unsigned int threads = 1) noexcept;
+
 /**
  * Check if index is within (inclusive) limits
  * lowerLimit <= index <= upperLimit
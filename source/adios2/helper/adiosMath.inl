@@ -236,6 +236,120 @@ void GetMinMaxComplex(const std::complex<T> *values, const size_t size,
     }
 }
 
+template <class T, bool Copy>
+inline void MinMaxLanes(const T *values, const size_t size, T *destination,
+                        T &min, T &max) noexcept
+{
+    constexpr size_t lanes = 16;
+    T mins[lanes];
+    T maxs[lanes];
+    for (size_t l = 0; l < lanes; ++l)
+    {
+        mins[l] = values[0];
+        maxs[l] = values[0];
+    }
+
+    size_t i = 0;
+    for (; i + lanes <= size; i += lanes)
+    {
+        for (size_t l = 0; l < lanes; ++l)
+        {
+            const T value = values[i + l];
+            if (Copy)
+            {
+                destination[i + l] = value;
+            }
+            mins[l] = (value < mins[l]) ? value : mins[l];
+            maxs[l] = (maxs[l] < value) ? value : maxs[l];
+        }
+    }
+
+    T localMin = mins[0];
+    T localMax = maxs[0];
+    for (size_t l = 1; l < lanes; ++l)
+    {
+        localMin = (mins[l] < localMin) ? mins[l] : localMin;
+        localMax = (localMax < maxs[l]) ? maxs[l] : localMax;
+    }
+    for (; i < size; ++i)
+    {
+        const T value = values[i];
+        if (Copy)
+        {
+            destination[i] = value;
+        }
+        localMin = (value < localMin) ? value : localMin;
+        localMax = (localMax < value) ? value : localMax;
+    }
+    min = localMin;
+    max = localMax;
+}
+
+template <class T>
+void CopyGetMinMax(const T *values, const size_t size, T *destination, T &min,
+                   T &max) noexcept
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (destination)
+    {
+        MinMaxLanes<T, true>(values, size, destination, min, max);
+    }
+    else
+    {
+        MinMaxLanes<T, false>(values, size, destination, min, max);
+    }
+}
+
+template <class T>
+void CopyGetMinMaxThreads(const T *values, const size_t size, T *destination,
+                          T &min, T &max, const unsigned int threads) noexcept
+{
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (threads <= 1 || size < 1000000)
+    {
+        CopyGetMinMax(values, size, destination, min, max);
+        return;
+    }
+
+    const size_t stride = size / threads;    // elements per thread
+    const size_t remainder = size % threads; // remainder if not aligned
+    const size_t last = stride + remainder;
+
+    std::vector<T> mins(threads); // zero init
+    std::vector<T> maxs(threads); // zero init
+
+    std::vector<std::thread> copyGetMinMaxThreads;
+    copyGetMinMaxThreads.reserve(threads);
+
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        const size_t position = stride * t;
+        copyGetMinMaxThreads.push_back(std::thread(
+            CopyGetMinMax<T>, &values[position],
+            (t == threads - 1) ? last : stride,
+            destination ? &destination[position] : nullptr,
+            std::ref(mins[t]), std::ref(maxs[t])));
+    }
+
+    for (auto &copyGetMinMaxThread : copyGetMinMaxThreads)
+    {
+        copyGetMinMaxThread.join();
+    }
+
+    T maxTemp;
+    T minTemp;
+    CopyGetMinMax<T>(mins.data(), mins.size(), nullptr, min, maxTemp);
+    CopyGetMinMax<T>(maxs.data(), maxs.size(), nullptr, minTemp, max);
+}
+
 template <class T>
 void GetMinMaxThreads(const T *values, const size_t size, T &min, T &max,
                       const unsigned int threads) noexcept
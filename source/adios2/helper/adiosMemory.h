@@ -111,6 +111,11 @@ template <class T>
 T ReadValue(const std::vector<char> &buffer, size_t &position,
             const bool isLittleEndian = true) noexcept;
 
+/** ReadValue from a raw buffer, e.g. a segment not owned by a vector */
+template <class T>
+T ReadValue(const char *buffer, size_t &position,
+            const bool isLittleEndian = true) noexcept;
+
 /** Read in 'nElems' elements from buffer into output array
  * output must be pre-allocated.
  */
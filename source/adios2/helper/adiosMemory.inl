@@ -261,6 +261,29 @@ ReadValue<std::complex<double>>(const std::vector<char> &buffer,
     return value;
 }
 
+template <class T>
+inline T ReadValue(const char *buffer, size_t &position,
+                   const bool isLittleEndian) noexcept
+{
+    T value;
+
+#ifdef ADIOS2_HAVE_ENDIAN_REVERSE
+    if (IsLittleEndian() != isLittleEndian)
+    {
+        std::reverse_copy(buffer + position, buffer + position + sizeof(T),
+                          reinterpret_cast<char *>(&value));
+    }
+    else
+    {
+        std::memcpy(&value, buffer + position, sizeof(T));
+    }
+#else
+    std::memcpy(&value, buffer + position, sizeof(T));
+#endif
+    position += sizeof(T);
+    return value;
+}
+
 template <class T>
 inline void ReadArray(const std::vector<char> &buffer, size_t &position,
                       T *output, const size_t nElems,
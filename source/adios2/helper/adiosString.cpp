@@ -413,19 +413,19 @@ size_t StringToByteUnits(const std::string &input, const std::string &hint)
     std::string units;
     size_t unitsLength = 2;
 
-    if (EndsWith(input, "gb", true))
+    if (EndsWith(input, "gb", false))
     {
         units = "gb";
     }
-    else if (EndsWith(input, "mb", true))
+    else if (EndsWith(input, "mb", false))
     {
         units = "mb";
     }
-    else if (EndsWith(input, "kb", true))
+    else if (EndsWith(input, "kb", false))
     {
         units = "kb";
     }
-    else if (EndsWith(input, "b", true))
+    else if (EndsWith(input, "b", false))
     {
         units = "b";
         unitsLength = 1;
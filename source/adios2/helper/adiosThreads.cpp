@@ -0,0 +1,109 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * adiosThreads.cpp implementation of adiosThreads.h functions
+ */
+#include "adiosThreads.h"
+
+namespace adios2
+{
+namespace helper
+{
+
+WorkerThreads::~WorkerThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_WorkReady.notify_all();
+    for (auto &thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerThreads::Run(const size_t n,
+                        const std::function<void(const size_t)> &function)
+{
+    if (n == 0)
+    {
+        return;
+    }
+    if (n > 1)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        while (m_Threads.size() < n - 1)
+        {
+            m_Threads.emplace_back(&WorkerThreads::Worker, this);
+        }
+        m_Function = &function;
+        m_Next = 1;
+        m_Count = n;
+        m_Pending = n - 1;
+        m_Error = nullptr;
+    }
+    m_WorkReady.notify_all();
+
+    std::exception_ptr error;
+    try
+    {
+        function(0);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WorkDone.wait(lock, [&] { return m_Pending == 0; });
+    m_Function = nullptr;
+    if (!error)
+    {
+        error = m_Error;
+    }
+    m_Error = nullptr;
+    lock.unlock();
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+void WorkerThreads::Worker()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true)
+    {
+        m_WorkReady.wait(lock, [&] { return m_Stop || m_Next < m_Count; });
+        if (m_Stop)
+        {
+            return;
+        }
+        const size_t i = m_Next++;
+        const auto &function = *m_Function;
+        lock.unlock();
+        std::exception_ptr error;
+        try
+        {
+            function(i);
+        }
+        catch (...)
+        {
+            error = std::current_exception();
+        }
+        lock.lock();
+        if (error && !m_Error)
+        {
+            m_Error = error;
+        }
+        if (--m_Pending == 0)
+        {
+            m_WorkDone.notify_one();
+        }
+    }
+}
+
+} // end namespace helper
+} // end namespace adios2
@@ -0,0 +1,71 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * adiosThreads.h  running independent pieces of work on several threads
+ */
+
+#ifndef ADIOS2_HELPER_ADIOSTHREADS_H_
+#define ADIOS2_HELPER_ADIOSTHREADS_H_
+
+/// \cond EXCLUDE_FROM_DOXYGEN
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+/// \endcond
+
+namespace adios2
+{
+namespace helper
+{
+
+/**
+ * Worker threads kept across calls to Run, so that frequent small pieces of
+ * concurrent work (e.g. one write per file) do not start threads each time.
+ * Only one Run at a time.
+ */
+class WorkerThreads
+{
+public:
+    WorkerThreads() = default;
+    WorkerThreads(const WorkerThreads &) = delete;
+    WorkerThreads &operator=(const WorkerThreads &) = delete;
+    ~WorkerThreads();
+
+    /**
+     * Calls function(i) for every i in [0, n) at the same time, i = 0 on the
+     * calling thread and each of the others on a worker thread, starting
+     * workers if there are less than n - 1. Returns when all calls have
+     * returned.
+     * @param n number of calls
+     * @param function work of call i
+     * @throws the first exception thrown by any of the calls, after all of
+     * them have finished
+     */
+    void Run(const size_t n, const std::function<void(const size_t)> &function);
+
+private:
+    std::vector<std::thread> m_Threads;
+    std::mutex m_Mutex;
+    std::condition_variable m_WorkReady;
+    std::condition_variable m_WorkDone;
+    const std::function<void(const size_t)> *m_Function = nullptr;
+    /** next call of the current Run to hand out, and the number of calls */
+    size_t m_Next = 0;
+    size_t m_Count = 0;
+    /** calls handed to workers that have not returned yet */
+    size_t m_Pending = 0;
+    std::exception_ptr m_Error;
+    bool m_Stop = false;
+
+    void Worker();
+};
+
+} // end namespace helper
+} // end namespace adios2
+
+#endif /* ADIOS2_HELPER_ADIOSTHREADS_H_ */
@@ -152,6 +152,18 @@ std::shared_ptr<Operator> MakeOperator(const std::string &type,
     return ret;
 }
 
+bool OperatorIsThreadSafe(const std::string &type)
+{
+    const std::string typeLowerCase = helper::LowerCase(type);
+    return typeLowerCase != "blosc" && typeLowerCase != "libpressio" &&
+           typeLowerCase != "sirius" && typeLowerCase != "sz";
+}
+
+bool OperatorIsThreadSafe(const Operator::OperatorType type)
+{
+    return OperatorIsThreadSafe(OperatorTypeToString(type));
+}
+
 size_t Decompress(const char *bufferIn, const size_t sizeIn, char *dataOut,
                   std::shared_ptr<Operator> op)
 {
@@ -20,6 +20,12 @@ namespace core
 std::shared_ptr<Operator> MakeOperator(const std::string &type,
                                        const Params &parameters);
 
+/** false for the operators whose libraries keep process-wide state (init and
+ * finalize calls, global settings), which must not run on several threads at
+ * the same time */
+bool OperatorIsThreadSafe(const std::string &type);
+bool OperatorIsThreadSafe(const Operator::OperatorType type);
+
 size_t Decompress(const char *bufferIn, const size_t sizeIn, char *dataOut,
                   std::shared_ptr<Operator> op = nullptr);
 
@@ -11,13 +11,64 @@
 
 #include "adios2/helper/adiosMemory.h" // PaddingToAlignOffset
 
+#include <algorithm> // std::min, std::max
+#include <climits>   // INT_MAX
 #include <iostream>
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
 namespace adios2
 {
 namespace aggregator
 {
 
+namespace
+{
+
+/* Block while word == value. The other party is usually just finishing a
+ * memcpy so spin for a short while first, then sleep in the kernel until
+ * woken up by WakeAll() on the same word. */
+void WaitWhileEqual(std::atomic<uint32_t> &word, const uint32_t value)
+{
+    for (int i = 0; i < 64; ++i)
+    {
+        if (word.load(std::memory_order_acquire) != value)
+        {
+            return;
+        }
+        std::this_thread::yield();
+    }
+    while (word.load(std::memory_order_acquire) == value)
+    {
+#ifdef __linux__
+        // Not FUTEX_PRIVATE_FLAG, the word is shared between processes.
+        // The timeout only guards against a missed wakeup.
+        struct timespec timeout = {0, 1000000};
+        syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT,
+                value, &timeout, nullptr, 0);
+#else
+        std::this_thread::sleep_for(std::chrono::duration<double>(0.00001));
+#endif
+    }
+}
+
+void WakeAll(std::atomic<uint32_t> &word)
+{
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE,
+            INT_MAX, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // end anonymous namespace
+
 MPIShmChain::MPIShmChain() : MPIAggregator() {}
 
 MPIShmChain::~MPIShmChain() { Close(); }
@@ -214,13 +265,15 @@ void MPIShmChain::HandshakeLinks_Complete(HandshakeStruct &hs)
                         "aggregator, at Open");
 }
 
-void MPIShmChain::CreateShm(size_t blocksize, const size_t maxsegmentsize)
+void MPIShmChain::CreateShm(size_t blocksize, const size_t maxsegmentsize,
+                            unsigned int nslots)
 {
     if (!m_Comm.IsMPI())
     {
         throw std::runtime_error("Coding Error: MPIShmChain::CreateShm was "
                                  "called with a non-MPI communicator");
     }
+    nslots = std::max(1u, std::min(nslots, MaxShmSlots));
     char *ptr;
     size_t structsize = sizeof(ShmSegment);
     structsize += helper::PaddingToAlignOffset(structsize, sizeof(max_align_t));
@@ -228,17 +281,18 @@ void MPIShmChain::CreateShm(size_t blocksize, const size_t maxsegmentsize)
     {
         blocksize +=
             helper::PaddingToAlignOffset(blocksize, sizeof(max_align_t));
-        size_t totalsize = structsize + 2 * blocksize;
+        size_t totalsize = structsize + nslots * blocksize;
         if (totalsize > maxsegmentsize)
         {
             // roll back and calculate sizes from maxsegmentsize
             totalsize = maxsegmentsize - sizeof(max_align_t) + 1;
             totalsize +=
                 helper::PaddingToAlignOffset(totalsize, sizeof(max_align_t));
-            blocksize = (totalsize - structsize) / 2 - sizeof(max_align_t) + 1;
+            blocksize =
+                (totalsize - structsize) / nslots - sizeof(max_align_t) + 1;
             blocksize +=
                 helper::PaddingToAlignOffset(blocksize, sizeof(max_align_t));
-            totalsize = structsize + 2 * blocksize;
+            totalsize = structsize + nslots * blocksize;
         }
         m_Win = m_Comm.Win_allocate_shared(totalsize, 1, &ptr);
     }
@@ -248,25 +302,25 @@ void MPIShmChain::CreateShm(size_t blocksize, const size_t maxsegmentsize)
         size_t shmsize;
         int disp_unit;
         m_Comm.Win_shared_query(m_Win, 0, &shmsize, &disp_unit, &ptr);
-        blocksize = (shmsize - structsize) / 2;
+        blocksize = (shmsize - structsize) / nslots;
     }
     m_Shm = reinterpret_cast<ShmSegment *>(ptr);
-    m_ShmBufA = ptr + structsize;
-    m_ShmBufB = m_ShmBufA + blocksize;
+    m_ShmBuf = ptr + structsize;
+    m_ShmBlockSize = blocksize;
 
     if (!m_Rank)
     {
-        m_Shm->producerBuffer = LastBufferUsed::None;
-        m_Shm->consumerBuffer = LastBufferUsed::None;
-        m_Shm->NumBuffersFull = 0;
-        m_Shm->sdbA.buf = nullptr;
-        m_Shm->sdbA.max_size = blocksize;
-        m_Shm->sdbB.buf = nullptr;
-        m_Shm->sdbB.max_size = blocksize;
+        m_Shm->NumSlots = nslots;
+        m_Shm->NumProduced.store(0, std::memory_order_relaxed);
+        m_Shm->NumConsumed.store(0, std::memory_order_relaxed);
+        for (unsigned int i = 0; i < nslots; ++i)
+        {
+            m_Shm->sdb[i].buf = nullptr;
+            m_Shm->sdb[i].max_size = blocksize;
+            m_Shm->sdb[i].actual_size = 0;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
     }
-    /*std::cout << "Rank " << m_Rank << " shm = " << ptr
-              << " bufA = " << static_cast<void *>(m_Shm->bufA)
-              << " bufB = " << static_cast<void *>(m_Shm->bufB) << std::endl;*/
 }
 
 void MPIShmChain::DestroyShm() { m_Comm.Win_free(m_Win); }
@@ -275,30 +329,31 @@ void MPIShmChain::DestroyShm() { m_Comm.Win_free(m_Win); }
    The buffering strategy is the following.
    Assumptions: 1. Only one Producer (and one Consumer) is active at a time.
 
-   The first Producer fills buffer A first then B and then is always
-   alternating, blocking when Consumer is behind (NumBuffersFull == 2).
-   The next Producer will continue with the alternating pattern where the
-   previous Producer has finished.
-
-   The Consumer is blocked until there is at least one buffer available.
-   It takes buffer A at the first call, then it alternates between the two
-   buffers.
-
-   C++ atomic locks in Shm for IPC locking:
-   - lockSegment is used to modify the m_Shm variables exclusively (short time),
-   - lockA and lockB are used to give long term exclusive access to one buffer
-   to be filled or consumed.
-
-   The sleeping phases, to wait on the other party to catch up, are outside of
-   the locking code areas.
-
-   Note: the m_Shm->sdbX.buf pointers must be set on the local process every
+   The shared memory segment holds a ring of NumSlots data buffers.
+   NumProduced and NumConsumed count the buffers handed over in each direction
+   and only ever increase, so buffer number n lives in slot n % NumSlots.
+   The Producer fills slots in order, blocking only when all slots are full
+   (NumProduced - NumConsumed == NumSlots), so it can run ahead of the Consumer
+   by up to NumSlots buffers. The next Producer will continue where the
+   previous Producer has finished, since the counters are in shared memory.
+
+   The Consumer is blocked until there is at least one filled slot
+   (NumProduced > NumConsumed) and drains them in the same order.
+
+   Each counter is written by one side only, so handing over a slot is a
+   single atomic increment (release) that the other side reads (acquire).
+   The waiting side spins briefly and then sleeps on the counter with a futex
+   (Linux), which the other side wakes up after incrementing it.
+   The counters are reset in CreateShm() at every step so they do not wrap
+   around in practice.
+
+   Note: the m_Shm->sdb[i].buf pointers must be set on the local process every
    time, even tough it is stored on the shared memory segment, because the
    address of the segment is different on every process. Failing to set on the
    local process causes this pointer pointing to an invalid address (set on
    another process).
 
-   Note: the sdbA and sdbB structs are stored on the shared memory segment
+   Note: the sdb structs are stored on the shared memory segment
    because they contain 'actual_size' which is set on the Producer and used by
    the Consumer.
 
@@ -306,120 +361,54 @@ void MPIShmChain::DestroyShm() { m_Comm.Win_free(m_Win); }
 
 MPIShmChain::ShmDataBuffer *MPIShmChain::LockProducerBuffer()
 {
-    MPIShmChain::ShmDataBuffer *sdb = nullptr;
+    const uint32_t produced =
+        m_Shm->NumProduced.load(std::memory_order_acquire);
 
-    // Sleep until there is a buffer available at all
-    while (m_Shm->NumBuffersFull == 2)
+    // Sleep until there is a free slot
+    uint32_t consumed = m_Shm->NumConsumed.load(std::memory_order_acquire);
+    while (produced - consumed >= m_Shm->NumSlots)
     {
-        std::this_thread::sleep_for(std::chrono::duration<double>(0.00001));
-    }
-
-    m_Shm->lockSegment.lock();
-    if (m_Shm->producerBuffer == LastBufferUsed::A)
-
-    {
-        m_Shm->producerBuffer = LastBufferUsed::B;
-        sdb = &m_Shm->sdbB;
-        // point to shm data buffer (in local process memory)
-        sdb->buf = m_ShmBufB;
-    }
-    else // None or B
-    {
-        m_Shm->producerBuffer = LastBufferUsed::A;
-        sdb = &m_Shm->sdbA;
-        // point to shm data buffer (in local process memory)
-        sdb->buf = m_ShmBufA;
-    }
-    m_Shm->lockSegment.unlock();
-
-    // We determined we want a specific buffer
-    // Now we need to get a lock on it in case consumer is using it
-    if (m_Shm->producerBuffer == LastBufferUsed::A)
-    {
-        m_Shm->lockA.lock();
-    }
-    else
-    {
-        m_Shm->lockB.lock();
+        WaitWhileEqual(m_Shm->NumConsumed, consumed);
+        consumed = m_Shm->NumConsumed.load(std::memory_order_acquire);
     }
 
+    const unsigned int slot = produced % m_Shm->NumSlots;
+    MPIShmChain::ShmDataBuffer *sdb = &m_Shm->sdb[slot];
+    // point to shm data buffer (in local process memory)
+    sdb->buf = m_ShmBuf + slot * m_ShmBlockSize;
     return sdb;
 }
 
 void MPIShmChain::UnlockProducerBuffer()
 {
-    m_Shm->lockSegment.lock();
-    ++m_Shm->NumBuffersFull;
-    m_Shm->lockSegment.unlock();
-
-    if (m_Shm->producerBuffer == LastBufferUsed::A)
-    {
-        m_Shm->lockA.unlock();
-    }
-    else
-    {
-        m_Shm->lockB.unlock();
-    }
+    m_Shm->NumProduced.fetch_add(1, std::memory_order_release);
+    WakeAll(m_Shm->NumProduced);
 }
 
 MPIShmChain::ShmDataBuffer *MPIShmChain::LockConsumerBuffer()
 {
-    MPIShmChain::ShmDataBuffer *sdb = nullptr;
+    const uint32_t consumed =
+        m_Shm->NumConsumed.load(std::memory_order_acquire);
 
     // Sleep until there is at least one buffer filled
-    while (m_Shm->NumBuffersFull < 1)
-    {
-        std::this_thread::sleep_for(std::chrono::duration<double>(0.00001));
-    }
-    // At this point we know buffer A has content or going to have content
-    // when we successfully lock it
-
-    m_Shm->lockSegment.lock();
-    if (m_Shm->consumerBuffer == LastBufferUsed::A)
-
-    {
-        m_Shm->consumerBuffer = LastBufferUsed::B;
-        sdb = &m_Shm->sdbB;
-        // point to shm data buffer (in local process memory)
-        sdb->buf = m_ShmBufB;
-    }
-    else // None or B
+    uint32_t produced = m_Shm->NumProduced.load(std::memory_order_acquire);
+    while (produced == consumed)
     {
-        m_Shm->consumerBuffer = LastBufferUsed::A;
-        sdb = &m_Shm->sdbA;
-        // point to shm data buffer (in local process memory)
-        sdb->buf = m_ShmBufA;
-    }
-    m_Shm->lockSegment.unlock();
-
-    // We determined we want a specific buffer
-    // Now we need to get a lock on it in case producer is using it
-    if (m_Shm->consumerBuffer == LastBufferUsed::A)
-    {
-        m_Shm->lockA.lock();
-    }
-    else
-    {
-        m_Shm->lockB.lock();
+        WaitWhileEqual(m_Shm->NumProduced, produced);
+        produced = m_Shm->NumProduced.load(std::memory_order_acquire);
     }
 
+    const unsigned int slot = consumed % m_Shm->NumSlots;
+    MPIShmChain::ShmDataBuffer *sdb = &m_Shm->sdb[slot];
+    // point to shm data buffer (in local process memory)
+    sdb->buf = m_ShmBuf + slot * m_ShmBlockSize;
     return sdb;
 }
 
 void MPIShmChain::UnlockConsumerBuffer()
 {
-    m_Shm->lockSegment.lock();
-    --m_Shm->NumBuffersFull;
-    m_Shm->lockSegment.unlock();
-
-    if (m_Shm->consumerBuffer == LastBufferUsed::A)
-    {
-        m_Shm->lockA.unlock();
-    }
-    else
-    {
-        m_Shm->lockB.unlock();
-    }
+    m_Shm->NumConsumed.fetch_add(1, std::memory_order_release);
+    WakeAll(m_Shm->NumConsumed);
 }
 
 } // end namespace aggregator
@@ -14,10 +14,10 @@
 
 #include "adios2/common/ADIOSConfig.h"
 #include "adios2/toolkit/aggregator/mpi/MPIAggregator.h"
-#include "adios2/toolkit/shm/Spinlock.h"
 
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <thread>
 
 namespace adios2
@@ -25,8 +25,8 @@ namespace adios2
 namespace aggregator
 {
 
-// constexpr size_t SHM_BUF_SIZE = 4194304; // 4MB
-// we allocate 2x this size + a bit for shared memory segment
+// upper limit on the number of data buffers (slots) in the shared memory ring
+constexpr unsigned int MaxShmSlots = 64;
 
 /** A one- or two-layer aggregator chain for using Shared memory within a
  * compute node.
@@ -109,8 +109,9 @@ public:
     void UnlockConsumerBuffer();
     void ResetBuffers() noexcept;
 
-    // 2*blocksize+some is allocated but only up to maxsegmentsize
-    void CreateShm(size_t blocksize, const size_t maxsegmentsize);
+    // nslots*blocksize+some is allocated but only up to maxsegmentsize
+    void CreateShm(size_t blocksize, const size_t maxsegmentsize,
+                   unsigned int nslots = 2);
     void DestroyShm();
 
 private:
@@ -127,32 +128,22 @@ private:
 
     helper::Comm::Win m_Win;
 
-    enum class LastBufferUsed
-    {
-        None,
-        A,
-        B
-    };
-
     struct ShmSegment
     {
-        LastBufferUsed producerBuffer;
-        LastBufferUsed consumerBuffer;
-        unsigned int NumBuffersFull;
-        // user facing structs
-        ShmDataBuffer sdbA;
-        ShmDataBuffer sdbB;
-        shm::Spinlock lockSegment;
-        // locks for individual buffers (sdb and buf)
-        shm::Spinlock lockA;
-        shm::Spinlock lockB;
-        // the actual data buffers
-        // char bufA[SHM_BUF_SIZE];
-        // char bufB[SHM_BUF_SIZE];
+        unsigned int NumSlots;
+        // Number of buffers filled / released so far, ever increasing.
+        // The next slot to produce/consume is counter % NumSlots.
+        // 32bit words so that a waiting process can sleep on them (futex)
+        std::atomic<uint32_t> NumProduced;
+        std::atomic<uint32_t> NumConsumed;
+        // user facing structs, one per slot
+        ShmDataBuffer sdb[MaxShmSlots];
+        // the actual data buffers follow the struct in the segment
     };
     ShmSegment *m_Shm;
-    char *m_ShmBufA;
-    char *m_ShmBufB;
+    // first data buffer in local process memory
+    char *m_ShmBuf;
+    size_t m_ShmBlockSize;
 };
 
 } // end namespace aggregator
@@ -41,6 +41,13 @@ FileDrainOperation::FileDrainOperation(DrainOperation op,
 
 void FileDrainer::AddOperation(FileDrainOperation &operation)
 {
+    if (operation.op == DrainOperation::CopyAt ||
+        operation.op == DrainOperation::Copy ||
+        operation.op == DrainOperation::WriteAt ||
+        operation.op == DrainOperation::Write)
+    {
+        m_BytesQueued += operation.countBytes;
+    }
     std::lock_guard<std::mutex> lockGuard(operationsMutex);
     operations.push(operation);
 }
@@ -53,8 +60,7 @@ void FileDrainer::AddOperation(DrainOperation op,
 {
     FileDrainOperation operation(op, fromFileName, toFileName, countBytes,
                                  fromOffset, toOffset, data);
-    std::lock_guard<std::mutex> lockGuard(operationsMutex);
-    operations.push(operation);
+    AddOperation(operation);
 }
 
 void FileDrainer::AddOperationSeekEnd(const std::string &toFileName)
@@ -286,5 +292,23 @@ void FileDrainer::SetVerbose(int verboseLevel, int rank)
     m_Rank = rank;
 }
 
+size_t FileDrainer::GetBytesQueued() const noexcept { return m_BytesQueued; }
+
+size_t FileDrainer::GetBytesDrained() const noexcept { return m_BytesDrained; }
+
+std::string FileDrainer::GetProfilingJSON() const
+{
+    const size_t drained = m_BytesDrained;
+    const core::Seconds elapsed = core::Now() - m_StartTime;
+    const double mbps =
+        (elapsed.count() > 0.0)
+            ? static_cast<double>(drained) / elapsed.count() / 1048576.0
+            : 0.0;
+    return "\"drain\": { \"queued_bytes\": " + std::to_string(m_BytesQueued) +
+           ", \"drained_bytes\": " + std::to_string(drained) +
+           ", \"elapsed_s\": " + std::to_string(elapsed.count()) +
+           ", \"MBps\": " + std::to_string(mbps) + " }";
+}
+
 } // end namespace burstbuffer
 } // end namespace adios2
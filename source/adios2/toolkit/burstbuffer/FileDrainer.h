@@ -11,6 +11,7 @@
 #ifndef ADIOS2_TOOLKIT_BURSTBUFFER_FILEDRAINER_H_
 #define ADIOS2_TOOLKIT_BURSTBUFFER_FILEDRAINER_H_
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <locale>
@@ -22,6 +23,7 @@
 #include <string>
 
 #include "adios2/common/ADIOSTypes.h"
+#include "adios2/core/CoreTypes.h"
 
 namespace adios2
 {
@@ -103,6 +105,17 @@ public:
      * processes */
     void SetVerbose(int verboseLevel, int rank);
 
+    /** Bytes passed to copy and write operations so far. Safe to call while
+     * the drain thread(s) are running */
+    size_t GetBytesQueued() const noexcept;
+
+    /** Bytes already written to the target files */
+    size_t GetBytesDrained() const noexcept;
+
+    /** "drain" entry of the engine's profiling.json with the progress and
+     * throughput counters at the time of the call */
+    std::string GetProfilingJSON() const;
+
 protected:
     std::queue<FileDrainOperation> operations;
     std::mutex operationsMutex;
@@ -112,6 +125,11 @@ protected:
     int m_Verbose = 0;
     static const int errorState = -1;
 
+    std::atomic<size_t> m_BytesQueued{0};
+    std::atomic<size_t> m_BytesDrained{0};
+    /** set by Start(), throughput is measured from here */
+    core::TimePoint m_StartTime = core::Now();
+
     /** instead for Open, use this function */
     InputFile GetFileForRead(const std::string &path);
     OutputFile GetFileForWrite(const std::string &path, bool append = false);
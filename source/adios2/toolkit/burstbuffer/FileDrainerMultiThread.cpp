@@ -0,0 +1,571 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileDrainerMultiThread.cpp
+ */
+
+#include "FileDrainerMultiThread.h"
+
+#include <algorithm> // std::min, std::max
+#include <cerrno>
+#include <chrono>
+#include <cstdio>  // std::remove
+#include <cstring> // std::strerror
+#include <iostream>
+#include <stdexcept>
+
+#include <fcntl.h>    // open
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // pread, pwrite, close, copy_file_range
+
+/// \cond EXCLUDE_FROM_DOXYGEN
+#include <ios> //std::ios_base::failure
+/// \endcond
+
+#if defined(__linux__) && defined(__GLIBC__) &&                               \
+    ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define ADIOS2_DRAIN_COPY_FILE_RANGE
+#endif
+
+namespace adios2
+{
+namespace burstbuffer
+{
+
+namespace
+{
+const char *OperationName(const DrainOperation op)
+{
+    switch (op)
+    {
+    case DrainOperation::SeekEnd:
+        return "SeekEnd";
+    case DrainOperation::CopyAt:
+        return "CopyAt";
+    case DrainOperation::Copy:
+        return "Copy";
+    case DrainOperation::WriteAt:
+        return "WriteAt";
+    case DrainOperation::Write:
+        return "Write";
+    case DrainOperation::Create:
+        return "Create";
+    case DrainOperation::Open:
+        return "Open";
+    case DrainOperation::Delete:
+        return "Delete";
+    }
+    return "Unknown";
+}
+} // end anonymous namespace
+
+FileDrainerMultiThread::FileDrainerMultiThread(const unsigned int nThreads,
+                                               const size_t bandwidth)
+: FileDrainer(), m_Threads(std::max(nThreads, 1u)), m_Bandwidth(bandwidth)
+{
+}
+
+FileDrainerMultiThread::~FileDrainerMultiThread() { Join(); }
+
+void FileDrainerMultiThread::SetChunkSize(size_t chunkSizeBytes)
+{
+    m_ChunkSize = std::max(chunkSizeBytes, static_cast<size_t>(1));
+}
+
+void FileDrainerMultiThread::Start()
+{
+    m_StartTime = core::Now();
+    m_NextSlot = m_StartTime;
+    m_Workers.reserve(m_Threads);
+    for (unsigned int t = 0; t < m_Threads; ++t)
+    {
+        m_Workers.emplace_back(&FileDrainerMultiThread::WorkerThread, this);
+    }
+    m_Dispatcher = std::thread(&FileDrainerMultiThread::DispatchThread, this);
+}
+
+void FileDrainerMultiThread::Finish()
+{
+    std::lock_guard<std::mutex> lockGuard(m_FinishMutex);
+    m_Finish = true;
+}
+
+void FileDrainerMultiThread::Join()
+{
+    if (m_Dispatcher.joinable())
+    {
+        const auto tTotalStart = core::Now();
+
+        Finish();
+        m_Dispatcher.join();
+
+        const core::Seconds timeTotal = core::Now() - tTotalStart;
+        if (m_Verbose)
+        {
+            std::cout << "Drain " << m_Rank
+                      << ": Waited for threads to join = " << timeTotal.count()
+                      << " seconds" << std::endl;
+        }
+    }
+}
+
+/*
+ * Dispatcher thread, running separately from all other member function calls.
+ * It is the only thread touching m_OutputFds and m_InputFds.
+ */
+void FileDrainerMultiThread::DispatchThread()
+{
+    std::chrono::duration<double> d(0.010);
+    size_t maxQueueSize = 0;
+
+    while (true)
+    {
+        operationsMutex.lock();
+        if (operations.empty())
+        {
+            operationsMutex.unlock();
+            bool done;
+            {
+                std::lock_guard<std::mutex> lockGuard(m_FinishMutex);
+                done = m_Finish;
+            }
+            if (done)
+            {
+                break;
+            }
+            std::this_thread::sleep_for(d);
+            continue;
+        }
+
+        FileDrainOperation fdo = std::move(operations.front());
+        operations.pop();
+        maxQueueSize = std::max(maxQueueSize, operations.size() + 1);
+        operationsMutex.unlock();
+
+        if (m_Verbose >= 2)
+        {
+            std::cout << "Drain " << m_Rank << ": " << OperationName(fdo.op)
+                      << " " << fdo.fromFileName << " -> " << fdo.toFileName
+                      << " " << fdo.countBytes << " bytes" << std::endl;
+        }
+
+        switch (fdo.op)
+        {
+        case DrainOperation::CopyAt:
+        case DrainOperation::Copy:
+        {
+            InputFd &in = GetInput(fdo.fromFileName);
+            OutputFd &out =
+                GetOutput(fdo.toFileName, fdo.op == DrainOperation::Copy);
+            if (in.fd < 0 || out.fd < 0)
+            {
+                break; // skip because of previous error
+            }
+            const bool at = (fdo.op == DrainOperation::CopyAt);
+            const size_t fromOffset = at ? fdo.fromOffset : in.position;
+            const size_t toOffset = at ? fdo.toOffset : out.position;
+            SubmitCopy(in.fd, out.fd, fromOffset, toOffset, fdo.countBytes,
+                       fdo.toFileName);
+            in.position = fromOffset + fdo.countBytes;
+            out.position = toOffset + fdo.countBytes;
+            out.size = std::max(out.size, out.position);
+            break;
+        }
+        case DrainOperation::SeekEnd:
+        {
+            OutputFd &out = GetOutput(fdo.toFileName, false);
+            out.position = out.size;
+            break;
+        }
+        case DrainOperation::WriteAt:
+        case DrainOperation::Write:
+        {
+            OutputFd &out = GetOutput(fdo.toFileName, false);
+            if (out.fd < 0)
+            {
+                break;
+            }
+            if (fdo.op == DrainOperation::WriteAt)
+            {
+                out.position = fdo.toOffset;
+            }
+            Task task;
+            task.fromFd = -1;
+            task.toFd = out.fd;
+            task.fromOffset = 0;
+            task.toOffset = out.position;
+            task.count = fdo.countBytes;
+            task.data = std::move(fdo.dataToWrite);
+            task.toPath = &m_OutputFds.find(fdo.toFileName)->first;
+            Submit(std::move(task));
+            out.position += fdo.countBytes;
+            out.size = std::max(out.size, out.position);
+            break;
+        }
+        case DrainOperation::Create:
+        {
+            GetOutput(fdo.toFileName, false);
+            break;
+        }
+        case DrainOperation::Open:
+        {
+            GetOutput(fdo.toFileName, true);
+            break;
+        }
+        case DrainOperation::Delete:
+        {
+            // tasks may still read or write this file
+            WaitForTasks();
+            auto itOut = m_OutputFds.find(fdo.toFileName);
+            if (itOut != m_OutputFds.end())
+            {
+                if (itOut->second.fd >= 0)
+                {
+                    close(itOut->second.fd);
+                }
+                m_OutputFds.erase(itOut);
+            }
+            auto itIn = m_InputFds.find(fdo.toFileName);
+            if (itIn != m_InputFds.end())
+            {
+                if (itIn->second.fd >= 0)
+                {
+                    close(itIn->second.fd);
+                }
+                m_InputFds.erase(itIn);
+            }
+            std::remove(fdo.toFileName.c_str());
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    WaitForTasks();
+    {
+        std::lock_guard<std::mutex> lockGuard(m_TasksMutex);
+        m_WorkersDone = true;
+    }
+    m_TasksCV.notify_all();
+    for (auto &worker : m_Workers)
+    {
+        worker.join();
+    }
+    CloseAllFds();
+
+    const core::Seconds timeTotal = core::Now() - m_StartTime;
+    const size_t drained = m_BytesDrained;
+    const bool shouldReport = (m_Verbose || (drained != m_BytesQueued));
+    if (shouldReport)
+    {
+        std::cout << "Drain " << m_Rank
+                  << ": Runtime  total = " << timeTotal.count()
+                  << " seconds with " << m_Threads << " threads"
+                  << ". Max queue size = " << maxQueueSize << ".";
+        if (drained == m_BytesQueued)
+        {
+            std::cout << " Wrote " << drained << " bytes";
+        }
+        else
+        {
+            std::cout << " WARNING Write wanted = " << m_BytesQueued
+                      << " but successfully wrote = " << drained << " bytes.";
+        }
+        if (timeTotal.count() > 0.0)
+        {
+            std::cout << ", " << drained / timeTotal.count() / 1048576.0
+                      << " MB/s";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void FileDrainerMultiThread::WorkerThread()
+{
+    // staging buffer for the pread/pwrite fallback, allocated on first use
+    std::vector<char> buffer;
+
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(m_TasksMutex);
+        m_TasksCV.wait(lock,
+                       [&]() { return !m_Tasks.empty() || m_WorkersDone; });
+        if (m_Tasks.empty())
+        {
+            break;
+        }
+        Task task = std::move(m_Tasks.front());
+        m_Tasks.pop_front();
+        lock.unlock();
+        m_TasksCV.notify_all(); // room in the queue
+
+        size_t n = 0;
+        try
+        {
+            Throttle(task.count);
+            n = Execute(task, buffer);
+        }
+        catch (std::exception &e)
+        {
+            std::cerr << "ADIOS THREAD ERROR: " << e.what() << std::endl;
+        }
+        m_BytesDrained += n;
+
+        lock.lock();
+        auto range = m_InFlight.equal_range(task.toFd);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second.first == task.toOffset &&
+                it->second.second == task.toOffset + task.count)
+            {
+                m_InFlight.erase(it);
+                break;
+            }
+        }
+        lock.unlock();
+        m_TasksCV.notify_all();
+    }
+}
+
+FileDrainerMultiThread::OutputFd &
+FileDrainerMultiThread::GetOutput(const std::string &path, const bool append)
+{
+    auto it = m_OutputFds.find(path);
+    if (it != m_OutputFds.end())
+    {
+        return it->second;
+    }
+
+    OutputFd &out = m_OutputFds[path];
+    out.fd = open(path.c_str(), O_WRONLY | O_CREAT | (append ? 0 : O_TRUNC),
+                  0666);
+    if (out.fd < 0)
+    {
+        std::cerr << "ADIOS THREAD ERROR: FileDrainer couldn't open file "
+                  << path << " for writing, " << std::strerror(errno)
+                  << std::endl;
+    }
+    else if (append)
+    {
+        struct stat fileStat;
+        if (fstat(out.fd, &fileStat) == 0)
+        {
+            out.size = static_cast<size_t>(fileStat.st_size);
+            out.position = out.size;
+        }
+    }
+    return out;
+}
+
+FileDrainerMultiThread::InputFd &
+FileDrainerMultiThread::GetInput(const std::string &path)
+{
+    auto it = m_InputFds.find(path);
+    if (it != m_InputFds.end())
+    {
+        return it->second;
+    }
+
+    InputFd &in = m_InputFds[path];
+    in.fd = open(path.c_str(), O_RDONLY);
+    if (in.fd < 0)
+    {
+        std::cerr << "ADIOS THREAD ERROR: FileDrainer couldn't open file "
+                  << path << " for reading, " << std::strerror(errno)
+                  << std::endl;
+    }
+    return in;
+}
+
+void FileDrainerMultiThread::Submit(Task &&task)
+{
+    const size_t begin = task.toOffset;
+    const size_t end = task.toOffset + task.count;
+    auto lf_Overlaps = [&]() -> bool {
+        auto range = m_InFlight.equal_range(task.toFd);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second.first < end && begin < it->second.second)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    std::unique_lock<std::mutex> lock(m_TasksMutex);
+    m_TasksCV.wait(lock, [&]() {
+        return m_Tasks.size() < 2 * m_Threads && !lf_Overlaps();
+    });
+    m_InFlight.emplace(task.toFd, std::make_pair(begin, end));
+    m_Tasks.push_back(std::move(task));
+    lock.unlock();
+    m_TasksCV.notify_all();
+}
+
+void FileDrainerMultiThread::SubmitCopy(const int fromFd, const int toFd,
+                                        size_t fromOffset, size_t toOffset,
+                                        size_t count,
+                                        const std::string &toPath)
+{
+    const std::string *path = &m_OutputFds.find(toPath)->first;
+    while (count > 0)
+    {
+        Task task;
+        task.fromFd = fromFd;
+        task.toFd = toFd;
+        task.fromOffset = fromOffset;
+        task.toOffset = toOffset;
+        task.count = std::min(count, m_ChunkSize);
+        task.toPath = path;
+
+        fromOffset += task.count;
+        toOffset += task.count;
+        count -= task.count;
+        Submit(std::move(task));
+    }
+}
+
+void FileDrainerMultiThread::WaitForTasks()
+{
+    std::unique_lock<std::mutex> lock(m_TasksMutex);
+    m_TasksCV.wait(lock, [&]() { return m_InFlight.empty(); });
+}
+
+void FileDrainerMultiThread::Throttle(const size_t bytes)
+{
+    if (m_Bandwidth == 0)
+    {
+        return;
+    }
+    core::TimePoint start;
+    {
+        std::lock_guard<std::mutex> lockGuard(m_ThrottleMutex);
+        const core::TimePoint now = core::Now();
+        if (m_NextSlot < now)
+        {
+            m_NextSlot = now;
+        }
+        start = m_NextSlot;
+        m_NextSlot += core::Seconds(static_cast<double>(bytes) /
+                                    static_cast<double>(m_Bandwidth));
+    }
+    std::this_thread::sleep_until(start);
+}
+
+size_t FileDrainerMultiThread::Execute(Task &task, std::vector<char> &buffer)
+{
+    auto lf_PWrite = [&](const char *data, size_t size, size_t offset) {
+        while (size > 0)
+        {
+            const ssize_t n =
+                pwrite(task.toFd, data, size, static_cast<off_t>(offset));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::ios_base::failure(
+                    "FileDrainer couldn't write to file " + *task.toPath +
+                    " offset = " + std::to_string(offset) + " count = " +
+                    std::to_string(size) + " bytes, " +
+                    std::strerror(errno) + "\n");
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+            offset += static_cast<size_t>(n);
+        }
+    };
+
+    if (task.fromFd < 0)
+    {
+        lf_PWrite(task.data.data(), task.count, task.toOffset);
+        return task.count;
+    }
+
+    const std::chrono::duration<double> sleepUnit(0.01);
+    size_t done = 0;
+    while (done < task.count)
+    {
+        const size_t fromOffset = task.fromOffset + done;
+        const size_t toOffset = task.toOffset + done;
+        ssize_t n = -1;
+#ifdef ADIOS2_DRAIN_COPY_FILE_RANGE
+        if (m_UseCopyFileRange)
+        {
+            loff_t in = static_cast<loff_t>(fromOffset);
+            loff_t out = static_cast<loff_t>(toOffset);
+            n = copy_file_range(task.fromFd, &in, task.toFd, &out,
+                                task.count - done, 0);
+            if (n < 0 && (errno == EXDEV || errno == EINVAL ||
+                          errno == ENOSYS || errno == EOPNOTSUPP))
+            {
+                // e.g. burst buffer and target on different file systems
+                m_UseCopyFileRange = false;
+                continue;
+            }
+        }
+        else
+#endif
+        {
+            if (buffer.empty())
+            {
+                buffer.resize(m_ChunkSize);
+            }
+            const size_t size = std::min(buffer.size(), task.count - done);
+            n = pread(task.fromFd, buffer.data(), size,
+                      static_cast<off_t>(fromOffset));
+            if (n > 0)
+            {
+                lf_PWrite(buffer.data(), static_cast<size_t>(n), toOffset);
+            }
+        }
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::ios_base::failure(
+                "FileDrainer couldn't copy to file " + *task.toPath +
+                " offset = " + std::to_string(toOffset) + " count = " +
+                std::to_string(task.count - done) + " bytes, " +
+                std::strerror(errno) + "\n");
+        }
+        if (n == 0)
+        {
+            // data has not arrived on disk yet, see FileDrainer::Read
+            std::this_thread::sleep_for(sleepUnit);
+            continue;
+        }
+        done += static_cast<size_t>(n);
+    }
+    return done;
+}
+
+void FileDrainerMultiThread::CloseAllFds()
+{
+    for (auto &pair : m_OutputFds)
+    {
+        if (pair.second.fd >= 0)
+        {
+            close(pair.second.fd);
+        }
+    }
+    m_OutputFds.clear();
+    for (auto &pair : m_InputFds)
+    {
+        if (pair.second.fd >= 0)
+        {
+            close(pair.second.fd);
+        }
+    }
+    m_InputFds.clear();
+}
+
+} // end namespace burstbuffer
+} // end namespace adios2
@@ -0,0 +1,145 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileDrainerMultiThread.h
+ *
+ * Drainer with a pool of worker threads copying with copy_file_range (or
+ * pread/pwrite) between POSIX file descriptors
+ */
+
+#ifndef ADIOS2_TOOLKIT_BURSTBUFFER_FILEDRAINERMULTITHREAD_H_
+#define ADIOS2_TOOLKIT_BURSTBUFFER_FILEDRAINERMULTITHREAD_H_
+
+#include "adios2/toolkit/burstbuffer/FileDrainer.h"
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <utility> // std::pair
+#include <vector>
+
+namespace adios2
+{
+namespace burstbuffer
+{
+
+/**
+ * One dispatcher thread takes the operations in order, tracks the file
+ * positions that Copy/Write/SeekEnd imply, and turns copies and writes into
+ * tasks with explicit offsets, split in chunks. The worker threads run the
+ * tasks, so several chunks of one file and several files drain at once.
+ * A task waits for earlier tasks that overlap it in the same target file, so
+ * the result is the same as draining the operations one after the other.
+ */
+class FileDrainerMultiThread : public FileDrainer
+{
+
+public:
+    static const size_t defaultChunkSize = 4194304; // 4MB
+
+    /**
+     * @param nThreads number of worker threads
+     * @param bandwidth cap on the sum of all workers in bytes per second,
+     * 0: unlimited
+     */
+    FileDrainerMultiThread(const unsigned int nThreads,
+                           const size_t bandwidth = 0);
+
+    ~FileDrainerMultiThread();
+
+    void SetChunkSize(size_t chunkSizeBytes);
+
+    /** Create the dispatcher and the worker threads, they idle if there are
+     * no operations given. Finish() will complete all work then join them */
+    void Start() final;
+
+    /** Tell threads to terminate when all draining has finished. */
+    void Finish() final;
+
+    /** Join the threads. Main thread will block until they terminate */
+    void Join() final;
+
+private:
+    struct Task
+    {
+        int fromFd;             // -1: write dataToWrite
+        int toFd;
+        size_t fromOffset;
+        size_t toOffset;
+        size_t count;
+        std::vector<char> data; // memory to write if fromFd == -1
+        const std::string *toPath;
+    };
+
+    /** position and size of a target file as seen by the operations */
+    struct OutputFd
+    {
+        int fd = -1;
+        size_t position = 0;
+        size_t size = 0;
+    };
+
+    struct InputFd
+    {
+        int fd = -1;
+        size_t position = 0;
+    };
+
+    const unsigned int m_Threads;
+    const size_t m_Bandwidth;
+    size_t m_ChunkSize = defaultChunkSize;
+
+    std::thread m_Dispatcher;
+    std::vector<std::thread> m_Workers;
+    bool m_Finish = false;
+    std::mutex m_FinishMutex;
+
+    /** queue of tasks for the workers, and the target file ranges being
+     * written by a worker or waiting in the queue */
+    std::deque<Task> m_Tasks;
+    std::multimap<int, std::pair<size_t, size_t>> m_InFlight;
+    bool m_WorkersDone = false;
+    std::mutex m_TasksMutex;
+    std::condition_variable m_TasksCV;
+
+    /** earliest time the next transfer may start under the bandwidth cap */
+    core::TimePoint m_NextSlot;
+    std::mutex m_ThrottleMutex;
+
+    std::atomic<bool> m_UseCopyFileRange{true};
+
+    /** only used by the dispatcher thread */
+    std::map<std::string, OutputFd> m_OutputFds;
+    std::map<std::string, InputFd> m_InputFds;
+
+    void DispatchThread();
+    void WorkerThread();
+
+    OutputFd &GetOutput(const std::string &path, const bool append);
+    InputFd &GetInput(const std::string &path);
+
+    /** queue a task, blocking while it overlaps an earlier one in the same
+     * target file or while the queue is full */
+    void Submit(Task &&task);
+
+    /** queue chunks of a copy from fromFd to toFd */
+    void SubmitCopy(const int fromFd, const int toFd, size_t fromOffset,
+                    size_t toOffset, size_t count, const std::string &toPath);
+
+    /** block until all submitted tasks have completed */
+    void WaitForTasks();
+
+    /** sleep as needed to keep all workers under m_Bandwidth */
+    void Throttle(const size_t bytes);
+
+    /** run one task on the calling worker, returns bytes written */
+    size_t Execute(Task &task, std::vector<char> &buffer);
+
+    void CloseAllFds();
+};
+
+} // end namespace burstbuffer
+} // end namespace adios2
+
+#endif /* ADIOS2_TOOLKIT_BURSTBUFFER_FILEDRAINERMULTITHREAD_H_ */
@@ -45,6 +45,7 @@ void FileDrainerSingleThread::SetBufferSize(size_t bufferSizeBytes)
 
 void FileDrainerSingleThread::Start()
 {
+    m_StartTime = core::Now();
     th = std::thread(&FileDrainerSingleThread::DrainThread, this);
 }
 
@@ -119,6 +120,7 @@ void FileDrainerSingleThread::DrainThread()
         te = core::Now();
         timeWrite += te - ts;
         nWriteBytesSucc += n;
+        m_BytesDrained += n;
     };
 
     std::chrono::duration<double> d(0.100);
@@ -258,6 +260,7 @@ void FileDrainerSingleThread::DrainThread()
             te = core::Now();
             timeWrite += te - ts;
             nWriteBytesSucc += n;
+            m_BytesDrained += n;
             break;
         }
         case DrainOperation::Write:
@@ -279,6 +282,7 @@ void FileDrainerSingleThread::DrainThread()
             te = core::Now();
             timeWrite += te - ts;
             nWriteBytesSucc += n;
+            m_BytesDrained += n;
             break;
         }
         case DrainOperation::Create:
@@ -209,6 +209,27 @@ void BPBase::Init(const Params &parameters, const std::string hint,
                 static_cast<int>(helper::StringTo<int32_t>(
                     value, " in Parameter key=BurstBufferVerbose " + hint));
         }
+        else if (key == "burstbufferdrainthreads")
+        {
+            parsedParameters.BurstBufferDrainThreads =
+                static_cast<unsigned int>(helper::StringTo<uint32_t>(
+                    value,
+                    " in Parameter key=BurstBufferDrainThreads " + hint));
+        }
+        else if (key == "burstbufferdrainbandwidth")
+        {
+            parsedParameters.BurstBufferDrainBandwidth =
+                helper::StringToByteUnits(
+                    value, "for Parameter key=BurstBufferDrainBandwidth, in "
+                           "call to Open");
+        }
+        else if (key == "concurrenttransportwrites")
+        {
+            parsedParameters.ConcurrentTransportWrites =
+                helper::StringTo<bool>(
+                    value, " in Parameter key=ConcurrentTransportWrites " +
+                               hint);
+        }
         else if (key == "streamreader")
         {
             parsedParameters.StreamReader = helper::StringTo<bool>(
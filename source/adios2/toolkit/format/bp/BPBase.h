@@ -211,6 +211,17 @@ public:
         /** Verbose level for burst buffer draining thread */
         int BurstBufferVerbose = 0;
 
+        /** Number of threads draining the burst buffer, 1: the single
+         * threaded std::fstream drainer */
+        unsigned int BurstBufferDrainThreads = 1;
+
+        /** Cap on the draining bandwidth in bytes per second, 0: none */
+        size_t BurstBufferDrainBandwidth = 0;
+
+        /** Write data to all transports at the same time, one thread each,
+         * instead of one after the other */
+        bool ConcurrentTransportWrites = false;
+
         /** Stream reader flag: process metadata step-by-step
          * instead of parsing everything available
          */
@@ -30,7 +30,10 @@
 
 #include "adios2/operator/OperatorFactory.h"
 
+#include <algorithm>
+#include <atomic>
 #include <float.h>
+#include <future>
 #include <limits.h>
 #include <math.h>
 #include <string.h>
@@ -243,6 +246,8 @@ BP5Deserializer::ControlInfo *BP5Deserializer::BuildControl(FMFormat Format)
     int ControlCount = 0;
     ControlInfo *ret = (BP5Deserializer::ControlInfo *)malloc(sizeof(*ret));
     ret->Format = Format;
+    ret->DeltaEncoded =
+        (strcmp(FormatList[0].format_name, "MetaDataDelta") == 0);
     ret->MetaFieldOffset = new std::vector<size_t>();
     ret->CIVarIndex = new std::vector<size_t>();
     size_t VarIndex = 0;
@@ -483,15 +488,10 @@ size_t BP5Deserializer::WriterCohortSize(size_t Step)
     }
 }
 
-void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
-                                      size_t WriterRank, size_t Step)
+FFSTypeHandle BP5Deserializer::MetaDataFormat(char *MetadataBlock)
 {
-    const size_t writerCohortSize = WriterCohortSize(Step);
-    FFSTypeHandle FFSformat;
-    void *BaseData;
-    static int DumpMetadata = -1;
-    FFSformat =
-        FFSTypeHandle_from_encode(ReaderFFSContext, (char *)MetadataBlock);
+    FFSTypeHandle FFSformat =
+        FFSTypeHandle_from_encode(ReaderFFSContext, MetadataBlock);
     if (!FFSformat)
     {
         throw std::logic_error("Internal error or file corruption, no know "
@@ -500,13 +500,32 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
     if (!FFShas_conversion(FFSformat))
     {
         FMContext FMC = FMContext_from_FFS(ReaderFFSContext);
-        FMFormat Format = FMformat_from_ID(FMC, (char *)MetadataBlock);
+        FMFormat Format = FMformat_from_ID(FMC, MetadataBlock);
         FMStructDescList List =
             FMcopy_struct_list(format_list_of_FMFormat(Format));
         // GSE - restrict to homogenous FTM       FMlocalize_structs(List);
         establish_conversion(ReaderFFSContext, FFSformat, List);
         FMfree_struct_list(List);
     }
+    return FFSformat;
+}
+
+void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
+                                      size_t WriterRank, size_t Step)
+{
+    const size_t writerCohortSize = WriterCohortSize(Step);
+    FFSTypeHandle FFSformat;
+    void *BaseData;
+    static int DumpMetadata = -1;
+    if (m_LazyMetadata || m_ReadOnlyMetadata)
+    {
+        // decoding happens in place, keep the caller's block intact
+        auto &Copies = m_StepMetadataCopies[Step];
+        Copies.emplace_back((char *)MetadataBlock,
+                            (char *)MetadataBlock + BlockLen);
+        MetadataBlock = Copies.back().data();
+    }
+    FFSformat = MetaDataFormat((char *)MetadataBlock);
     if (FFSdecode_in_place_possible(FFSformat))
     {
         FFSdecode_in_place(ReaderFFSContext, (char *)MetadataBlock, &BaseData);
@@ -515,7 +534,17 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
     {
         int DecodedLength = FFS_est_decode_length(
             ReaderFFSContext, (char *)MetadataBlock, BlockLen);
-        BaseData = malloc(DecodedLength);
+        if (m_LazyMetadata || m_ReadOnlyMetadata)
+        {
+            // freed with the step's copies when it is uninstalled
+            auto &Copies = m_StepMetadataCopies[Step];
+            Copies.emplace_back(DecodedLength);
+            BaseData = Copies.back().data();
+        }
+        else
+        {
+            BaseData = malloc(DecodedLength);
+        }
         FFSdecode_to_buffer(ReaderFFSContext, (char *)MetadataBlock, BaseData);
     }
     if (DumpMetadata == -1)
@@ -550,7 +579,10 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
         }
         m_ControlArray[Step][WriterRank] = Control;
 
-        MetadataBaseArray.resize(Step + 1);
+        if (MetadataBaseArray.size() < Step + 1)
+        {
+            MetadataBaseArray.resize(Step + 1);
+        }
         if (MetadataBaseArray[Step] == nullptr)
         {
             m_MetadataBaseAddrs = new std::vector<void *>();
@@ -595,6 +627,14 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
             (ControlFields[i].OrigShapeID == ShapeID::LocalArray))
         {
             MetaArrayRec *meta_base = (MetaArrayRec *)field_data;
+            const bool Inherited = Control->DeltaEncoded &&
+                                   meta_base->Dims &&
+                                   (meta_base->DBCount == 0);
+            if (Inherited)
+            {
+                // already in reader order
+                InheritDims(VarRec, meta_base, WriterRank, Step);
+            }
             size_t BlockCount =
                 meta_base->Dims ? meta_base->DBCount / meta_base->Dims : 1;
             if ((meta_base->Dims > 1) &&
@@ -603,15 +643,41 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
                 /* if we're getting data from someone of the other array gender,
                  * switcheroo */
                 ReverseDimensions(meta_base->Shape, meta_base->Dims, 1);
-                ReverseDimensions(meta_base->Count, meta_base->Dims,
-                                  BlockCount);
-                ReverseDimensions(meta_base->Offsets, meta_base->Dims,
-                                  BlockCount);
+                if (!Inherited)
+                {
+                    ReverseDimensions(meta_base->Count, meta_base->Dims,
+                                      BlockCount);
+                    ReverseDimensions(meta_base->Offsets, meta_base->Dims,
+                                      BlockCount);
+                }
+            }
+            if (Control->DeltaEncoded && !Inherited && !m_RandomAccessMode)
+            {
+                // the next step of this writer may refer to these
+                if (writerCohortSize > VarRec->PerWriterDims.size())
+                {
+                    VarRec->PerWriterDims.resize(writerCohortSize);
+                }
+                std::vector<size_t> &Dims = VarRec->PerWriterDims[WriterRank];
+                Dims.assign(meta_base->Count,
+                            meta_base->Count + meta_base->DBCount);
+                if (meta_base->Offsets)
+                {
+                    Dims.insert(Dims.end(), meta_base->Offsets,
+                                meta_base->Offsets + meta_base->DBCount);
+                }
             }
             if ((WriterRank == 0) || (VarRec->GlobalDims == NULL))
             {
                 // use the shape from rank 0 (or first non-NULL)
                 VarRec->GlobalDims = meta_base->Shape;
+                if (m_LazyMetadata && meta_base->Shape)
+                {
+                    // the step holding Shape may be uninstalled later
+                    VarRec->GlobalDimsCopy.assign(
+                        meta_base->Shape, meta_base->Shape + meta_base->Dims);
+                    VarRec->GlobalDims = VarRec->GlobalDimsCopy.data();
+                }
             }
             if (!VarRec->Variable)
             {
@@ -665,8 +731,10 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
             }
             else
             {
-                //   Random access, add to m_AvailableShapes
-                if ((VarRec->LastShapeAdded != Step) && meta_base->Shape)
+                /*   Random access, add to m_AvailableShapes.  In lazy mode
+                 * most steps are not installed, VarShape answers instead */
+                if (!m_LazyMetadata && (VarRec->LastShapeAdded != Step) &&
+                    meta_base->Shape)
                 {
                     std::vector<size_t> shape;
                     for (size_t i = 0; i < meta_base->Dims; i++)
@@ -709,13 +777,16 @@ void BP5Deserializer::InstallMetaData(void *MetadataBlock, size_t BlockLen,
                 VarRec->LastTSAdded = Step; // starts at 1
             }
         }
-        if (m_RandomAccessMode && (VarRec->LastTSAdded != Step))
+        /* in lazy mode steps are installed out of order and possibly more
+         * than once, SetLazyStepCounts counts them at Open */
+        if (m_RandomAccessMode && !m_LazyMetadata &&
+            (VarRec->LastTSAdded != Step))
         {
             static_cast<VariableBase *>(VarRec->Variable)
                 ->m_AvailableStepsCount++;
             VarRec->LastTSAdded = Step;
         }
-        if (VarRec->FirstTSSeen == SIZE_MAX)
+        if ((VarRec->FirstTSSeen == SIZE_MAX) || (Step < VarRec->FirstTSSeen))
         {
             VarRec->FirstTSSeen = Step;
         }
@@ -739,6 +810,13 @@ void BP5Deserializer::InstallAttributeData(void *AttributeBlock,
         m_Engine->m_IO.RemoveAllAttributes();
         m_LastAttrStep = Step;
     }
+    std::vector<char> AttributeCopy;
+    if (m_ReadOnlyMetadata)
+    {
+        AttributeCopy.assign((char *)AttributeBlock,
+                             (char *)AttributeBlock + BlockLen);
+        AttributeBlock = AttributeCopy.data();
+    }
     FFSformat =
         FFSTypeHandle_from_encode(ReaderFFSContext, (char *)AttributeBlock);
     if (!FFSformat)
@@ -932,6 +1010,7 @@ bool BP5Deserializer::QueueGetSingle(core::VariableBase &variable,
                                      void *DestData, size_t Step)
 {
     BP5VarRec *VarRec = VarByKey[&variable];
+    EnsureStepInstalled(Step);
     if (VarRec->OrigShapeID == ShapeID::GlobalValue)
     {
         const size_t writerCohortSize = WriterCohortSize(Step);
@@ -998,6 +1077,25 @@ bool BP5Deserializer::QueueGetSingle(core::VariableBase &variable,
     return true;
 }
 
+static bool IntersectionCheck(size_t dimensionsSize, const size_t *start1,
+                              const size_t *count1, const size_t *start2,
+                              const size_t *count2)
+{
+    for (size_t i = 0; i < dimensionsSize; i++)
+    {
+        if ((count1[i] == 0) || (count2[i] == 0))
+        {
+            return false;
+        }
+        if ((start1[i] < start2[i] && (start1[i] + count1[i]) <= start2[i]) ||
+            (start1[i] >= start2[i] + count2[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool BP5Deserializer::NeedWriter(BP5ArrayRequest Req, size_t WriterRank,
                                  size_t &NodeFirst)
 {
@@ -1047,200 +1145,255 @@ bool BP5Deserializer::NeedWriter(BP5ArrayRequest Req, size_t WriterRank,
     // else Global case
     for (size_t i = 0; i < writer_meta_base->BlockCount; i++)
     {
-        bool NeedThisBlock = true;
-        for (size_t j = 0; j < writer_meta_base->Dims; j++)
-        {
-            size_t SelOffset = Req.Start[j];
-            size_t SelSize = Req.Count[j];
-            size_t RankOffset;
-            size_t RankSize;
-
-            RankOffset =
-                writer_meta_base->Offsets[i * writer_meta_base->Dims + j];
-            RankSize = writer_meta_base->Count[i * writer_meta_base->Dims + j];
-            if ((SelSize == 0) || (RankSize == 0))
-            {
-                NeedThisBlock = false;
-            }
-            if ((RankOffset < SelOffset &&
-                 (RankOffset + RankSize) <= SelOffset) ||
-                (RankOffset >= SelOffset + SelSize))
-            {
-                NeedThisBlock = false;
-            }
-        }
-        if (NeedThisBlock)
+        if (IntersectionCheck(
+                writer_meta_base->Dims,
+                &writer_meta_base->Offsets[i * writer_meta_base->Dims],
+                &writer_meta_base->Count[i * writer_meta_base->Dims],
+                Req.Start.data(), Req.Count.data()))
             return true;
     }
     return false;
 }
 
+size_t BP5Deserializer::BlockDataLength(const BP5VarRec *VarRec,
+                                        const MetaArrayRec *writer_meta_base,
+                                        size_t Block)
+{
+    if (VarRec->Operator != NULL)
+    {
+        return ((MetaArrayRecOperator *)writer_meta_base)->DataLengths[Block];
+    }
+    size_t Length = VarRec->ElementSize;
+    for (size_t dim = 0; dim < writer_meta_base->Dims; dim++)
+    {
+        Length *= writer_meta_base->Count[Block * writer_meta_base->Dims + dim];
+    }
+    return Length;
+}
+
 std::vector<BP5Deserializer::ReadRequest>
-BP5Deserializer::GenerateReadRequests()
+BP5Deserializer::GenerateReadRequests(const bool doAllocTempBuffers)
 {
     std::vector<BP5Deserializer::ReadRequest> Ret;
-    // std::vector<FFSReaderPerWriterRec> WriterInfo(m_WriterCohortSize);
-    typedef std::pair<size_t, size_t> pair;
-    std::map<pair, bool> WriterTSNeeded;
 
-    for (const auto &Req : PendingRequests)
+    /*
+     * One read request per (pending Get, writer, block) that the selection
+     * actually touches.  Only the bytes of those blocks are read, not the
+     * whole data block the writer produced in that step.
+     */
+    for (size_t ReqIndex = 0; ReqIndex < PendingRequests.size(); ReqIndex++)
     {
+        const auto &Req = PendingRequests[ReqIndex];
         const size_t writerCohortSize = WriterCohortSize(Req.Step);
-        for (size_t i = 0; i < writerCohortSize; i++)
+        for (size_t WriterRank = 0; WriterRank < writerCohortSize;
+             WriterRank++)
         {
-            if (WriterTSNeeded.count(std::make_pair(Req.Step, i)) == 0)
+            size_t NodeFirst = 0;
+            if (!NeedWriter(Req, WriterRank, NodeFirst))
+                continue;
+            MetaArrayRec *writer_meta_base = (MetaArrayRec *)GetMetadataBase(
+                Req.VarRec, Req.Step, WriterRank);
+            if (!writer_meta_base || (writer_meta_base->DataLocation == NULL))
+            {
+                // No Data from this writer
+                continue;
+            }
+            size_t FirstBlock = 0;
+            size_t EndBlock = writer_meta_base->BlockCount;
+            if (Req.RequestType == Local)
             {
-                WriterTSNeeded[std::make_pair(Req.Step, i)] = true;
+                FirstBlock = Req.BlockID - NodeFirst;
+                EndBlock = FirstBlock + 1;
+            }
+            for (size_t Block = FirstBlock; Block < EndBlock; Block++)
+            {
+                if ((Req.RequestType == Global) &&
+                    !IntersectionCheck(
+                        writer_meta_base->Dims,
+                        &writer_meta_base
+                             ->Offsets[Block * writer_meta_base->Dims],
+                        &writer_meta_base
+                             ->Count[Block * writer_meta_base->Dims],
+                        Req.Start.data(), Req.Count.data()))
+                {
+                    continue;
+                }
+                ReadRequest RR;
+                RR.Timestep = Req.Step;
+                RR.WriterRank = WriterRank;
+                RR.StartOffset = writer_meta_base->DataLocation[Block];
+                RR.ReadLength =
+                    BlockDataLength(Req.VarRec, writer_meta_base, Block);
+                RR.DestinationAddr = NULL;
+                if (doAllocTempBuffers)
+                {
+                    RR.DestinationAddr = (char *)malloc(RR.ReadLength);
+                }
+                RR.Internal = NULL;
+                RR.ReqIndex = ReqIndex;
+                RR.BlockID = Block;
+                RR.Borrowed = false;
+                Ret.push_back(RR);
             }
         }
     }
+    return Ret;
+}
 
-    for (std::pair<pair, bool> element : WriterTSNeeded)
+void BP5Deserializer::FinalizeGet(const ReadRequest &Read,
+                                  std::vector<char> &DecompressBuffer)
+{
+    const auto &Req = PendingRequests[Read.ReqIndex];
+    MetaArrayRec *writer_meta_base = (MetaArrayRec *)GetMetadataBase(
+        Req.VarRec, Req.Step, Read.WriterRank);
+
+    int ElementSize = Req.VarRec->ElementSize;
+    size_t *GlobalDimensions = Req.VarRec->GlobalDims;
+    size_t DimCount = writer_meta_base->Dims;
+    const size_t Block = Read.BlockID;
+    size_t *RankOffset =
+        &writer_meta_base->Offsets[Block * writer_meta_base->Dims];
+    const size_t *RankSize =
+        &writer_meta_base->Count[Block * writer_meta_base->Dims];
+    std::vector<size_t> ZeroSel(DimCount);
+    std::vector<size_t> ZeroRankOffset(DimCount);
+    std::vector<size_t> ZeroGlobalDimensions(DimCount);
+    const size_t *SelOffset = NULL;
+    const size_t *SelSize = NULL;
+
+    char *IncomingData = Read.DestinationAddr;
+    if (Req.VarRec->Operator != NULL)
     {
-        ReadRequest RR;
-        RR.Timestep = element.first.first;
-        RR.WriterRank = element.first.second;
-        RR.StartOffset = 0;
-        if (m_RandomAccessMode)
+        size_t DestSize = Req.VarRec->ElementSize;
+        for (size_t dim = 0; dim < Req.VarRec->DimCount; dim++)
         {
-            RR.ReadLength =
-                ((struct BP5MetadataInfoStruct *)((
-                     *MetadataBaseArray[RR.Timestep])[RR.WriterRank]))
-                    ->DataBlockSize;
+            DestSize *=
+                writer_meta_base->Count[dim + Block * writer_meta_base->Dims];
         }
-        else
+        DecompressBuffer.resize(DestSize);
+        /* the first byte of a compressed block is the operator type */
+        std::unique_lock<std::mutex> Lock(m_OperatorMutex, std::defer_lock);
+        if (!core::OperatorIsThreadSafe(
+                static_cast<core::Operator::OperatorType>(IncomingData[0])))
         {
-            RR.ReadLength = ((struct BP5MetadataInfoStruct
-                                  *)(*m_MetadataBaseAddrs)[RR.WriterRank])
-                                ->DataBlockSize;
+            Lock.lock();
         }
-        RR.DestinationAddr = (char *)malloc(RR.ReadLength);
-        RR.Internal = NULL;
-        Ret.push_back(RR);
+        core::Decompress(IncomingData, Read.ReadLength,
+                         DecompressBuffer.data());
+        IncomingData = DecompressBuffer.data();
+    }
+    if (Req.Start.size())
+    {
+        SelOffset = Req.Start.data();
+    }
+    if (Req.Count.size())
+    {
+        SelSize = Req.Count.data();
+    }
+    if (Req.RequestType == Local)
+    {
+        RankOffset = ZeroRankOffset.data();
+        GlobalDimensions = ZeroGlobalDimensions.data();
+        if (SelSize == NULL)
+        {
+            SelSize = RankSize;
+        }
+        if (SelOffset == NULL)
+        {
+            SelOffset = ZeroSel.data();
+        }
+        for (size_t i = 0; i < DimCount; i++)
+        {
+            GlobalDimensions[i] = RankSize[i];
+        }
+    }
+    if (m_ReaderIsRowMajor)
+    {
+        ExtractSelectionFromPartialRM(ElementSize, DimCount, GlobalDimensions,
+                                      RankOffset, RankSize, SelOffset, SelSize,
+                                      IncomingData, (char *)Req.Data,
+                                      Req.MemSpace);
+    }
+    else
+    {
+        ExtractSelectionFromPartialCM(ElementSize, DimCount, GlobalDimensions,
+                                      RankOffset, RankSize, SelOffset, SelSize,
+                                      IncomingData, (char *)Req.Data,
+                                      Req.MemSpace);
     }
-    return Ret;
 }
 
 void BP5Deserializer::FinalizeGets(std::vector<ReadRequest> Requests)
 {
-    for (const auto &Req : PendingRequests)
+    /* Blocks are independent and their destination regions do not overlap,
+     * so they can be decompressed and scattered concurrently, except for
+     * the operators that are not thread safe, see FinalizeGet */
+    const size_t nThreads = std::max(
+        static_cast<size_t>(1), std::min(m_Threads, Requests.size()));
+    if (m_DecompressBuffers.size() < nThreads)
     {
-        //        ImplementGapWarning(Reqs);
-        const size_t writerCohortSize = WriterCohortSize(Req.Step);
-        for (size_t WriterRank = 0; WriterRank < writerCohortSize; WriterRank++)
+        m_DecompressBuffers.resize(nThreads);
+    }
+    std::exception_ptr Error;
+    if (nThreads == 1)
+    {
+        for (const auto &Read : Requests)
         {
-            size_t NodeFirst = 0;
-            if (NeedWriter(Req, WriterRank, NodeFirst))
+            FinalizeGet(Read, m_DecompressBuffers[0]);
+        }
+    }
+    else
+    {
+        std::atomic<size_t> NextRead(0);
+        auto lf_Finalize = [&](size_t tid) {
+            size_t r;
+            while ((r = NextRead++) < Requests.size())
             {
-                /* if needed this writer fill destination with acquired data */
-                int ElementSize = Req.VarRec->ElementSize;
-                size_t *GlobalDimensions = Req.VarRec->GlobalDims;
-                MetaArrayRec *writer_meta_base =
-                    (MetaArrayRec *)GetMetadataBase(Req.VarRec, Req.Step,
-                                                    WriterRank);
-                if (!writer_meta_base)
-                    continue; // Not writen on this step
-
-                int DimCount = writer_meta_base->Dims;
-                for (size_t Block = 0; Block < writer_meta_base->BlockCount;
-                     Block++)
+                FinalizeGet(Requests[r], m_DecompressBuffers[tid]);
+            }
+        };
+        std::vector<std::future<void>> futures;
+        futures.reserve(nThreads - 1);
+        for (size_t tid = 1; tid < nThreads; tid++)
+        {
+            futures.push_back(std::async(std::launch::async, lf_Finalize, tid));
+        }
+        try
+        {
+            lf_Finalize(0);
+        }
+        catch (...)
+        {
+            NextRead = Requests.size();
+            Error = std::current_exception();
+        }
+        for (auto &f : futures)
+        {
+            try
+            {
+                f.get();
+            }
+            catch (...)
+            {
+                if (!Error)
                 {
-                    size_t *RankOffset =
-                        &writer_meta_base
-                             ->Offsets[Block * writer_meta_base->Dims];
-                    const size_t *RankSize =
-                        &writer_meta_base
-                             ->Count[Block * writer_meta_base->Dims];
-                    std::vector<size_t> ZeroSel(DimCount);
-                    std::vector<size_t> ZeroRankOffset(DimCount);
-                    std::vector<size_t> ZeroGlobalDimensions(DimCount);
-                    const size_t *SelOffset = NULL;
-                    const size_t *SelSize = NULL;
-                    int ReqIndex = 0;
-                    while (Requests[ReqIndex].WriterRank !=
-                               static_cast<size_t>(WriterRank) ||
-                           (Requests[ReqIndex].Timestep != Req.Step))
-                        ReqIndex++;
-                    if (writer_meta_base->DataLocation == NULL)
-                    {
-                        // No Data from this writer
-                        continue;
-                    }
-                    char *IncomingData =
-                        (char *)Requests[ReqIndex].DestinationAddr +
-                        writer_meta_base->DataLocation[Block];
-                    std::vector<char> decompressBuffer;
-                    if (Req.VarRec->Operator != NULL)
-                    {
-                        size_t DestSize = Req.VarRec->ElementSize;
-                        for (size_t dim = 0; dim < Req.VarRec->DimCount; dim++)
-                        {
-                            DestSize *=
-                                writer_meta_base
-                                    ->Count[dim +
-                                            Block * writer_meta_base->Dims];
-                        }
-                        decompressBuffer.resize(DestSize);
-                        core::Decompress(
-                            IncomingData,
-                            ((MetaArrayRecOperator *)writer_meta_base)
-                                ->DataLengths[Block],
-                            decompressBuffer.data());
-                        IncomingData = decompressBuffer.data();
-                    }
-                    if (Req.Start.size())
-                    {
-                        SelOffset = Req.Start.data();
-                    }
-                    if (Req.Count.size())
-                    {
-                        SelSize = Req.Count.data();
-                    }
-                    if (Req.RequestType == Local)
-                    {
-                        int LocalBlockID = Req.BlockID - NodeFirst;
-                        IncomingData =
-                            (char *)Requests[ReqIndex].DestinationAddr +
-                            writer_meta_base->DataLocation[LocalBlockID];
-
-                        RankOffset = ZeroRankOffset.data();
-                        GlobalDimensions = ZeroGlobalDimensions.data();
-                        if (SelSize == NULL)
-                        {
-                            SelSize = RankSize;
-                        }
-                        if (SelOffset == NULL)
-                        {
-                            SelOffset = ZeroSel.data();
-                        }
-                        for (int i = 0; i < DimCount; i++)
-                        {
-                            GlobalDimensions[i] = RankSize[i];
-                        }
-                    }
-                    if (m_ReaderIsRowMajor)
-                    {
-                        ExtractSelectionFromPartialRM(
-                            ElementSize, DimCount, GlobalDimensions, RankOffset,
-                            RankSize, SelOffset, SelSize, IncomingData,
-                            (char *)Req.Data, Req.MemSpace);
-                    }
-                    else
-                    {
-                        ExtractSelectionFromPartialCM(
-                            ElementSize, DimCount, GlobalDimensions, RankOffset,
-                            RankSize, SelOffset, SelSize, IncomingData,
-                            (char *)Req.Data, Req.MemSpace);
-                    }
+                    Error = std::current_exception();
                 }
             }
         }
     }
     for (const auto &Req : Requests)
     {
-        free((char *)Req.DestinationAddr);
+        if (!Req.Borrowed)
+        {
+            free((char *)Req.DestinationAddr);
+        }
     }
     PendingRequests.clear();
+    if (Error)
+    {
+        std::rethrow_exception(Error);
+    }
 }
 
 void BP5Deserializer::MapGlobalToLocalIndex(size_t Dims,
@@ -1555,6 +1708,213 @@ BP5Deserializer::~BP5Deserializer()
     }
 }
 
+void BP5Deserializer::SetLazyMetadata(size_t MaxSteps,
+                                      std::function<void(size_t)> StepLoader)
+{
+    m_LazyMetadata = true;
+    m_MaxInstalledSteps = MaxSteps;
+    m_StepLoader = StepLoader;
+}
+
+void BP5Deserializer::EnsureStepInstalled(size_t Step)
+{
+    if (!m_LazyMetadata)
+    {
+        return;
+    }
+    if ((Step < MetadataBaseArray.size()) && MetadataBaseArray[Step])
+    {
+        if (!m_InstalledSteps.empty() && (m_InstalledSteps.front() != Step))
+        {
+            m_InstalledSteps.remove(Step);
+            m_InstalledSteps.push_front(Step);
+        }
+        return;
+    }
+    /* A step with delta encoded records needs the step before it installed,
+     * which may need the one before it.  Walk back until a step installs on
+     * its own, then install forward again. */
+    std::vector<size_t> Chain{Step};
+    while (!Chain.empty())
+    {
+        const size_t S = Chain.back();
+        m_MissingPreviousStep = false;
+        m_StepLoader(S);
+        if (m_MissingPreviousStep)
+        {
+            UninstallStep(S);
+            Chain.push_back(S - 1);
+            continue;
+        }
+        Chain.pop_back();
+        m_InstalledSteps.push_front(S);
+    }
+
+    if (m_MaxInstalledSteps == 0)
+    {
+        return;
+    }
+    auto it = m_InstalledSteps.end();
+    while ((m_InstalledSteps.size() > m_MaxInstalledSteps) &&
+           (it != m_InstalledSteps.begin()))
+    {
+        --it;
+        const size_t Victim = *it;
+        bool Pending = (Victim == Step);
+        for (const auto &Req : PendingRequests)
+        {
+            Pending |= (Req.Step == Victim);
+        }
+        if (!Pending)
+        {
+            UninstallStep(Victim);
+            it = m_InstalledSteps.erase(it);
+        }
+    }
+}
+
+void BP5Deserializer::UninstallStep(size_t Step)
+{
+    delete MetadataBaseArray[Step];
+    MetadataBaseArray[Step] = nullptr;
+    m_ControlArray[Step].clear();
+    m_StepMetadataCopies.erase(Step);
+    m_StepDimsCopies.erase(Step);
+}
+
+void BP5Deserializer::InheritDims(BP5VarRec *VarRec, MetaArrayRec *meta_base,
+                                  size_t WriterRank, size_t Step)
+{
+    const size_t DBCount = meta_base->Dims * meta_base->BlockCount;
+    if (!m_RandomAccessMode)
+    {
+        if ((VarRec->PerWriterDims.size() <= WriterRank) ||
+            (VarRec->PerWriterDims[WriterRank].size() < DBCount))
+        {
+            throw std::runtime_error(
+                "ERROR: BP5 metadata of variable " +
+                std::string(VarRec->VarName) + " from writer " +
+                std::to_string(WriterRank) +
+                " refers to a previous step that was not read");
+        }
+        size_t *Dims = VarRec->PerWriterDims[WriterRank].data();
+        meta_base->DBCount = DBCount;
+        meta_base->Count = Dims;
+        meta_base->Offsets =
+            (VarRec->PerWriterDims[WriterRank].size() == 2 * DBCount)
+                ? Dims + DBCount
+                : NULL;
+        return;
+    }
+
+    auto lf_Installed = [&](size_t S) {
+        return (S < MetadataBaseArray.size()) && MetadataBaseArray[S] &&
+               (S < m_ControlArray.size()) &&
+               (m_ControlArray[S].size() > WriterRank) &&
+               m_ControlArray[S][WriterRank];
+    };
+    if ((Step > 0) && m_LazyMetadata && !lf_Installed(Step - 1))
+    {
+        // EnsureStepInstalled installs the previous step and retries
+        m_MissingPreviousStep = true;
+        return;
+    }
+    MetaArrayRec *prev = nullptr;
+    if ((Step > 0) && lf_Installed(Step - 1))
+    {
+        prev = (MetaArrayRec *)GetMetadataBase(VarRec, Step - 1, WriterRank);
+    }
+    if (!prev || (prev->DBCount != DBCount))
+    {
+        throw std::runtime_error(
+            "ERROR: BP5 metadata of variable " + std::string(VarRec->VarName) +
+            " from writer " + std::to_string(WriterRank) + " in step " +
+            std::to_string(Step) +
+            " refers to the previous step, which does not match");
+    }
+    meta_base->DBCount = DBCount;
+    meta_base->Count = prev->Count;
+    meta_base->Offsets = prev->Offsets;
+    if (m_LazyMetadata)
+    {
+        // the previous step may be uninstalled before this one
+        auto &Copies = m_StepDimsCopies[Step];
+        Copies.emplace_back(prev->Count, prev->Count + DBCount);
+        if (prev->Offsets)
+        {
+            Copies.back().insert(Copies.back().end(), prev->Offsets,
+                                 prev->Offsets + DBCount);
+        }
+        meta_base->Count = Copies.back().data();
+        meta_base->Offsets =
+            prev->Offsets ? Copies.back().data() + DBCount : NULL;
+    }
+}
+
+bool BP5Deserializer::MetaDataHasNewVariables(void *MetadataBlock)
+{
+    FFSTypeHandle FFSformat =
+        FFSTypeHandle_from_encode(ReaderFFSContext, (char *)MetadataBlock);
+    if (!FFSformat)
+    {
+        throw std::logic_error("Internal error or file corruption, no know "
+                               "format for Metadata Block");
+    }
+    ControlInfo *Control = GetPriorControl(FMFormat_of_original(FFSformat));
+    if (!Control)
+    {
+        Control = BuildControl(FMFormat_of_original(FFSformat));
+    }
+    for (int i = 0; i < Control->ControlCount; i++)
+    {
+        if (!Control->Controls[i].VarRec->Variable)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BP5Deserializer::SetLazyStepCounts(size_t StepCount)
+{
+    for (auto &Rec : VarByName)
+    {
+        BP5VarRec *VarRec = Rec.second;
+        if (VarRec->Variable && (VarRec->FirstTSSeen < StepCount))
+        {
+            static_cast<VariableBase *>(VarRec->Variable)
+                ->m_AvailableStepsCount = StepCount - VarRec->FirstTSSeen;
+        }
+    }
+}
+
+bool BP5Deserializer::VarShape(const VariableBase &Var, const size_t Step,
+                               Dims &Shape)
+{
+    if (!m_LazyMetadata || (Step >= MetadataBaseArray.size()))
+    {
+        return false;
+    }
+    BP5VarRec *VarRec = LookupVarByKey((void *)&Var);
+    if (!VarRec || (VarRec->OrigShapeID != ShapeID::GlobalArray))
+    {
+        return false;
+    }
+    EnsureStepInstalled(Step);
+    const size_t writerCohortSize = WriterCohortSize(Step);
+    for (size_t WriterRank = 0; WriterRank < writerCohortSize; WriterRank++)
+    {
+        MetaArrayRec *meta_base =
+            (MetaArrayRec *)GetMetadataBase(VarRec, Step, WriterRank);
+        if (meta_base && meta_base->Shape)
+        {
+            Shape.assign(meta_base->Shape, meta_base->Shape + meta_base->Dims);
+            return true;
+        }
+    }
+    return false;
+}
+
 void *BP5Deserializer::GetMetadataBase(BP5VarRec *VarRec, size_t Step,
                                        size_t WriterRank)
 {
@@ -1600,6 +1960,7 @@ MinVarInfo *BP5Deserializer::MinBlocksInfo(const VariableBase &Var, size_t Step)
 {
     BP5VarRec *VarRec = LookupVarByKey((void *)&Var);
 
+    EnsureStepInstalled(Step);
     MinVarInfo *MV = new MinVarInfo(VarRec->DimCount, VarRec->GlobalDims);
 
     const size_t writerCohortSize = WriterCohortSize(Step);
@@ -1851,12 +2212,13 @@ bool BP5Deserializer::VariableMinMax(const VariableBase &Var, const size_t Step,
     if (Step == DefaultSizeT)
     {
         StartStep = 0;
-        StopStep = m_ControlArray.size();
+        StopStep = m_WriterCohortSize.size();
         if (!m_RandomAccessMode)
             StopStep = 1;
     }
     for (size_t RelStep = StartStep; RelStep < StopStep; RelStep++)
     {
+        EnsureStepInstalled(RelStep);
         if ((VarRec->OrigShapeID == ShapeID::LocalArray) ||
             (VarRec->OrigShapeID == ShapeID::GlobalArray))
         {
@@ -18,6 +18,10 @@
 #include "ffs.h"
 #include "fm.h"
 
+#include <functional>
+#include <list>
+#include <mutex>
+
 #ifdef _WIN32
 #pragma warning(disable : 4250)
 #endif
@@ -46,6 +50,11 @@ public:
         size_t ReadLength;
         char *DestinationAddr;
         void *Internal;
+        size_t ReqIndex; // index of the pending Get this read serves
+        size_t BlockID;  // block number within the writer's variable
+        // DestinationAddr is owned by the engine (e.g. points into a file
+        // mapping) and is not freed by FinalizeGets
+        bool Borrowed;
     };
     void InstallMetaMetaData(MetaMetaInfoBlock &MMList);
     void InstallMetaData(void *MetadataBlock, size_t BlockLen,
@@ -58,7 +67,11 @@ public:
     bool QueueGetSingle(core::VariableBase &variable, void *DestData,
                         size_t Step);
 
-    std::vector<ReadRequest> GenerateReadRequests();
+    /** With doAllocTempBuffers false DestinationAddr is left nullptr and
+     * the caller sets it, either to malloc'ed memory or, with Borrowed, to
+     * memory that stays valid until FinalizeGets returns */
+    std::vector<ReadRequest>
+    GenerateReadRequests(const bool doAllocTempBuffers = true);
     void FinalizeGets(std::vector<ReadRequest>);
 
     MinVarInfo *AllRelativeStepsMinBlocksInfo(const VariableBase &var);
@@ -70,6 +83,29 @@ public:
     const bool m_WriterIsRowMajor;
     const bool m_ReaderIsRowMajor;
     core::Engine *m_Engine = NULL;
+    /* number of threads decompressing and copying blocks in FinalizeGets */
+    size_t m_Threads = 1;
+    /* metadata blocks handed in are shared with other processes and must
+     * not be modified, they are decoded from a private copy */
+    bool m_ReadOnlyMetadata = false;
+
+    /* Lazy metadata in random access mode: the metadata of a step is
+     * installed by calling StepLoader the first time the step is touched,
+     * and at most MaxSteps steps (0 = unlimited) stay installed, least
+     * recently used steps are uninstalled first. */
+    void SetLazyMetadata(size_t MaxSteps,
+                         std::function<void(size_t)> StepLoader);
+    void EnsureStepInstalled(size_t Step);
+    /* true if the metadata block's format contains variables that have not
+     * been set up yet, checked without decoding the block */
+    bool MetaDataHasNewVariables(void *MetadataBlock);
+    /* in lazy mode, after Open: which steps write a variable is only known
+     * once a step is decoded, so each variable counts every step from the
+     * one that introduced it to the last of the StepCount steps */
+    void SetLazyStepCounts(size_t StepCount);
+    /* in lazy mode, the Shape of a global array in an absolute Step,
+     * installing the step if needed; false if not known here */
+    bool VarShape(const VariableBase &Var, const size_t Step, Dims &Shape);
 
 private:
     size_t m_VarCount = 0;
@@ -85,11 +121,15 @@ private:
         int ElementSize = 0;
         size_t MinMaxOffset = SIZE_MAX;
         size_t *GlobalDims = NULL;
+        std::vector<size_t> GlobalDimsCopy; // owns GlobalDims in lazy mode
         size_t LastTSAdded = SIZE_MAX;
         size_t FirstTSSeen = SIZE_MAX;
         size_t LastShapeAdded = SIZE_MAX;
         std::vector<size_t> PerWriterMetaFieldOffset;
         std::vector<size_t> PerWriterBlockStart;
+        // streaming mode, delta encoded metadata: Count and Offsets of the
+        // last record of each writer
+        std::vector<std::vector<size_t>> PerWriterDims;
     };
 
     struct ControlStruct
@@ -104,6 +144,7 @@ private:
     struct ControlInfo
     {
         FMFormat Format;
+        bool DeltaEncoded; // writer used MetadataDeltaInterval
         int ControlCount;
         struct ControlInfo *Next;
         std::vector<size_t> *MetaFieldOffset;
@@ -151,6 +192,32 @@ private:
     // address of the metadata
     std::vector<std::vector<void *> *> MetadataBaseArray;
 
+    bool m_LazyMetadata = false;
+    size_t m_MaxInstalledSteps = 0;
+    std::function<void(size_t)> m_StepLoader;
+    // installed steps in lazy mode, most recently used first
+    std::list<size_t> m_InstalledSteps;
+    // in lazy mode metadata is decoded from a private copy so that a step
+    // can be uninstalled and decoded again later, blocks that cannot be
+    // decoded in place are decoded into buffers kept here as well
+    std::unordered_map<size_t, std::vector<std::vector<char>>>
+        m_StepMetadataCopies;
+    void UninstallStep(size_t Step);
+    // set by InheritDims when the step before the one being installed is
+    // needed but not installed
+    bool m_MissingPreviousStep = false;
+    FFSTypeHandle MetaDataFormat(char *MetadataBlock);
+    // in lazy mode, Count and Offsets that delta encoded records of a step
+    // took from the step before
+    std::unordered_map<size_t, std::vector<std::vector<size_t>>>
+        m_StepDimsCopies;
+
+    /* A delta encoded array record with DBCount 0 has the same blocks as
+     * the writer's record of the previous step, point its Count and
+     * Offsets there */
+    void InheritDims(BP5VarRec *VarRec, MetaArrayRec *meta_base,
+                     size_t WriterRank, size_t Step);
+
     ControlInfo *ControlBlocks = nullptr;
     ControlInfo *GetPriorControl(FMFormat Format);
     ControlInfo *BuildControl(FMFormat Format);
@@ -212,6 +279,16 @@ private:
     };
     std::vector<BP5ArrayRequest> PendingRequests;
     bool NeedWriter(BP5ArrayRequest Req, size_t i, size_t &NodeFirst);
+    size_t BlockDataLength(const BP5VarRec *VarRec,
+                           const MetaArrayRec *writer_meta_base, size_t Block);
+    /* decompress (if needed) and scatter one block into the Get destination
+     */
+    void FinalizeGet(const ReadRequest &Read,
+                     std::vector<char> &DecompressBuffer);
+    /* per-thread decompression buffers, reused across blocks and steps */
+    std::vector<std::vector<char>> m_DecompressBuffers;
+    /* held while decompressing with an operator that is not thread safe */
+    std::mutex m_OperatorMutex;
     void *GetMetadataBase(BP5VarRec *VarRec, size_t Step, size_t WriterRank);
     size_t CurTimestep = 0;
 };
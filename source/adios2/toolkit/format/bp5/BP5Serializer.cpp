@@ -12,11 +12,14 @@
 #include "adios2/core/VariableBase.h"
 #include "adios2/helper/adiosFunctions.h"
 #include "adios2/helper/adiosMemory.h"
+#include "adios2/operator/OperatorFactory.h"
 #include "adios2/toolkit/format/buffer/ffs/BufferFFS.h"
 
 #include <stddef.h> // max_align_t
 
+#include <atomic>
 #include <cstring>
+#include <future>
 
 #include "BP5Serializer.h"
 
@@ -81,15 +84,12 @@ void BP5Serializer::Init()
 }
 BP5Serializer::BP5WriterRec BP5Serializer::LookupWriterRec(void *Key)
 {
-    for (int i = 0; i < Info.RecCount; i++)
+    auto it = Info.RecIndex.find(Key);
+    if (it == Info.RecIndex.end())
     {
-        if (Info.RecList[i].Key == Key)
-        {
-            return &Info.RecList[i];
-        }
+        return NULL;
     }
-
-    return NULL;
+    return &Info.RecList[it->second];
 }
 
 void BP5Serializer::RecalcMarshalStorageSize()
@@ -425,6 +425,7 @@ BP5Serializer::CreateWriterRec(void *Variable, const char *Name, DataType Type,
     if (Type == DataType::String)
         ElemSize = sizeof(char *);
     Rec->Key = Variable;
+    Info.RecIndex[Variable] = Info.RecCount;
     Rec->FieldID = Info.RecCount;
     Rec->DimCount = DimCount;
     Rec->Type = (int)Type;
@@ -548,29 +549,123 @@ size_t BP5Serializer::CalcSize(const size_t Count, const size_t *Vals)
 
 void BP5Serializer::PerformPuts()
 {
-    //  Dump data for externs into iovec
-    DumpDeferredBlocks();
+    //  Copy the deferred blocks into the buffer, the application may
+    //  modify its data after PerformPuts
+    DumpDeferredBlocks(true);
 
     CurDataBuffer->CopyExternalToInternal();
 }
 
-void BP5Serializer::DumpDeferredBlocks(bool forceCopyDeferred)
+void BP5Serializer::CompressDeferredBlocks()
 {
-    for (auto &Def : DeferredExterns)
+    if (DeferredCompressions.empty())
     {
-        MetaArrayRec *MetaEntry =
-            (MetaArrayRec *)((char *)(MetadataBuf) + Def.MetaOffset);
-        size_t DataOffset =
+        return;
+    }
+
+    /* the blocks of one operator object are compressed in order by a single
+     * worker, operators are not required to be reentrant, and the blocks of
+     * all operators that are not thread safe share one worker */
+    std::vector<std::vector<DeferredCompression *>> Groups;
+    std::unordered_map<void *, size_t> GroupIndex;
+    for (auto &Def : DeferredCompressions)
+    {
+        void *Key = core::OperatorIsThreadSafe(Def.Op->m_TypeString)
+                        ? static_cast<void *>(Def.Op)
+                        : nullptr;
+        auto it = GroupIndex.find(Key);
+        if (it == GroupIndex.end())
+        {
+            it = GroupIndex.emplace(Key, Groups.size()).first;
+            Groups.emplace_back();
+        }
+        Groups[it->second].push_back(&Def);
+    }
+
+    std::atomic<size_t> NextGroup(0);
+    auto lf_Compress = [&]() {
+        size_t g;
+        while ((g = NextGroup++) < Groups.size())
+        {
+            for (auto Def : Groups[g])
+            {
+                Def->Compressed.resize(Def->AllocSize);
+                const size_t CompressedSize = Def->Op->Operate(
+                    (const char *)Def->Data, Def->Offsets, Def->Count,
+                    Def->Type, Def->Compressed.data());
+                Def->Compressed.resize(CompressedSize);
+            }
+        }
+    };
+
+    const size_t nThreads =
+        std::min(static_cast<size_t>(m_CompressionThreads), Groups.size());
+    std::vector<std::future<void>> futures;
+    for (size_t tid = 1; tid < nThreads; tid++)
+    {
+        futures.push_back(std::async(std::launch::async, lf_Compress));
+    }
+
+    std::exception_ptr Error;
+    try
+    {
+        lf_Compress();
+    }
+    catch (...)
+    {
+        NextGroup = Groups.size();
+        Error = std::current_exception();
+    }
+    for (auto &f : futures)
+    {
+        try
+        {
+            f.get();
+        }
+        catch (...)
+        {
+            if (!Error)
+            {
+                Error = std::current_exception();
+            }
+        }
+    }
+    if (Error)
+    {
+        DeferredCompressions.clear();
+        std::rethrow_exception(Error);
+    }
+
+    for (auto &Def : DeferredCompressions)
+    {
+        MetaArrayRecOperator *OpEntry =
+            (MetaArrayRecOperator *)((char *)(MetadataBuf) + Def.MetaOffset);
+        OpEntry->DataLocation[Def.BlockID] =
             m_PriorDataBufferSizeTotal +
-            CurDataBuffer->AddToVec(Def.DataSize, Def.Data, Def.AlignReq,
-                                    forceCopyDeferred);
-        MetaEntry->DataLocation[Def.BlockID] = DataOffset;
+            CurDataBuffer->AddToVec(Def.Compressed.size(),
+                                    Def.Compressed.data(), Def.ElemSize, true);
+        OpEntry->DataLengths[Def.BlockID] = Def.Compressed.size();
     }
-    DeferredExterns.clear();
+    DeferredCompressions.clear();
+}
+
+static bool HasMinMax(const DataType Type)
+{
+#define pertype(T, N)                                                          \
+    if (Type == helper::GetDataType<T>())                                      \
+    {                                                                          \
+        return true;                                                           \
+    }
+    ADIOS2_FOREACH_MINMAX_STDTYPE_2ARGS(pertype)
+#undef pertype
+    return false;
 }
 
+/* With a Destination the data is copied there in the same pass (host memory
+ * only) */
 static void GetMinMax(const void *Data, size_t ElemCount, const DataType Type,
-                      MinMaxStruct &MinMax, MemorySpace MemSpace)
+                      MinMaxStruct &MinMax, MemorySpace MemSpace,
+                      unsigned int Threads, void *Destination = nullptr)
 {
     MinMax.Init(Type);
     if (ElemCount == 0)
@@ -594,14 +689,64 @@ static void GetMinMax(const void *Data, size_t ElemCount, const DataType Type,
 #define pertype(T, N)                                                          \
     else if (Type == helper::GetDataType<T>())                                 \
     {                                                                          \
-        const T *values = (const T *)Data;                                     \
-        auto res = std::minmax_element(values, values + ElemCount);            \
-        MinMax.MinUnion.field_##N = *res.first;                                \
-        MinMax.MaxUnion.field_##N = *res.second;                               \
+        helper::CopyGetMinMaxThreads((const T *)Data, ElemCount,               \
+                                     (T *)Destination,                         \
+                                     MinMax.MinUnion.field_##N,                \
+                                     MinMax.MaxUnion.field_##N, Threads);      \
     }
     ADIOS2_FOREACH_MINMAX_STDTYPE_2ARGS(pertype)
 }
 
+void BP5Serializer::DumpDeferredBlocks(bool forceCopyDeferred)
+{
+    CompressDeferredBlocks();
+    for (auto &Def : DeferredExterns)
+    {
+        MetaArrayRec *MetaEntry =
+            (MetaArrayRec *)((char *)(MetadataBuf) + Def.MetaOffset);
+        size_t DataOffset;
+        if (Def.MinMaxOffset == SIZE_MAX)
+        {
+            DataOffset = m_PriorDataBufferSizeTotal +
+                         CurDataBuffer->AddToVec(Def.DataSize, Def.Data,
+                                                 Def.AlignReq,
+                                                 forceCopyDeferred);
+        }
+        else
+        {
+            /* statistics were left for now, a block that is copied gets
+             * them while copying */
+            const size_t ElemCount = Def.DataSize / Def.AlignReq;
+            MinMaxStruct MinMax;
+            if (forceCopyDeferred)
+            {
+                BufferV::BufferPos pos =
+                    CurDataBuffer->Allocate(Def.DataSize, Def.AlignReq);
+                DataOffset = m_PriorDataBufferSizeTotal + pos.globalPos;
+                GetMinMax(Def.Data, ElemCount, Def.Type, MinMax,
+                          MemorySpace::Host, m_StatsThreads,
+                          GetPtr(pos.bufferIdx, pos.posInBuffer));
+            }
+            else
+            {
+                GetMinMax(Def.Data, ElemCount, Def.Type, MinMax,
+                          MemorySpace::Host, m_StatsThreads);
+                DataOffset = m_PriorDataBufferSizeTotal +
+                             CurDataBuffer->AddToVec(Def.DataSize, Def.Data,
+                                                     Def.AlignReq, false);
+            }
+            char *MinMaxes =
+                *(char **)(((char *)MetaEntry) + Def.MinMaxOffset);
+            memcpy(MinMaxes + 2 * Def.BlockID * Def.AlignReq,
+                   &MinMax.MinUnion, Def.AlignReq);
+            memcpy(MinMaxes + (2 * Def.BlockID + 1) * Def.AlignReq,
+                   &MinMax.MaxUnion, Def.AlignReq);
+        }
+        MetaEntry->DataLocation[Def.BlockID] = DataOffset;
+    }
+    DeferredExterns.clear();
+}
+
 void BP5Serializer::Marshal(void *Variable, const char *Name,
                             const DataType Type, size_t ElemSize,
                             size_t DimCount, const size_t *Shape,
@@ -646,6 +791,12 @@ void BP5Serializer::Marshal(void *Variable, const char *Name,
         DeferAddToVec = false;
     }
 
+    /* a deferred put with an operator can be compressed later together
+     * with the other blocks of the step */
+    const bool DeferCompression =
+        m_DeferredCompression && !Sync && !Span && Rec->OperatorType &&
+        (VB->m_MemorySpace == MemorySpace::Host);
+
     MBase = (struct BP5MetadataInfoStruct *)MetadataBuf;
     int AlreadyWritten = BP5BitfieldTest(MBase, Rec->FieldID);
     BP5BitfieldSet(MBase, Rec->FieldID);
@@ -677,15 +828,56 @@ void BP5Serializer::Marshal(void *Variable, const char *Name,
                 "BP5Serializer:: Marshall without Prior Init");
         }
 
+        /* a block that is copied now gets its statistics computed while
+         * copying, so it goes through memory once */
+        const bool CopyWithMinMax =
+            (m_StatsLevel > 0) && !Span && !Rec->OperatorType &&
+            !DeferAddToVec && (VB->m_MemorySpace == MemorySpace::Host) &&
+            (ElemCount > 0) && HasMinMax((DataType)Rec->Type);
+
+        DeferredCompression Compression;
+        Compression.MetaOffset = Rec->MetaOffset;
+
+        /* a deferred block gets its statistics in DumpDeferredBlocks(),
+         * together with the copy if it is copied there */
+        const bool DeferMinMax =
+            (m_StatsLevel > 0) && DeferAddToVec &&
+            (VB->m_MemorySpace == MemorySpace::Host) && (ElemCount > 0) &&
+            HasMinMax((DataType)Rec->Type);
+
         MinMaxStruct MinMax;
         MinMax.Init(Type);
-        if ((m_StatsLevel > 0) && !Span)
+        if ((m_StatsLevel > 0) && !Span && !CopyWithMinMax && !DeferMinMax)
         {
             GetMinMax(Data, ElemCount, (DataType)Rec->Type, MinMax,
-                      VB->m_MemorySpace);
+                      VB->m_MemorySpace, m_StatsThreads);
         }
 
-        if (Rec->OperatorType)
+        if (CopyWithMinMax)
+        {
+            BufferV::BufferPos pos =
+                CurDataBuffer->Allocate(ElemCount * ElemSize, ElemSize);
+            void *Destination = GetPtr(pos.bufferIdx, pos.posInBuffer);
+            DataOffset = m_PriorDataBufferSizeTotal + pos.globalPos;
+            GetMinMax(Data, ElemCount, (DataType)Rec->Type, MinMax,
+                      VB->m_MemorySpace, m_StatsThreads, Destination);
+        }
+        else if (DeferCompression)
+        {
+            /* compressed on a worker in DumpDeferredBlocks(), which patches
+             * DataLocation and DataLengths */
+            Compression.Data = Data;
+            Compression.Op = VB->m_Operations[0].get();
+            Compression.Type = (DataType)Rec->Type;
+            Compression.ElemSize = ElemSize;
+            Compression.AllocSize = ElemCount * ElemSize + 100;
+            for (size_t i = 0; i < DimCount; i++)
+            {
+                Compression.Count.push_back(Count[i]);
+                Compression.Offsets.push_back(Offsets[i]);
+            }
+        }
+        else if (Rec->OperatorType)
         {
             std::string compressionMethod = Rec->OperatorType;
             std::transform(compressionMethod.begin(), compressionMethod.end(),
@@ -756,10 +948,21 @@ void BP5Serializer::Marshal(void *Variable, const char *Name,
             }
             if (DeferAddToVec)
             {
-                DeferredExtern rec = {Rec->MetaOffset, 0, Data,
-                                      ElemCount * ElemSize, ElemSize};
+                DeferredExtern rec = {Rec->MetaOffset,
+                                      0,
+                                      Data,
+                                      ElemCount * ElemSize,
+                                      ElemSize,
+                                      (DataType)Rec->Type,
+                                      DeferMinMax ? Rec->MinMaxOffset
+                                                  : SIZE_MAX};
                 DeferredExterns.push_back(rec);
             }
+            if (DeferCompression)
+            {
+                Compression.BlockID = 0;
+                DeferredCompressions.push_back(std::move(Compression));
+            }
         }
         else
         {
@@ -805,9 +1008,15 @@ void BP5Serializer::Marshal(void *Variable, const char *Name,
             }
             if (DeferAddToVec)
             {
-                DeferredExterns.push_back({Rec->MetaOffset,
-                                           MetaEntry->BlockCount - 1, Data,
-                                           ElemCount * ElemSize, ElemSize});
+                DeferredExterns.push_back(
+                    {Rec->MetaOffset, MetaEntry->BlockCount - 1, Data,
+                     ElemCount * ElemSize, ElemSize, (DataType)Rec->Type,
+                     DeferMinMax ? Rec->MinMaxOffset : SIZE_MAX});
+            }
+            if (DeferCompression)
+            {
+                Compression.BlockID = MetaEntry->BlockCount - 1;
+                DeferredCompressions.push_back(std::move(Compression));
             }
             if (Offsets)
                 MetaEntry->Offsets = AppendDims(
@@ -911,7 +1120,9 @@ BP5Serializer::TimestepInfo BP5Serializer::CloseTimestep(int timestep,
             {"complex4", fcomplex_field_list, sizeof(fcomplex_struct), NULL},
             {"complex8", dcomplex_field_list, sizeof(dcomplex_struct), NULL},
             {NULL, NULL, 0, NULL}};
-        struct_list[0].format_name = "MetaData";
+        // the reader recognizes delta encoded records by the format name
+        struct_list[0].format_name =
+            m_MetadataDeltaInterval ? "MetaDataDelta" : "MetaData";
         struct_list[0].field_list = Info.MetaFields;
         struct_list[0].struct_size =
             FMstruct_size_field_list(Info.MetaFields, sizeof(char *));
@@ -972,6 +1183,11 @@ BP5Serializer::TimestepInfo BP5Serializer::CloseTimestep(int timestep,
 
     MBase->DataBlockSize += m_PriorDataBufferSizeTotal;
 
+    if (m_MetadataDeltaInterval)
+    {
+        DeltaEncodeDims();
+    }
+
     void *MetaDataBlock = FFSencode(MetaEncodeBuffer, Info.MetaFormat,
                                     MetadataBuf, &MetaDataSize);
     BufferFFS *Metadata =
@@ -1020,6 +1236,52 @@ BP5Serializer::TimestepInfo BP5Serializer::CloseTimestep(int timestep,
     return Ret;
 }
 
+void BP5Serializer::DeltaEncodeDims()
+{
+    struct BP5MetadataInfoStruct *MBase =
+        (struct BP5MetadataInfoStruct *)MetadataBuf;
+    const bool Full = (m_StepsSinceFullMetadata == 0);
+    m_StepsSinceFullMetadata =
+        (m_StepsSinceFullMetadata + 1) % m_MetadataDeltaInterval;
+    m_PreviousDims.resize(Info.RecCount);
+
+    std::vector<size_t> Dims;
+    for (int i = 0; i < Info.RecCount; i++)
+    {
+        BP5WriterRec Rec = &Info.RecList[i];
+        std::vector<size_t> &Previous = m_PreviousDims[i];
+        if ((Rec->DimCount == 0) || !BP5BitfieldTest(MBase, Rec->FieldID))
+        {
+            Previous.clear();
+            continue;
+        }
+        MetaArrayRec *MetaEntry =
+            (MetaArrayRec *)((char *)(MetadataBuf) + Rec->MetaOffset);
+
+        Dims.clear();
+        Dims.push_back(MetaEntry->BlockCount);
+        Dims.insert(Dims.end(), MetaEntry->Count,
+                    MetaEntry->Count + MetaEntry->DBCount);
+        if (MetaEntry->Offsets)
+        {
+            Dims.insert(Dims.end(), MetaEntry->Offsets,
+                        MetaEntry->Offsets + MetaEntry->DBCount);
+        }
+        if (Full || (Dims != Previous))
+        {
+            Previous.swap(Dims);
+            continue;
+        }
+        /* same blocks as in the previous step, the reader takes Count and
+         * Offsets from there. DBCount 0 with BlockCount > 0 marks this. */
+        free(MetaEntry->Count);
+        free(MetaEntry->Offsets);
+        MetaEntry->Count = NULL;
+        MetaEntry->Offsets = NULL;
+        MetaEntry->DBCount = 0;
+    }
+}
+
 std::vector<char> BP5Serializer::CopyMetadataToContiguous(
     const std::vector<BP5Base::MetaMetaInfoBlock> NewMetaMetaBlocks,
     const format::Buffer *MetaEncodeBuffer,
@@ -1102,14 +1364,16 @@ std::vector<core::iovec> BP5Serializer::BreakoutContiguousMetadata(
     std::vector<char> *Aggregate, const std::vector<size_t> Counts,
     std::vector<MetaMetaInfoBlock> &UniqueMetaMetaBlocks,
     std::vector<core::iovec> &AttributeBlocks, std::vector<uint64_t> &DataSizes,
-    std::vector<uint64_t> &WriterDataPositions) const
+    std::vector<uint64_t> &WriterDataPositions,
+    const std::vector<size_t> &BlockRanks) const
 {
     size_t Position = 0;
-    std::vector<core::iovec> MetadataBlocks;
-    MetadataBlocks.reserve(Counts.size());
+    std::vector<core::iovec> MetadataBlocks(Counts.size());
+    AttributeBlocks.resize(Counts.size());
     DataSizes.resize(Counts.size());
-    for (size_t Rank = 0; Rank < Counts.size(); Rank++)
+    for (size_t Block = 0; Block < Counts.size(); Block++)
     {
+        const size_t Rank = BlockRanks.empty() ? Block : BlockRanks[Block];
         int32_t NMMBCount;
         helper::CopyFromBuffer(*Aggregate, Position, &NMMBCount);
         for (int i = 0; i < NMMBCount; i++)
@@ -1140,11 +1404,11 @@ std::vector<core::iovec> BP5Serializer::BreakoutContiguousMetadata(
         }
         uint64_t MEBSize;
         helper::CopyFromBuffer(*Aggregate, Position, &MEBSize);
-        MetadataBlocks.push_back({Aggregate->data() + Position, MEBSize});
+        MetadataBlocks[Rank] = {Aggregate->data() + Position, MEBSize};
         Position += MEBSize;
         uint64_t AEBSize;
         helper::CopyFromBuffer(*Aggregate, Position, &AEBSize);
-        AttributeBlocks.push_back({Aggregate->data() + Position, AEBSize});
+        AttributeBlocks[Rank] = {Aggregate->data() + Position, AEBSize};
         Position += AEBSize;
         helper::CopyFromBuffer(*Aggregate, Position, &DataSizes[Rank]);
         helper::CopyFromBuffer(*Aggregate, Position,
@@ -1153,6 +1417,60 @@ std::vector<core::iovec> BP5Serializer::BreakoutContiguousMetadata(
     return MetadataBlocks;
 }
 
+std::vector<char>
+BP5Serializer::DeduplicateContiguousMetadata(const std::vector<char> &Aggregate,
+                                             std::vector<size_t> &Counts) const
+{
+    std::vector<char> Ret;
+    Ret.reserve(Aggregate.size());
+    std::vector<std::pair<const char *, uint64_t>> SeenIDs;
+    size_t Position = 0;
+    for (auto &Count : Counts)
+    {
+        const size_t BlockEnd = Position + Count;
+        const size_t RetStart = Ret.size();
+        int32_t NMMBCount;
+        helper::CopyFromBuffer(Aggregate, Position, &NMMBCount);
+        int32_t KeptCount = 0;
+        const size_t CountPosition = Ret.size();
+        Ret.resize(Ret.size() + sizeof(KeptCount));
+        for (int i = 0; i < NMMBCount; i++)
+        {
+            const size_t EntryStart = Position;
+            uint64_t IDLen;
+            uint64_t InfoLen;
+            helper::CopyFromBuffer(Aggregate, Position, &IDLen);
+            helper::CopyFromBuffer(Aggregate, Position, &InfoLen);
+            const char *ID = Aggregate.data() + Position;
+            Position += IDLen + InfoLen;
+            bool Found = false;
+            for (auto &o : SeenIDs)
+            {
+                if ((o.second == IDLen) &&
+                    (std::memcmp(o.first, ID, IDLen) == 0))
+                {
+                    Found = true;
+                    break;
+                }
+            }
+            if (!Found)
+            {
+                SeenIDs.push_back({ID, IDLen});
+                Ret.insert(Ret.end(), Aggregate.begin() + EntryStart,
+                           Aggregate.begin() + Position);
+                KeptCount++;
+            }
+        }
+        std::memcpy(Ret.data() + CountPosition, &KeptCount, sizeof(KeptCount));
+        // metadata, attributes, data size and position are unchanged
+        Ret.insert(Ret.end(), Aggregate.begin() + Position,
+                   Aggregate.begin() + BlockEnd);
+        Position = BlockEnd;
+        Count = Ret.size() - RetStart;
+    }
+    return Ret;
+}
+
 void *BP5Serializer::GetPtr(int bufferIdx, size_t posInBuffer)
 {
     return CurDataBuffer->GetPtr(bufferIdx, posInBuffer);
@@ -17,6 +17,8 @@
 #include "atl.h"
 #include "ffs.h"
 #include "fm.h"
+
+#include <unordered_map>
 #ifdef _WIN32
 #pragma warning(disable : 4250)
 #endif
@@ -94,12 +96,22 @@ public:
         const format::Buffer *AttributeEncodeBuffer, uint64_t DataSize,
         uint64_t WriterDataPos) const;
 
+    /** Blocks in Aggregate belong to ranks 0..N-1 in order, unless
+     * BlockRanks gives the writer rank of each block */
     std::vector<core::iovec> BreakoutContiguousMetadata(
         std::vector<char> *Aggregate, const std::vector<size_t> Counts,
         std::vector<MetaMetaInfoBlock> &UniqueMetaMetaBlocks,
         std::vector<core::iovec> &AttributeBlocks,
         std::vector<uint64_t> &DataSizes,
-        std::vector<uint64_t> &WriterDataPositions) const;
+        std::vector<uint64_t> &WriterDataPositions,
+        const std::vector<size_t> &BlockRanks = std::vector<size_t>()) const;
+
+    /** Drop the meta-meta blocks of a gathered set of contiguous metadata
+     * blocks that an earlier block in the set already carries. Counts is
+     * updated to the new block sizes. */
+    std::vector<char>
+    DeduplicateContiguousMetadata(const std::vector<char> &Aggregate,
+                                  std::vector<size_t> &Counts) const;
 
     void *GetPtr(int bufferIdx, size_t posInBuffer);
     size_t CalcSize(const size_t Count, const size_t *Vals);
@@ -107,6 +119,16 @@ public:
     size_t DebugGetDataBufferSize() const;
 
     int m_StatsLevel = 1;
+    /* threads computing statistics of large blocks */
+    unsigned int m_StatsThreads = 1;
+    /* compress deferred puts with operators in DumpDeferredBlocks() on up
+     * to m_CompressionThreads threads instead of in Marshal() */
+    bool m_DeferredCompression = false;
+    unsigned int m_CompressionThreads = 1;
+    /* 0: full metadata every step. N > 0: array records whose block counts
+     * and offsets equal those of this rank's previous step leave them out,
+     * every Nth step is stored in full */
+    size_t m_MetadataDeltaInterval = 0;
 
     /* Variables to help appending to existing file */
     size_t m_PreMetaMetadataFileLength = 0;
@@ -130,6 +152,8 @@ private:
     {
         int RecCount = 0;
         BP5WriterRec RecList = NULL;
+        /* index into RecList by Key, RecList moves when it grows */
+        std::unordered_map<void *, size_t> RecIndex;
         FMContext LocalFMContext = {0};
         int MetaFieldCount = 0;
         FMFieldList MetaFields = NULL;
@@ -148,9 +172,28 @@ private:
         const void *Data;
         size_t DataSize;
         size_t AlignReq;
+        DataType Type;
+        // where the block's min/max go, SIZE_MAX if they are already set
+        size_t MinMaxOffset;
     };
     std::vector<DeferredExtern> DeferredExterns;
 
+    struct DeferredCompression
+    {
+        size_t MetaOffset;
+        size_t BlockID;
+        const void *Data;
+        core::Operator *Op;
+        DataType Type;
+        size_t ElemSize;
+        size_t AllocSize;
+        Dims Offsets;
+        Dims Count;
+        std::vector<char> Compressed;
+    };
+    std::vector<DeferredCompression> DeferredCompressions;
+    void CompressDeferredBlocks();
+
     FFSWriterMarshalBase Info;
     void *MetadataBuf = NULL;
     bool NewAttribute = false;
@@ -161,6 +204,13 @@ private:
 
     size_t m_PriorDataBufferSizeTotal = 0;
 
+    /* steps closed since the last step with full metadata */
+    size_t m_StepsSinceFullMetadata = 0;
+    /* per WriterRec, BlockCount followed by the Count and Offsets arrays
+     * stored in the previous step, empty if the variable was not written */
+    std::vector<std::vector<size_t>> m_PreviousDims;
+    void DeltaEncodeDims();
+
     BP5WriterRec LookupWriterRec(void *Key);
     BP5WriterRec CreateWriterRec(void *Variable, const char *Name,
                                  DataType Type, size_t ElemSize,
@@ -0,0 +1,130 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * ChunkPool.cpp
+ *
+ */
+
+#include "ChunkPool.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace adios2
+{
+namespace format
+{
+
+namespace
+{
+constexpr size_t HugePageSize = 2 * 1024 * 1024;
+}
+
+ChunkPool::ChunkPool(const size_t MaxSize, const bool HugePages,
+                     const bool FirstTouch)
+: m_MaxSize(MaxSize), m_HugePages(HugePages), m_FirstTouch(FirstTouch)
+{
+}
+
+ChunkPool::~ChunkPool()
+{
+    for (auto &Idle : m_Idle)
+    {
+        free(Idle.second);
+    }
+}
+
+char *ChunkPool::Acquire(const size_t Size, size_t &Capacity)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        // best fit, but don't hand out a chunk more than twice as large
+        auto it = m_Idle.lower_bound(Size);
+        if ((it != m_Idle.end()) && (it->first / 2 <= Size))
+        {
+            char *Chunk = it->second;
+            Capacity = it->first;
+            m_IdleSize -= it->first;
+            m_Idle.erase(it);
+            return Chunk;
+        }
+    }
+    Capacity = Size;
+    return NewChunk(Size);
+}
+
+void ChunkPool::Release(char *Chunk, const size_t Capacity)
+{
+    if (!Chunk)
+    {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_IdleSize + Capacity <= m_MaxSize)
+        {
+            m_Idle.emplace(Capacity, Chunk);
+            m_IdleSize += Capacity;
+            return;
+        }
+    }
+    free(Chunk);
+}
+
+size_t ChunkPool::IdleSize() noexcept
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_IdleSize;
+}
+
+char *ChunkPool::NewChunk(const size_t Size)
+{
+    char *Chunk = nullptr;
+#ifdef __linux__
+    if (m_HugePages && (Size >= HugePageSize))
+    {
+        void *p = nullptr;
+        if (posix_memalign(&p, HugePageSize, Size) == 0)
+        {
+            Chunk = static_cast<char *>(p);
+#ifdef MADV_HUGEPAGE
+            // advice only, the chunk is still usable if it is refused
+            madvise(p, Size - (Size % HugePageSize), MADV_HUGEPAGE);
+#endif
+        }
+    }
+#endif
+    if (!Chunk)
+    {
+        Chunk = static_cast<char *>(malloc(Size));
+    }
+    if (!Chunk)
+    {
+        throw std::runtime_error("ERROR: ChunkPool failed to allocate " +
+                                 std::to_string(Size) + " bytes\n");
+    }
+    if (m_FirstTouch)
+    {
+#ifdef __linux__
+        const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+        const size_t PageSize = 4096;
+#endif
+        for (size_t pos = 0; pos < Size; pos += PageSize)
+        {
+            Chunk[pos] = 0;
+        }
+    }
+    return Chunk;
+}
+
+} // end namespace format
+} // end namespace adios2
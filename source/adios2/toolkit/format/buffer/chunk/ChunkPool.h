@@ -0,0 +1,66 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * ChunkPool.h : keeps the chunks of ChunkV buffers alive between steps so that
+ * a steady-state writer does not fault in fresh memory every step
+ */
+
+#ifndef ADIOS2_TOOLKIT_FORMAT_BUFFER_CHUNK_CHUNKPOOL_H_
+#define ADIOS2_TOOLKIT_FORMAT_BUFFER_CHUNK_CHUNKPOOL_H_
+
+#include "adios2/common/ADIOSConfig.h"
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+namespace adios2
+{
+namespace format
+{
+
+class ChunkPool
+{
+public:
+    /**
+     * @param MaxSize bytes of idle chunks kept for reuse, chunks released
+     * beyond that are freed
+     * @param HugePages back chunks of 2MB and larger with transparent huge
+     * pages where the OS supports it
+     * @param FirstTouch write to every page of a new chunk in the allocating
+     * thread, so that the pages are faulted in and placed on its NUMA node
+     * right away
+     */
+    ChunkPool(const size_t MaxSize, const bool HugePages = false,
+              const bool FirstTouch = false);
+    ~ChunkPool();
+
+    /** Get a chunk of at least Size bytes, Capacity returns its actual size.
+     * Thread-safe. */
+    char *Acquire(const size_t Size, size_t &Capacity);
+
+    /** Return a chunk obtained from Acquire(). Thread-safe, buffers are
+     * often released by the asynchronous writer thread. */
+    void Release(char *Chunk, const size_t Capacity);
+
+    /** Bytes of idle chunks currently kept */
+    size_t IdleSize() noexcept;
+
+private:
+    const size_t m_MaxSize;
+    const bool m_HugePages;
+    const bool m_FirstTouch;
+
+    std::mutex m_Mutex;
+    /* idle chunks by capacity */
+    std::multimap<size_t, char *> m_Idle;
+    size_t m_IdleSize = 0;
+
+    char *NewChunk(const size_t Size);
+};
+
+} // end namespace format
+} // end namespace adios2
+
+#endif /* ADIOS2_TOOLKIT_FORMAT_BUFFER_CHUNK_CHUNKPOOL_H_ */
@@ -22,17 +22,55 @@ namespace format
 {
 
 ChunkV::ChunkV(const std::string type, const bool AlwaysCopy,
-               const size_t ChunkSize)
-: BufferV(type, AlwaysCopy), m_ChunkSize(ChunkSize)
+               const size_t ChunkSize, ChunkPool *Pool)
+: BufferV(type, AlwaysCopy), m_ChunkSize(ChunkSize), m_Pool(Pool)
 {
 }
 
 ChunkV::~ChunkV()
 {
-    for (const auto &Chunk : m_Chunks)
+    for (std::size_t i = 0; i < m_Chunks.size(); ++i)
     {
-        free((void *)Chunk);
+        if (m_Pool)
+        {
+            m_Pool->Release(m_Chunks[i], m_ChunkCapacities[i]);
+        }
+        else
+        {
+            free((void *)m_Chunks[i]);
+        }
+    }
+}
+
+char *ChunkV::NewChunk(const size_t size)
+{
+    size_t Capacity = size;
+    char *Chunk;
+    if (m_Pool)
+    {
+        Chunk = m_Pool->Acquire(size, Capacity);
+    }
+    else
+    {
+        Chunk = (char *)malloc(size);
     }
+    m_Chunks.push_back(Chunk);
+    m_ChunkCapacities.push_back(Capacity);
+    return Chunk;
+}
+
+void ChunkV::CloseTailChunk()
+{
+    if (!m_Pool)
+    {
+        // realloc down to used size (helpful?) and set size in array
+        m_Chunks.back() = (char *)realloc(m_Chunks.back(), m_TailChunkPos);
+        m_ChunkCapacities.back() = m_TailChunkPos;
+    }
+    // pooled chunks keep their full capacity for the next user
+
+    m_TailChunkPos = 0;
+    m_TailChunk = NULL;
 }
 
 void ChunkV::CopyExternalToInternal()
@@ -49,12 +87,7 @@ void ChunkV::CopyExternalToInternal()
             if (AppendPossible && (m_TailChunkPos + size > m_ChunkSize))
             {
                 // No room in current chunk, close it out
-                // realloc down to used size (helpful?) and set size in array
-                m_Chunks.back() =
-                    (char *)realloc(m_Chunks.back(), m_TailChunkPos);
-
-                m_TailChunkPos = 0;
-                m_TailChunk = NULL;
+                CloseTailChunk();
                 AppendPossible = false;
             }
             if (AppendPossible)
@@ -69,11 +102,7 @@ void ChunkV::CopyExternalToInternal()
             else
             {
                 // We need a new chunk, get the larger of size or m_ChunkSize
-                size_t NewSize = m_ChunkSize;
-                if (size > m_ChunkSize)
-                    NewSize = size;
-                m_TailChunk = (char *)malloc(NewSize);
-                m_Chunks.push_back(m_TailChunk);
+                m_TailChunk = NewChunk(std::max(size, m_ChunkSize));
                 memcpy(m_TailChunk, DataV[i].Base, size);
                 m_TailChunkPos = size;
                 DataV[i] = {false, m_TailChunk, 0, size};
@@ -111,11 +140,7 @@ size_t ChunkV::AddToVec(const size_t size, const void *buf, size_t align,
         if (AppendPossible && (m_TailChunkPos + size > m_ChunkSize))
         {
             // No room in current chunk, close it out
-            // realloc down to used size (helpful?) and set size in array
-            m_Chunks.back() = (char *)realloc(m_Chunks.back(), m_TailChunkPos);
-
-            m_TailChunkPos = 0;
-            m_TailChunk = NULL;
+            CloseTailChunk();
             AppendPossible = false;
         }
         if (AppendPossible)
@@ -128,11 +153,7 @@ size_t ChunkV::AddToVec(const size_t size, const void *buf, size_t align,
         else
         {
             // We need a new chunk, get the larger of size or m_ChunkSize
-            size_t NewSize = m_ChunkSize;
-            if (size > m_ChunkSize)
-                NewSize = size;
-            m_TailChunk = (char *)malloc(NewSize);
-            m_Chunks.push_back(m_TailChunk);
+            m_TailChunk = NewChunk(std::max(size, m_ChunkSize));
             CopyDataToBuffer(size, buf, 0, MemSpace);
             m_TailChunkPos = size;
             VecEntry entry = {false, m_TailChunk, 0, size};
@@ -174,11 +195,7 @@ BufferV::BufferPos ChunkV::Allocate(const size_t size, size_t align)
     if (AppendPossible && (m_TailChunkPos + size > m_ChunkSize))
     {
         // No room in current chunk, close it out
-        // realloc down to used size (helpful?) and set size in array
-        m_Chunks.back() = (char *)realloc(m_Chunks.back(), m_TailChunkPos);
-
-        m_TailChunkPos = 0;
-        m_TailChunk = NULL;
+        CloseTailChunk();
         AppendPossible = false;
     }
 
@@ -193,11 +210,7 @@ BufferV::BufferPos ChunkV::Allocate(const size_t size, size_t align)
     else
     {
         // We need a new chunk, get the larger of size or m_ChunkSize
-        size_t NewSize = m_ChunkSize;
-        if (size > m_ChunkSize)
-            NewSize = size;
-        m_TailChunk = (char *)malloc(NewSize);
-        m_Chunks.push_back(m_TailChunk);
+        m_TailChunk = NewChunk(std::max(size, m_ChunkSize));
         bufferPos = 0;
         m_TailChunkPos = size;
         VecEntry entry = {false, m_TailChunk, 0, size};
@@ -12,6 +12,7 @@
 #include "adios2/core/CoreTypes.h"
 
 #include "adios2/toolkit/format/buffer/BufferV.h"
+#include "adios2/toolkit/format/buffer/chunk/ChunkPool.h"
 
 namespace adios2
 {
@@ -26,7 +27,8 @@ public:
     const size_t m_ChunkSize;
 
     ChunkV(const std::string type, const bool AlwaysCopy = false,
-           const size_t ChunkSize = DefaultBufferChunkSize);
+           const size_t ChunkSize = DefaultBufferChunkSize,
+           ChunkPool *Pool = nullptr);
     virtual ~ChunkV();
 
     virtual std::vector<core::iovec> DataVec() noexcept;
@@ -46,8 +48,14 @@ public:
 
 private:
     std::vector<char *> m_Chunks;
+    std::vector<size_t> m_ChunkCapacities;
+    /* optional, chunks are taken from and returned to it instead of the heap */
+    ChunkPool *m_Pool;
     size_t m_TailChunkPos = 0;
     char *m_TailChunk = NULL;
+
+    char *NewChunk(const size_t size);
+    void CloseTailChunk();
 };
 
 } // end namespace format
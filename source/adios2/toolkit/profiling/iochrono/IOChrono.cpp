@@ -45,6 +45,8 @@ JSONProfiler::JSONProfiler(helper::Comm const &comm) : m_Comm(comm)
     AddTimerWatch("PP");
     // AddTimerWatch("meta_merge");
     AddTimerWatch("meta_gather");
+    AddTimerWatch("meta_gather_node");
+    AddTimerWatch("meta_dedup");
     // AddTimerWatch("meta_ds");
     // AddTimerWatch("meta_s");
     // AddTimerWatch("meta_sort_merge");
@@ -66,6 +66,16 @@ void CP_validateParams(SstStream Stream, SstParams Params, int Writer)
         {
             Params->DataTransport = strdup("rdma");
         }
+        else if ((strcmp(SelectedTransport, "shm") == 0) ||
+                 (strcmp(SelectedTransport, "local") == 0))
+        {
+            Params->DataTransport = strdup("shm");
+        }
+        else
+        {
+            /* e.g. "daos", SelectDP matches it by name */
+            Params->DataTransport = strdup(SelectedTransport);
+        }
         free(SelectedTransport);
     }
     if (Params->ControlTransport == NULL)
@@ -220,6 +230,8 @@ extern void CP_dumpParams(SstStream Stream, struct _SstParams *Params,
     {
         fprintf(stderr, "Param -   AlwaysProvideLatestTimestep=%s\n",
                 Params->AlwaysProvideLatestTimestep ? "True" : "False");
+        fprintf(stderr, "Param -   ShmForceRemote=%s\n",
+                Params->ShmForceRemote ? "True" : "False");
     }
     fprintf(stderr, "Param -   OpenTimeoutSecs=%d (seconds)\n",
             Params->OpenTimeoutSecs);
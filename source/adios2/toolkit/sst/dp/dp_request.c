@@ -0,0 +1,277 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atl.h>
+#include <evpath.h>
+
+#include "sst_data.h"
+
+#include "dp_interface.h"
+#include "dp_request.h"
+#include <adios2-perfstubs-interface.h>
+
+FMField DPReadRequestList[] = {
+    {"Timestep", "integer", sizeof(long), FMOffset(DPReadRequestMsg, Timestep)},
+    {"Offset", "integer", sizeof(size_t), FMOffset(DPReadRequestMsg, Offset)},
+    {"Length", "integer", sizeof(size_t), FMOffset(DPReadRequestMsg, Length)},
+    {"WS_Stream", "integer", sizeof(void *),
+     FMOffset(DPReadRequestMsg, WS_Stream)},
+    {"RS_Stream", "integer", sizeof(void *),
+     FMOffset(DPReadRequestMsg, RS_Stream)},
+    {"RequestingRank", "integer", sizeof(int),
+     FMOffset(DPReadRequestMsg, RequestingRank)},
+    {"NotifyCondition", "integer", sizeof(int),
+     FMOffset(DPReadRequestMsg, NotifyCondition)},
+    {NULL, NULL, 0, 0}};
+
+FMField DPReadReplyList[] = {
+    {"Timestep", "integer", sizeof(long), FMOffset(DPReadReplyMsg, Timestep)},
+    {"RS_Stream", "integer", sizeof(void *),
+     FMOffset(DPReadReplyMsg, RS_Stream)},
+    {"DataLength", "integer", sizeof(size_t),
+     FMOffset(DPReadReplyMsg, DataLength)},
+    {"Data", "char[DataLength]", sizeof(char), FMOffset(DPReadReplyMsg, Data)},
+    {"NotifyCondition", "integer", sizeof(int),
+     FMOffset(DPReadReplyMsg, NotifyCondition)},
+    {NULL, NULL, 0, 0}};
+
+// reader-side routine
+void DP_AddRequestToList(DPCompletionHandle *List, DPCompletionHandle Handle)
+{
+    Handle->Next = *List;
+    *List = Handle;
+}
+
+// reader-side routine
+void DP_RemoveRequestFromList(DPCompletionHandle *List,
+                              DPCompletionHandle Handle)
+{
+    DPCompletionHandle Tmp;
+
+    Tmp = *List;
+    if (*List == Handle)
+    {
+        *List = Handle->Next;
+        return;
+    }
+
+    while (Tmp != NULL && Tmp->Next != Handle)
+    {
+        Tmp = Tmp->Next;
+    }
+
+    if (Tmp == NULL)
+    {
+        return;
+    }
+
+    // Tmp->Next must be the handle to remove
+    Tmp->Next = Tmp->Next->Next;
+}
+
+// reader-side routine, called from the main program
+void DP_SendReadRequest(CP_Services Svcs, CP_PeerCohort PeerCohort,
+                        CMFormat RequestFormat, DPCompletionHandle Handle,
+                        long Timestep, void *WS_Stream, int RequestingRank)
+{
+    struct _DPReadRequestMsg ReadRequestMsg;
+
+    /* memset avoids uninit byte warnings from valgrind */
+    memset(&ReadRequestMsg, 0, sizeof(ReadRequestMsg));
+    ReadRequestMsg.Timestep = Timestep;
+    ReadRequestMsg.Offset = Handle->Offset;
+    ReadRequestMsg.Length = Handle->Length;
+    ReadRequestMsg.WS_Stream = WS_Stream;
+    ReadRequestMsg.RS_Stream = Handle->DPStream;
+    ReadRequestMsg.RequestingRank = RequestingRank;
+    ReadRequestMsg.NotifyCondition = Handle->CMcondition;
+    if (!Svcs->sendToPeer(Handle->CPStream, PeerCohort, Handle->Rank,
+                          RequestFormat, &ReadRequestMsg))
+    {
+        Handle->Failed = 1;
+        CMCondition_signal(Handle->cm, Handle->CMcondition);
+    }
+}
+
+// reader-side routine, called from the main program
+int DP_WaitForCompletion(CP_Services Svcs, pthread_mutex_t *Lock,
+                         DPCompletionHandle *List, DPCompletionHandle Handle)
+{
+    int Ret = 1;
+    if (Handle->CMcondition != -1)
+        Svcs->verbose(
+            Handle->CPStream, DPTraceVerbose,
+            "Waiting for completion of memory read to rank %d, condition %d\n",
+            Handle->Rank, Handle->CMcondition);
+    /*
+     * Wait for the CM condition to be signalled.  If it has been already,
+     * this returns immediately.  Copying the incoming data to the waiting
+     * buffer has been done by the reply handler.
+     */
+    if (Handle->CMcondition != -1)
+        CMCondition_wait(Handle->cm, Handle->CMcondition);
+    if (Handle->Failed)
+    {
+        Svcs->verbose(Handle->CPStream, DPTraceVerbose,
+                      "Remote memory read to rank %d with "
+                      "condition %d has FAILED because of "
+                      "writer failure\n",
+                      Handle->Rank, Handle->CMcondition);
+        Ret = 0;
+    }
+    else
+    {
+        if (Handle->CMcondition != -1)
+            Svcs->verbose(Handle->CPStream, DPTraceVerbose,
+                          "Remote memory read to rank %d with condition %d has "
+                          "completed\n",
+                          Handle->Rank, Handle->CMcondition);
+    }
+    pthread_mutex_lock(Lock);
+    DP_RemoveRequestFromList(List, Handle);
+    pthread_mutex_unlock(Lock);
+    free(Handle);
+    return Ret;
+}
+
+// reader-side routine, called from the network handler (close handler)
+void DP_FailRequestsToRank(CP_Services Svcs, CManager cm, void *CP_Stream,
+                           pthread_mutex_t *Lock, DPCompletionHandle *List,
+                           int FailedRank)
+{
+    DPCompletionHandle Tmp;
+    int FailedSomethingToRank = 0;
+    Svcs->verbose(CP_Stream, DPTraceVerbose,
+                  "Fail pending requests to rank %d on stream %p\n", FailedRank,
+                  CP_Stream);
+    pthread_mutex_lock(Lock);
+    Tmp = *List;
+    while (Tmp != NULL)
+    {
+        if ((Tmp->Failed != 1) && (Tmp->Rank == FailedRank))
+        {
+            FailedSomethingToRank = 1;
+            break;
+        }
+        Tmp = Tmp->Next;
+    }
+    if (FailedSomethingToRank)
+    {
+        Svcs->verbose(CP_Stream, DPTraceVerbose,
+                      "We were waiting for requests on rank %d, fail *all* "
+                      "pending requests on stream %p\n",
+                      FailedRank, CP_Stream);
+        Tmp = *List;
+        while (Tmp != NULL)
+        {
+            if (Tmp->Failed != 1)
+            {
+                Tmp->Failed = 1;
+                Svcs->verbose(Tmp->CPStream, DPTraceVerbose,
+                              "Found a pending remote memory read "
+                              "to writer rank %d, marking as "
+                              "failed and signalling condition %d\n",
+                              Tmp->Rank, Tmp->CMcondition);
+                CMCondition_signal(cm, Tmp->CMcondition);
+            }
+            Tmp = Tmp->Next;
+        }
+    }
+    pthread_mutex_unlock(Lock);
+    Svcs->verbose(CP_Stream, DPPerRankVerbose,
+                  "Done Failing requests to writer %d from stream %p\n",
+                  FailedRank, CP_Stream);
+}
+
+// reader-side routine called by the network handler thread
+void DP_HandleReadReply(CP_Services Svcs, CManager cm, void *CP_Stream,
+                        SstStats Stats, DPReadReplyMsg ReadReplyMsg)
+{
+    PERFSTUBS_TIMER_START_FUNC(timer);
+    DPCompletionHandle Handle = NULL;
+
+    if (CMCondition_has_signaled(cm, ReadReplyMsg->NotifyCondition))
+    {
+        Svcs->verbose(CP_Stream, DPTraceVerbose,
+                      "Got a reply to remote memory "
+                      "read, but the condition is "
+                      "already signalled, returning\n");
+        PERFSTUBS_TIMER_STOP_FUNC(timer);
+        return;
+    }
+    Handle = CMCondition_get_client_data(cm, ReadReplyMsg->NotifyCondition);
+
+    if (!Handle)
+    {
+        Svcs->verbose(
+            CP_Stream, DPCriticalVerbose,
+            "Got a reply to remote memory read, but condition not found\n");
+        PERFSTUBS_TIMER_STOP_FUNC(timer);
+        return;
+    }
+    Svcs->verbose(
+        CP_Stream, DPTraceVerbose,
+        "Got a reply to remote memory read from rank %d, condition is %d\n",
+        Handle->Rank, ReadReplyMsg->NotifyCondition);
+
+    /*
+     * `Handle` contains the full request info and is `client_data`
+     * associated with the CMCondition.  Once we get it, copy the incoming
+     * data to the buffer area given by the request
+     */
+    memcpy(Handle->Buffer, ReadReplyMsg->Data, ReadReplyMsg->DataLength);
+
+    Stats->DataBytesReceived += ReadReplyMsg->DataLength;
+
+    /*
+     * Signal the condition to wake the reader if they are waiting.
+     */
+    CMCondition_signal(cm, ReadReplyMsg->NotifyCondition);
+    PERFSTUBS_TIMER_STOP_FUNC(timer);
+}
+
+// writer side routine, called by the network handler thread
+void DP_SendReadReply(CP_Services Svcs, void *CP_Stream, CMConnection Conn,
+                      CMFormat ReplyFormat, DPReadRequestMsg ReadRequestMsg,
+                      char *Block)
+{
+    struct _DPReadReplyMsg ReadReplyMsg;
+    /* memset avoids uninit byte warnings from valgrind */
+    memset(&ReadReplyMsg, 0, sizeof(ReadReplyMsg));
+    ReadReplyMsg.Timestep = ReadRequestMsg->Timestep;
+    ReadReplyMsg.DataLength = ReadRequestMsg->Length;
+    ReadReplyMsg.Data = Block + ReadRequestMsg->Offset;
+    ReadReplyMsg.RS_Stream = ReadRequestMsg->RS_Stream;
+    ReadReplyMsg.NotifyCondition = ReadRequestMsg->NotifyCondition;
+    Svcs->verbose(CP_Stream, DPTraceVerbose,
+                  "Sending a reply to reader rank %d for remote memory read\n",
+                  ReadRequestMsg->RequestingRank);
+    CMwrite(Conn, ReplyFormat, &ReadReplyMsg);
+}
+
+// writer side routine, called by the network handler thread
+void DP_TimestepNotFound(int WriterRank, DPReadRequestMsg ReadRequestMsg)
+{
+    /*
+     * Shouldn't ever get here because we should never get a request for a
+     * timestep that we don't have.
+     */
+    fprintf(stderr, "\n\n\n\n");
+    fprintf(stderr,
+            "Writer rank %d - Failed to read Timestep %ld, not found.  This is "
+            "an internal inconsistency\n",
+            WriterRank, ReadRequestMsg->Timestep);
+    fprintf(stderr,
+            "Writer rank %d - Request came from rank %d, please report this "
+            "error!\n",
+            WriterRank, ReadRequestMsg->RequestingRank);
+    fprintf(stderr, "\n\n\n\n");
+
+    /*
+     * in the interest of not failing a writer on a reader failure, don't
+     * assert(0) here.  Probably this sort of error should close the link to
+     * a reader though.
+     */
+}
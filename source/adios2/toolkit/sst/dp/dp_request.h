@@ -0,0 +1,105 @@
+#ifndef _DP_REQUEST_H
+#define _DP_REQUEST_H
+
+#include <pthread.h>
+
+#include "dp_interface.h"
+
+/*
+ *  Remote memory reads done with messages over the control plane
+ *  connections: the reader sends a read request to the writer rank, which
+ *  answers with a read reply carrying the data.  This is how the evpath data
+ *  plane moves all data, and how the shm data plane reaches writers that are
+ *  not on its node.
+ *
+ *  Each data plane registers the messages under its own format names (so
+ *  that streams using different data planes can share a CManager) and keeps
+ *  its own handlers, which unpack their stream and call the routines below.
+ */
+
+typedef struct _DPReadRequestMsg
+{
+    long Timestep;
+    size_t Offset;
+    size_t Length;
+    void *WS_Stream;
+    void *RS_Stream;
+    int RequestingRank;
+    int NotifyCondition;
+} * DPReadRequestMsg;
+
+typedef struct _DPReadReplyMsg
+{
+    long Timestep;
+    size_t DataLength;
+    void *RS_Stream;
+    char *Data;
+    int NotifyCondition;
+} * DPReadReplyMsg;
+
+extern FMField DPReadRequestList[];
+extern FMField DPReadReplyList[];
+
+/*
+ * Reader-side state of one remote memory read.  CMcondition is -1 for reads
+ * that completed without a message.
+ */
+typedef struct _DPCompletionHandle
+{
+    int CMcondition;
+    CManager cm;
+    void *CPStream;
+    void *DPStream;
+    void *Buffer;
+    int Failed;
+    int Rank;
+    size_t Offset;
+    size_t Length;
+    struct _DPCompletionHandle *Next;
+} * DPCompletionHandle;
+
+/* the list routines must be called with the data plane stream lock held */
+extern void DP_AddRequestToList(DPCompletionHandle *List,
+                                DPCompletionHandle Handle);
+extern void DP_RemoveRequestFromList(DPCompletionHandle *List,
+                                     DPCompletionHandle Handle);
+
+/*
+ * Sends the read request for Handle (already on the pending requests list)
+ * to writer rank Handle->Rank.  A request that cannot be sent is failed.
+ */
+extern void DP_SendReadRequest(CP_Services Svcs, CP_PeerCohort PeerCohort,
+                               CMFormat RequestFormat,
+                               DPCompletionHandle Handle, long Timestep,
+                               void *WS_Stream, int RequestingRank);
+
+/*
+ * Waits for the reply to Handle (if any), removes it from the pending
+ * requests and frees it.  Returns 0 if the read failed, 1 otherwise.
+ */
+extern int DP_WaitForCompletion(CP_Services Svcs, pthread_mutex_t *Lock,
+                                DPCompletionHandle *List,
+                                DPCompletionHandle Handle);
+
+/* Marks failed all pending requests if one of them is to FailedRank. */
+extern void DP_FailRequestsToRank(CP_Services Svcs, CManager cm,
+                                  void *CP_Stream, pthread_mutex_t *Lock,
+                                  DPCompletionHandle *List, int FailedRank);
+
+/* Copies the data of a read reply to the waiting buffer. */
+extern void DP_HandleReadReply(CP_Services Svcs, CManager cm, void *CP_Stream,
+                               SstStats Stats, DPReadReplyMsg ReadReplyMsg);
+
+/*
+ * Answers a read request with Length bytes at Offset in Block, on
+ * connection Conn.
+ */
+extern void DP_SendReadReply(CP_Services Svcs, void *CP_Stream,
+                             CMConnection Conn, CMFormat ReplyFormat,
+                             DPReadRequestMsg ReadRequestMsg, char *Block);
+
+/* Reports a read request for a timestep the writer does not have. */
+extern void DP_TimestepNotFound(int WriterRank,
+                                DPReadRequestMsg ReadRequestMsg);
+
+#endif /* _DP_REQUEST_H */
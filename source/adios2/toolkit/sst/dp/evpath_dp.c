@@ -11,6 +11,7 @@
 #include "sst_data.h"
 
 #include "dp_interface.h"
+#include "dp_request.h"
 #include <adios2-perfstubs-interface.h>
 
 #if defined(__has_feature)
@@ -71,7 +72,7 @@ typedef struct _Evpath_RS_Stream
     int WriterCohortSize;
     CP_PeerCohort PeerCohort;
     struct _EvpathWriterContactInfo *WriterContactInfo;
-    struct _EvpathCompletionHandle *PendingReadRequests;
+    DPCompletionHandle PendingReadRequests;
 
     /* queued timestep info */
     struct _RSTimestepEntry *QueuedTimesteps;
@@ -153,63 +154,13 @@ typedef struct _EvpathWriterContactInfo
     void *WS_Stream;
 } * EvpathWriterContactInfo;
 
-typedef struct _EvpathReadRequestMsg
-{
-    long Timestep;
-    size_t Offset;
-    size_t Length;
-    void *WS_Stream;
-    void *RS_Stream;
-    int RequestingRank;
-    int NotifyCondition;
-} * EvpathReadRequestMsg;
-
-static FMField EvpathReadRequestList[] = {
-    {"Timestep", "integer", sizeof(long),
-     FMOffset(EvpathReadRequestMsg, Timestep)},
-    {"Offset", "integer", sizeof(size_t),
-     FMOffset(EvpathReadRequestMsg, Offset)},
-    {"Length", "integer", sizeof(size_t),
-     FMOffset(EvpathReadRequestMsg, Length)},
-    {"WS_Stream", "integer", sizeof(void *),
-     FMOffset(EvpathReadRequestMsg, WS_Stream)},
-    {"RS_Stream", "integer", sizeof(void *),
-     FMOffset(EvpathReadRequestMsg, RS_Stream)},
-    {"RequestingRank", "integer", sizeof(int),
-     FMOffset(EvpathReadRequestMsg, RequestingRank)},
-    {"NotifyCondition", "integer", sizeof(int),
-     FMOffset(EvpathReadRequestMsg, NotifyCondition)},
-    {NULL, NULL, 0, 0}};
-
 static FMStructDescRec EvpathReadRequestStructs[] = {
-    {"EvpathReadRequest", EvpathReadRequestList,
-     sizeof(struct _EvpathReadRequestMsg), NULL},
+    {"EvpathReadRequest", DPReadRequestList,
+     sizeof(struct _DPReadRequestMsg), NULL},
     {NULL, NULL, 0, NULL}};
 
-typedef struct _EvpathReadReplyMsg
-{
-    long Timestep;
-    size_t DataLength;
-    void *RS_Stream;
-    char *Data;
-    int NotifyCondition;
-} * EvpathReadReplyMsg;
-
-static FMField EvpathReadReplyList[] = {
-    {"Timestep", "integer", sizeof(long),
-     FMOffset(EvpathReadReplyMsg, Timestep)},
-    {"RS_Stream", "integer", sizeof(void *),
-     FMOffset(EvpathReadReplyMsg, RS_Stream)},
-    {"DataLength", "integer", sizeof(size_t),
-     FMOffset(EvpathReadReplyMsg, DataLength)},
-    {"Data", "char[DataLength]", sizeof(char),
-     FMOffset(EvpathReadReplyMsg, Data)},
-    {"NotifyCondition", "integer", sizeof(int),
-     FMOffset(EvpathReadReplyMsg, NotifyCondition)},
-    {NULL, NULL, 0, 0}};
-
 static FMStructDescRec EvpathReadReplyStructs[] = {
-    {"EvpathReadReply", EvpathReadReplyList, sizeof(struct _EvpathReadReplyMsg),
+    {"EvpathReadReply", DPReadReplyList, sizeof(struct _DPReadReplyMsg),
      NULL},
     {NULL, NULL, 0, NULL}};
 
@@ -384,7 +335,7 @@ static void EvpathReadRequestHandler(CManager cm, CMConnection incoming_conn,
                                      attr_list attrs)
 {
     PERFSTUBS_TIMER_START_FUNC(timer);
-    EvpathReadRequestMsg ReadRequestMsg = (EvpathReadRequestMsg)msg_v;
+    DPReadRequestMsg ReadRequestMsg = (DPReadRequestMsg)msg_v;
     Evpath_WSR_Stream WSR_Stream = ReadRequestMsg->WS_Stream;
 
     Evpath_WS_Stream WS_Stream = WSR_Stream->WS_Stream;
@@ -404,20 +355,8 @@ static void EvpathReadRequestHandler(CManager cm, CMConnection incoming_conn,
     {
         if (tmp->Timestep == ReadRequestMsg->Timestep)
         {
-            struct _EvpathReadReplyMsg ReadReplyMsg;
             CMConnection ReplyConn;
-            /* memset avoids uninit byte warnings from valgrind */
             MarkReadRequest(tmp, WSR_Stream, RequestingRank);
-            memset(&ReadReplyMsg, 0, sizeof(ReadReplyMsg));
-            ReadReplyMsg.Timestep = ReadRequestMsg->Timestep;
-            ReadReplyMsg.DataLength = ReadRequestMsg->Length;
-            ReadReplyMsg.Data = tmp->Data.block + ReadRequestMsg->Offset;
-            ReadReplyMsg.RS_Stream = ReadRequestMsg->RS_Stream;
-            ReadReplyMsg.NotifyCondition = ReadRequestMsg->NotifyCondition;
-            Svcs->verbose(
-                WS_Stream->CP_Stream, DPTraceVerbose,
-                "Sending a reply to reader rank %d for remote memory read\n",
-                RequestingRank);
             ReplyConn = WSR_Stream->ReaderContactInfo[RequestingRank].Conn;
             if (!ReplyConn)
             {
@@ -438,8 +377,10 @@ static void EvpathReadRequestHandler(CManager cm, CMConnection incoming_conn,
                 WSR_Stream->ReaderContactInfo[RequestingRank].Conn = ReplyConn;
             }
             CMFormat Format = WS_Stream->ReadReplyFormat;
+            char *Block = tmp->Data.block;
             pthread_mutex_unlock(&WS_Stream->DataLock);
-            CMwrite(ReplyConn, Format, &ReadReplyMsg);
+            DP_SendReadReply(Svcs, WS_Stream->CP_Stream, ReplyConn, Format,
+                             ReadRequestMsg, Block);
 
             PERFSTUBS_TIMER_STOP_FUNC(timer);
             return;
@@ -447,91 +388,18 @@ static void EvpathReadRequestHandler(CManager cm, CMConnection incoming_conn,
         tmp = tmp->Next;
     }
     pthread_mutex_unlock(&WS_Stream->DataLock);
-    /*
-     * Shouldn't ever get here because we should never get a request for a
-     * timestep that we don't have.
-     */
-    fprintf(stderr, "\n\n\n\n");
-    fprintf(stderr,
-            "Writer rank %d - Failed to read Timestep %ld, not found.  This is "
-            "an internal inconsistency\n",
-            WSR_Stream->WS_Stream->Rank, ReadRequestMsg->Timestep);
-    fprintf(stderr,
-            "Writer rank %d - Request came from rank %d, please report this "
-            "error!\n",
-            WSR_Stream->WS_Stream->Rank, RequestingRank);
-    fprintf(stderr, "\n\n\n\n");
-
-    /*
-     * in the interest of not failing a writer on a reader failure, don't
-     * assert(0) here.  Probably this sort of error should close the link to
-     * a reader though.
-     */
+    DP_TimestepNotFound(WS_Stream->Rank, ReadRequestMsg);
     PERFSTUBS_TIMER_STOP_FUNC(timer);
 }
 
-typedef struct _EvpathCompletionHandle
-{
-    int CMcondition;
-    CManager cm;
-    void *CPStream;
-    void *DPStream;
-    void *Buffer;
-    int Failed;
-    int Rank;
-    long Offset;
-    long Length;
-    struct _EvpathCompletionHandle *Next;
-} * EvpathCompletionHandle;
-
 // reader-side routine called by the network handler thread
 static void EvpathReadReplyHandler(CManager cm, CMConnection conn, void *msg_v,
                                    void *client_Data, attr_list attrs)
 {
-    PERFSTUBS_TIMER_START_FUNC(timer);
-    EvpathReadReplyMsg ReadReplyMsg = (EvpathReadReplyMsg)msg_v;
+    DPReadReplyMsg ReadReplyMsg = (DPReadReplyMsg)msg_v;
     Evpath_RS_Stream RS_Stream = ReadReplyMsg->RS_Stream;
-    CP_Services Svcs = (CP_Services)client_Data;
-    EvpathCompletionHandle Handle = NULL;
-
-    if (CMCondition_has_signaled(cm, ReadReplyMsg->NotifyCondition))
-    {
-        Svcs->verbose(RS_Stream->CP_Stream, DPTraceVerbose,
-                      "Got a reply to remote memory "
-                      "read, but the condition is "
-                      "already signalled, returning\n");
-        PERFSTUBS_TIMER_STOP_FUNC(timer);
-        return;
-    }
-    Handle = CMCondition_get_client_data(cm, ReadReplyMsg->NotifyCondition);
-
-    if (!Handle)
-    {
-        Svcs->verbose(
-            RS_Stream->CP_Stream, DPCriticalVerbose,
-            "Got a reply to remote memory read, but condition not found\n");
-        PERFSTUBS_TIMER_STOP_FUNC(timer);
-        return;
-    }
-    Svcs->verbose(
-        RS_Stream->CP_Stream, DPTraceVerbose,
-        "Got a reply to remote memory read from rank %d, condition is %d\n",
-        Handle->Rank, ReadReplyMsg->NotifyCondition);
-
-    /*
-     * `Handle` contains the full request info and is `client_data`
-     * associated with the CMCondition.  Once we get it, copy the incoming
-     * data to the buffer area given by the request
-     */
-    memcpy(Handle->Buffer, ReadReplyMsg->Data, ReadReplyMsg->DataLength);
-
-    RS_Stream->Stats->DataBytesReceived += ReadReplyMsg->DataLength;
-
-    /*
-     * Signal the condition to wake the reader if they are waiting.
-     */
-    CMCondition_signal(cm, ReadReplyMsg->NotifyCondition);
-    PERFSTUBS_TIMER_STOP_FUNC(timer);
+    DP_HandleReadReply((CP_Services)client_Data, cm, RS_Stream->CP_Stream,
+                       RS_Stream->Stats, ReadReplyMsg);
 }
 
 /*
@@ -632,9 +500,6 @@ static void DiscardPriorPreloaded(CP_Services Svcs, Evpath_RS_Stream RS_Stream,
     }
 }
 
-static void RemoveRequestFromList(CP_Services Svcs, Evpath_RS_Stream Stream,
-                                  EvpathCompletionHandle Handle);
-
 // reader-side routine, called from the network handler thread
 static void EvpathPreloadHandler(CManager cm, CMConnection conn, void *msg_v,
                                  void *client_Data, attr_list attrs)
@@ -670,18 +535,18 @@ static void EvpathPreloadHandler(CManager cm, CMConnection conn, void *msg_v,
     pthread_mutex_lock(&RS_Stream->DataLock);
     Entry->Next = RS_Stream->QueuedTimesteps;
     RS_Stream->QueuedTimesteps = Entry;
-    EvpathCompletionHandle Requests = RS_Stream->PendingReadRequests;
+    DPCompletionHandle Requests = RS_Stream->PendingReadRequests;
     while (Requests)
     {
         int HadPreload;
-        EvpathCompletionHandle Next = Requests->Next;
+        DPCompletionHandle Next = Requests->Next;
         HadPreload = HandleRequestWithPreloaded(
             Svcs, RS_Stream, Requests->Rank, PreloadMsg->Timestep,
             Requests->Offset, Requests->Length, Requests->Buffer);
         if (HadPreload)
         {
             CMCondition_signal(cm, Requests->CMcondition);
-            RemoveRequestFromList(Svcs, RS_Stream, Requests);
+            DP_RemoveRequestFromList(&RS_Stream->PendingReadRequests, Requests);
         }
         Requests = Next;
     }
@@ -876,102 +741,6 @@ static void EvpathProvideWriterDataToReader(CP_Services Svcs,
     }
 }
 
-static void AddRequestToList(CP_Services Svcs, Evpath_RS_Stream Stream,
-                             EvpathCompletionHandle Handle)
-{
-    Handle->Next = Stream->PendingReadRequests;
-    Stream->PendingReadRequests = Handle;
-}
-
-// reader-side routine, called from the main program
-static void RemoveRequestFromList(CP_Services Svcs, Evpath_RS_Stream Stream,
-                                  EvpathCompletionHandle Handle)
-{
-    EvpathCompletionHandle Tmp;
-
-    Tmp = Stream->PendingReadRequests;
-    if (Stream->PendingReadRequests == Handle)
-    {
-        Stream->PendingReadRequests = Handle->Next;
-        return;
-    }
-
-    while (Tmp != NULL && Tmp->Next != Handle)
-    {
-        Tmp = Tmp->Next;
-    }
-
-    if (Tmp == NULL)
-    {
-        return;
-    }
-
-    // Tmp->Next must be the handle to remove
-    Tmp->Next = Tmp->Next->Next;
-}
-
-// reader-side routine, called from the network handler (close handler)
-static void FailRequestsToRank(CP_Services Svcs, CManager cm,
-                               Evpath_RS_Stream Stream, int FailedRank)
-{
-    EvpathCompletionHandle Tmp;
-    int FailedSomethingToRank = 0;
-    Svcs->verbose(Stream->CP_Stream, DPTraceVerbose,
-                  "Fail pending requests to rank %d on stream %p\n", FailedRank,
-                  Stream);
-    pthread_mutex_lock(&Stream->DataLock);
-    Tmp = Stream->PendingReadRequests;
-    while (Tmp != NULL)
-    {
-        if ((Tmp->Failed != 1) && (Tmp->Rank == FailedRank))
-        {
-            Tmp->Failed = 1;
-            FailedSomethingToRank = 1;
-            Svcs->verbose(Tmp->CPStream, DPTraceVerbose,
-                          "Found a pending remote memory read "
-                          "to writer rank %d, marking as "
-                          "failed and signalling condition %d\n",
-                          Tmp->Rank, Tmp->CMcondition);
-            CMCondition_signal(cm, Tmp->CMcondition);
-            Svcs->verbose(Tmp->CPStream, DPTraceVerbose,
-                          "Did the signal of condition %d\n", Tmp->Rank,
-                          Tmp->CMcondition);
-        }
-        Tmp = Tmp->Next;
-    }
-    if (FailedSomethingToRank)
-    {
-        Tmp = Stream->PendingReadRequests;
-        Svcs->verbose(Stream->CP_Stream, DPTraceVerbose,
-                      "We were waiting for requests on rank %d, fail *all* "
-                      "pending requests on stream %p\n",
-                      FailedRank, Stream);
-
-        while (Tmp != NULL)
-        {
-            if (Tmp->Failed != 1)
-            {
-                Tmp->Failed = 1;
-                FailedSomethingToRank = 1;
-                Svcs->verbose(Tmp->CPStream, DPTraceVerbose,
-                              "Found a pending remote memory read "
-                              "to writer rank %d, marking as "
-                              "failed and signalling condition %d\n",
-                              Tmp->Rank, Tmp->CMcondition);
-                CMCondition_signal(cm, Tmp->CMcondition);
-                Svcs->verbose(Tmp->CPStream, DPTraceVerbose,
-                              "Did the signal of condition %d\n", Tmp->Rank,
-                              Tmp->CMcondition);
-            }
-            Tmp = Tmp->Next;
-        }
-    }
-    pthread_mutex_unlock(&Stream->DataLock);
-    Svcs->verbose(Stream->CP_Stream, DPPerRankVerbose,
-                  "Done Failing requests to writer %d from stream %p\n",
-                  FailedRank, Stream);
-}
-
 typedef struct _EvpathPerTimestepInfo
 {
     char *CheckString;
@@ -987,10 +756,9 @@ static void *EvpathReadRemoteMemory(CP_Services Svcs, DP_RS_Stream Stream_v,
     Evpath_RS_Stream Stream = (Evpath_RS_Stream)
         Stream_v; /* DP_RS_Stream is the return from InitReader */
     CManager cm = Svcs->getCManager(Stream->CP_Stream);
-    EvpathCompletionHandle ret = malloc(sizeof(struct _EvpathCompletionHandle));
+    DPCompletionHandle ret = malloc(sizeof(struct _DPCompletionHandle));
     // EvpathPerTimestepInfo TimestepInfo =
     // (EvpathPerTimestepInfo)DP_TimestepInfo;
-    struct _EvpathReadRequestMsg ReadRequestMsg;
 
     int HadPreload;
     static long LastRequestedTimestep = -1;
@@ -1028,7 +796,7 @@ static void *EvpathReadRemoteMemory(CP_Services Svcs, DP_RS_Stream Stream_v,
      * set the completion handle as client Data on the condition so that
      * handler has access to it.
      */
-    AddRequestToList(Svcs, Stream, ret);
+    DP_AddRequestToList(&Stream->PendingReadRequests, ret);
     CMCondition_set_client_data(cm, ret->CMcondition, ret);
     pthread_mutex_unlock(&Stream->DataLock);
     int WaitForData = 0;
@@ -1067,21 +835,9 @@ static void *EvpathReadRemoteMemory(CP_Services Svcs, DP_RS_Stream Stream_v,
                   DP_TimestepInfo);
 
     /* send request to appropriate writer */
-    /* memset avoids uninit byte warnings from valgrind */
-    memset(&ReadRequestMsg, 0, sizeof(ReadRequestMsg));
-    ReadRequestMsg.Timestep = Timestep;
-    ReadRequestMsg.Offset = Offset;
-    ReadRequestMsg.Length = Length;
-    ReadRequestMsg.WS_Stream = Stream->WriterContactInfo[Rank].WS_Stream;
-    ReadRequestMsg.RS_Stream = Stream;
-    ReadRequestMsg.RequestingRank = Stream->Rank;
-    ReadRequestMsg.NotifyCondition = ret->CMcondition;
-    if (!Svcs->sendToPeer(Stream->CP_Stream, Stream->PeerCohort, Rank,
-                          Stream->ReadRequestFormat, &ReadRequestMsg))
-    {
-        ret->Failed = 1;
-        CMCondition_signal(cm, ret->CMcondition);
-    }
+    DP_SendReadRequest(Svcs, Stream->PeerCohort, Stream->ReadRequestFormat,
+                       ret, Timestep, Stream->WriterContactInfo[Rank].WS_Stream,
+                       Stream->Rank);
 
     return ret;
 }
@@ -1089,42 +845,10 @@ static void *EvpathReadRemoteMemory(CP_Services Svcs, DP_RS_Stream Stream_v,
 // reader-side routine, called from the main program
 static int EvpathWaitForCompletion(CP_Services Svcs, void *Handle_v)
 {
-    EvpathCompletionHandle Handle = (EvpathCompletionHandle)Handle_v;
-    int Ret = 1;
-    if (Handle->CMcondition != -1)
-        Svcs->verbose(
-            Handle->CPStream, DPTraceVerbose,
-            "Waiting for completion of memory read to rank %d, condition %d\n",
-            Handle->Rank, Handle->CMcondition);
-    /*
-     * Wait for the CM condition to be signalled.  If it has been already,
-     * this returns immediately.  Copying the incoming data to the waiting
-     * buffer has been done by the reply handler.
-     */
-    if (Handle->CMcondition != -1)
-        CMCondition_wait(Handle->cm, Handle->CMcondition);
-    if (Handle->Failed)
-    {
-        Svcs->verbose(Handle->CPStream, DPTraceVerbose,
-                      "Remote memory read to rank %d with "
-                      "condition %d has FAILED because of "
-                      "writer failure\n",
-                      Handle->Rank, Handle->CMcondition);
-        Ret = 0;
-    }
-    else
-    {
-        if (Handle->CMcondition != -1)
-            Svcs->verbose(Handle->CPStream, DPTraceVerbose,
-                          "Remote memory read to rank %d with condition %d has "
-                          "completed\n",
-                          Handle->Rank, Handle->CMcondition);
-    }
-    pthread_mutex_lock(&((Evpath_RS_Stream)Handle->DPStream)->DataLock);
-    RemoveRequestFromList(Svcs, Handle->DPStream, Handle);
-    pthread_mutex_unlock(&((Evpath_RS_Stream)Handle->DPStream)->DataLock);
-    free(Handle);
-    return Ret;
+    DPCompletionHandle Handle = (DPCompletionHandle)Handle_v;
+    Evpath_RS_Stream Stream = (Evpath_RS_Stream)Handle->DPStream;
+    return DP_WaitForCompletion(Svcs, &Stream->DataLock,
+                                &Stream->PendingReadRequests, Handle);
 }
 
 // reader-side routine, called from the network handler thread
@@ -1139,7 +863,8 @@ static void EvpathNotifyConnFailure(CP_Services Svcs, DP_RS_Stream Stream_v,
                   "%d has failed, failing any pending "
                   "requests\n",
                   FailedPeerRank);
-    FailRequestsToRank(Svcs, cm, Stream, FailedPeerRank);
+    DP_FailRequestsToRank(Svcs, cm, Stream->CP_Stream, &Stream->DataLock,
+                          &Stream->PendingReadRequests, FailedPeerRank);
 }
 
 // writer-side routine, called from the main program
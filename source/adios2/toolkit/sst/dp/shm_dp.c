@@ -0,0 +1,796 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* process_vm_readv */
+#endif
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <atl.h>
+#include <evpath.h>
+
+#include "sst_data.h"
+
+#include "dp_interface.h"
+#include "dp_request.h"
+#include <adios2-perfstubs-interface.h>
+
+#if defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define NO_SANITIZE_THREAD __attribute__((no_sanitize("thread")))
+#endif
+#endif
+
+#ifndef NO_SANITIZE_THREAD
+#define NO_SANITIZE_THREAD
+#endif
+
+/*
+ *  The "shm" data plane is meant for readers that run on the same node as
+ *  the writer (e.g. in-situ analysis next to a simulation).  Rather than
+ *  moving the data through sockets, the reader copies it straight out of
+ *  the address space of the writer process with process_vm_readv(), so
+ *  ReadRemoteMemory is a single kernel-assisted memcpy that completes
+ *  before it returns.  The writer does not copy or register anything, it
+ *  only publishes the address of each timestep's data block in the per
+ *  timestep info.
+ *
+ *  Conventions (RS/WS/WSR, contact info carrying stream addresses) are the
+ *  same as in the evpath data plane.
+ *
+ *  Whether a writer rank is reachable this way is decided once, when the
+ *  reader receives the writer contact information: the writer publishes
+ *  its host identity, its pid and the address and value of a random
+ *  cookie.  If the host matches and reading the cookie with
+ *  process_vm_readv() returns the expected value, all reads from that
+ *  writer rank go through process_vm_readv().  Otherwise (writer on
+ *  another node, different pid namespace, ptrace restrictions like Yama
+ *  ptrace_scope >= 1, ...) reads from that writer rank fall back to a
+ *  request/reply exchange over the control plane connections, shared with
+ *  the evpath data plane (dp_request.h), but without evpath's preloading.
+ *  The ShmForceRemote reader parameter makes it use messages for all
+ *  writers.
+ *
+ *  Because reader and writer select their data plane independently, the
+ *  priority of this data plane must not depend on anything that differs
+ *  between the two sides.  As nothing guarantees that the peers are on the
+ *  same node, it is below evpath and only used when selected with the
+ *  DataTransport parameter.
+ */
+
+typedef struct _Shm_RS_Stream
+{
+    CManager cm;
+    void *CP_Stream;
+    CMFormat ReadRequestFormat;
+    pthread_mutex_t DataLock;
+    int Rank;
+    char *HostID;
+
+    /* writer info */
+    int WriterCohortSize;
+    CP_PeerCohort PeerCohort;
+    struct _ShmWriterContactInfo *WriterContactInfo;
+    /* 1 if writer rank i can be read with process_vm_readv() */
+    char *WriterIsLocal;
+    /* ShmForceRemote, treat every writer as remote */
+    int ForceRemote;
+    DPCompletionHandle PendingReadRequests;
+
+    struct _ShmReaderContactInfo *MyContactInfo;
+    SstStats Stats;
+} * Shm_RS_Stream;
+
+typedef struct _Shm_WSR_Stream
+{
+    struct _Shm_WS_Stream *WS_Stream;
+    CP_PeerCohort PeerCohort;
+    int ReaderCohortSize;
+    struct _ShmReaderContactInfo *ReaderContactInfo;
+    struct _ShmWriterContactInfo
+        *WriterContactInfo; /* included so we can free on destroy */
+} * Shm_WSR_Stream;
+
+typedef struct _ShmPerTimestepInfo
+{
+    void *Block;
+    size_t DataSize;
+} * ShmPerTimestepInfo;
+
+typedef struct _TimestepEntry
+{
+    long Timestep;
+    struct _SstData Data;
+    struct _ShmPerTimestepInfo *DP_TimestepInfo;
+    struct _TimestepEntry *Next;
+} * TimestepList;
+
+typedef struct _Shm_WS_Stream
+{
+    CManager cm;
+    void *CP_Stream;
+    int Rank;
+    pthread_mutex_t DataLock;
+    char *HostID;
+    /* read by local readers to verify they can access our memory */
+    uint64_t Cookie;
+
+    TimestepList Timesteps;
+    CMFormat ReadReplyFormat;
+
+    int ReaderCount;
+    Shm_WSR_Stream *Readers;
+    SstStats Stats;
+} * Shm_WS_Stream;
+
+typedef struct _ShmReaderContactInfo
+{
+    void *RS_Stream;
+} * ShmReaderContactInfo;
+
+typedef struct _ShmWriterContactInfo
+{
+    char *HostID;
+    int Pid;
+    void *CookieAddr;
+    size_t Cookie;
+    void *WS_Stream;
+} * ShmWriterContactInfo;
+
+static FMStructDescRec ShmReadRequestStructs[] = {
+    {"ShmReadRequest", DPReadRequestList, sizeof(struct _DPReadRequestMsg),
+     NULL},
+    {NULL, NULL, 0, NULL}};
+
+static FMStructDescRec ShmReadReplyStructs[] = {
+    {"ShmReadReply", DPReadReplyList, sizeof(struct _DPReadReplyMsg), NULL},
+    {NULL, NULL, 0, NULL}};
+
+static void ShmReadReplyHandler(CManager cm, CMConnection conn, void *msg_v,
+                                void *client_Data, attr_list attrs);
+
+/*
+ * Identity of the node we run on.  The boot id distinguishes nodes (and
+ * reboots) even if host names are reused, e.g. across containers.
+ */
+static char *GetHostID()
+{
+    char HostName[256];
+    char BootID[64] = "";
+    char *Ret;
+    FILE *F;
+
+    if (gethostname(HostName, sizeof(HostName)) != 0)
+    {
+        strcpy(HostName, "unknown");
+    }
+    HostName[sizeof(HostName) - 1] = 0;
+    F = fopen("/proc/sys/kernel/random/boot_id", "r");
+    if (F)
+    {
+        if (fgets(BootID, sizeof(BootID), F) == NULL)
+        {
+            BootID[0] = 0;
+        }
+        fclose(F);
+        BootID[strcspn(BootID, "\n")] = 0;
+    }
+    Ret = malloc(strlen(HostName) + strlen(BootID) + 2);
+    sprintf(Ret, "%s/%s", HostName, BootID);
+    return Ret;
+}
+
+/*
+ * Copy Length bytes at RemoteAddr in process Pid to Buffer.  Returns 0 on
+ * success, the errno value otherwise.
+ */
+static int ReadProcessMemory(pid_t Pid, void *RemoteAddr, void *Buffer,
+                             size_t Length)
+{
+    size_t Done = 0;
+    while (Done < Length)
+    {
+        struct iovec Local, Remote;
+        ssize_t Ret;
+        Local.iov_base = (char *)Buffer + Done;
+        Local.iov_len = Length - Done;
+        Remote.iov_base = (char *)RemoteAddr + Done;
+        Remote.iov_len = Length - Done;
+        Ret = process_vm_readv(Pid, &Local, 1, &Remote, 1, 0);
+        if (Ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno;
+        }
+        if (Ret == 0)
+        {
+            return EFAULT;
+        }
+        Done += (size_t)Ret;
+    }
+    return 0;
+}
+
+// reader-side routine, called by the main thread
+static DP_RS_Stream ShmInitReader(CP_Services Svcs, void *CP_Stream,
+                                  void **ReaderContactInfoPtr,
+                                  struct _SstParams *Params,
+                                  attr_list WriterContact, SstStats Stats)
+{
+    Shm_RS_Stream Stream = malloc(sizeof(struct _Shm_RS_Stream));
+    ShmReaderContactInfo Contact = malloc(sizeof(struct _ShmReaderContactInfo));
+    CManager cm = Svcs->getCManager(CP_Stream);
+    SMPI_Comm comm = Svcs->getMPIComm(CP_Stream);
+    CMFormat F;
+
+    memset(Stream, 0, sizeof(*Stream));
+    memset(Contact, 0, sizeof(*Contact));
+
+    /*
+     * save the CP_stream value of later use
+     */
+    Stream->CP_Stream = CP_Stream;
+    Stream->Stats = Stats;
+    Stream->cm = cm;
+    Stream->HostID = GetHostID();
+    Stream->ForceRemote = Params->ShmForceRemote;
+
+    pthread_mutex_init(&Stream->DataLock, NULL);
+
+    SMPI_Comm_rank(comm, &Stream->Rank);
+
+    /*
+     * register the read request format and a handler for read replies, used
+     * with writers we cannot read directly
+     */
+    Stream->ReadRequestFormat = CMregister_format(cm, ShmReadRequestStructs);
+    F = CMregister_format(cm, ShmReadReplyStructs);
+    CMregister_handler(F, ShmReadReplyHandler, Svcs);
+
+    Contact->RS_Stream = Stream;
+    Stream->MyContactInfo = Contact;
+
+    *ReaderContactInfoPtr = Contact;
+
+    return Stream;
+}
+
+// reader-side routine, called by the main thread
+static void ShmDestroyReader(CP_Services Svcs, DP_RS_Stream RS_Stream_v)
+{
+    Shm_RS_Stream RS_Stream = (Shm_RS_Stream)RS_Stream_v;
+    for (int i = 0; i < RS_Stream->WriterCohortSize; i++)
+    {
+        free(RS_Stream->WriterContactInfo[i].HostID);
+    }
+    free(RS_Stream->WriterContactInfo);
+    free(RS_Stream->WriterIsLocal);
+    free(RS_Stream->MyContactInfo);
+    free(RS_Stream->HostID);
+    free(RS_Stream);
+}
+
+// writer side routine, called by the network handler thread
+static void ShmReadRequestHandler(CManager cm, CMConnection incoming_conn,
+                                  void *msg_v, void *client_Data,
+                                  attr_list attrs)
+{
+    PERFSTUBS_TIMER_START_FUNC(timer);
+    DPReadRequestMsg ReadRequestMsg = (DPReadRequestMsg)msg_v;
+    Shm_WSR_Stream WSR_Stream = ReadRequestMsg->WS_Stream;
+
+    Shm_WS_Stream WS_Stream = WSR_Stream->WS_Stream;
+    TimestepList tmp;
+    CP_Services Svcs = (CP_Services)client_Data;
+    int RequestingRank = ReadRequestMsg->RequestingRank;
+
+    Svcs->verbose(WS_Stream->CP_Stream, DPTraceVerbose,
+                  "Got a request to read remote memory "
+                  "from reader rank %d: timestep %d, "
+                  "offset %d, length %d\n",
+                  RequestingRank, ReadRequestMsg->Timestep,
+                  ReadRequestMsg->Offset, ReadRequestMsg->Length);
+    pthread_mutex_lock(&WS_Stream->DataLock);
+    tmp = WS_Stream->Timesteps;
+    while (tmp != NULL)
+    {
+        if (tmp->Timestep == ReadRequestMsg->Timestep)
+        {
+            CMFormat Format = WS_Stream->ReadReplyFormat;
+            char *Block = tmp->Data.block;
+            pthread_mutex_unlock(&WS_Stream->DataLock);
+            /*
+             * the request came over the reader's control plane connection,
+             * answer on the same connection
+             */
+            DP_SendReadReply(Svcs, WS_Stream->CP_Stream, incoming_conn,
+                             Format, ReadRequestMsg, Block);
+
+            PERFSTUBS_TIMER_STOP_FUNC(timer);
+            return;
+        }
+        tmp = tmp->Next;
+    }
+    pthread_mutex_unlock(&WS_Stream->DataLock);
+    DP_TimestepNotFound(WS_Stream->Rank, ReadRequestMsg);
+    PERFSTUBS_TIMER_STOP_FUNC(timer);
+}
+
+// reader-side routine called by the network handler thread
+static void ShmReadReplyHandler(CManager cm, CMConnection conn, void *msg_v,
+                                void *client_Data, attr_list attrs)
+{
+    DPReadReplyMsg ReadReplyMsg = (DPReadReplyMsg)msg_v;
+    Shm_RS_Stream RS_Stream = ReadReplyMsg->RS_Stream;
+    DP_HandleReadReply((CP_Services)client_Data, cm, RS_Stream->CP_Stream,
+                       RS_Stream->Stats, ReadReplyMsg);
+}
+
+// writer-side routine, called from the main program
+static DP_WS_Stream ShmInitWriter(CP_Services Svcs, void *CP_Stream,
+                                  struct _SstParams *Params, attr_list DPAttrs,
+                                  SstStats Stats)
+{
+    Shm_WS_Stream Stream = malloc(sizeof(struct _Shm_WS_Stream));
+    CManager cm = Svcs->getCManager(CP_Stream);
+    SMPI_Comm comm = Svcs->getMPIComm(CP_Stream);
+    struct timeval tv;
+    CMFormat F;
+
+    memset(Stream, 0, sizeof(struct _Shm_WS_Stream));
+
+    pthread_mutex_init(&Stream->DataLock, NULL);
+
+    SMPI_Comm_rank(comm, &Stream->Rank);
+
+    /*
+     * save the CP_stream value of later use
+     */
+    Stream->CP_Stream = CP_Stream;
+    Stream->Stats = Stats;
+    Stream->cm = cm;
+    Stream->HostID = GetHostID();
+
+    /*
+     * the cookie only has to be unlikely to be found at the same address in
+     * an unrelated process that happens to have our pid
+     */
+    gettimeofday(&tv, NULL);
+    Stream->Cookie = ((uint64_t)tv.tv_sec << 32) ^ (uint64_t)tv.tv_usec ^
+                     ((uint64_t)getpid() << 16) ^ (uint64_t)(uintptr_t)Stream;
+
+    /*
+     * add a handler for read request messages
+     */
+    F = CMregister_format(cm, ShmReadRequestStructs);
+    CMregister_handler(F, ShmReadRequestHandler, Svcs);
+
+    /*
+     * register read reply message structure so we can send later
+     */
+    Stream->ReadReplyFormat = CMregister_format(cm, ShmReadReplyStructs);
+
+    return (void *)Stream;
+}
+
+// writer-side routine, called from the main program
+static void ShmDestroyWriter(CP_Services Svcs, DP_WS_Stream WS_Stream_v)
+{
+    Shm_WS_Stream WS_Stream = (Shm_WS_Stream)WS_Stream_v;
+    for (int i = 0; i < WS_Stream->ReaderCount; i++)
+    {
+        if (WS_Stream->Readers[i])
+        {
+            free(WS_Stream->Readers[i]->WriterContactInfo);
+            free(WS_Stream->Readers[i]->ReaderContactInfo);
+            free(WS_Stream->Readers[i]);
+        }
+    }
+    free(WS_Stream->Readers);
+    free(WS_Stream->HostID);
+    free(WS_Stream);
+}
+
+// writer-side routine, called from the main program
+static DP_WSR_Stream ShmInitWriterPerReader(CP_Services Svcs,
+                                            DP_WS_Stream WS_Stream_v,
+                                            int readerCohortSize,
+                                            CP_PeerCohort PeerCohort,
+                                            void **providedReaderInfo_v,
+                                            void **WriterContactInfoPtr)
+{
+    Shm_WS_Stream WS_Stream = (Shm_WS_Stream)WS_Stream_v;
+    Shm_WSR_Stream WSR_Stream = malloc(sizeof(*WSR_Stream));
+    ShmWriterContactInfo ContactInfo;
+    ShmReaderContactInfo *providedReaderInfo =
+        (ShmReaderContactInfo *)providedReaderInfo_v;
+
+    WSR_Stream->WS_Stream = WS_Stream; /* pointer to writer struct */
+    WSR_Stream->PeerCohort = PeerCohort;
+
+    /*
+     * make a copy of reader contact information (original will not be
+     * preserved)
+     */
+    WSR_Stream->ReaderCohortSize = readerCohortSize;
+    WSR_Stream->ReaderContactInfo =
+        malloc(sizeof(struct _ShmReaderContactInfo) * readerCohortSize);
+    for (int i = 0; i < readerCohortSize; i++)
+    {
+        WSR_Stream->ReaderContactInfo[i].RS_Stream =
+            providedReaderInfo[i]->RS_Stream;
+        Svcs->verbose(
+            WS_Stream->CP_Stream, DPTraceVerbose,
+            "Received contact info, RS_Stream %p for Reader Rank %d\n",
+            WSR_Stream->ReaderContactInfo[i].RS_Stream, i);
+    }
+
+    /*
+     * add this writer-side reader-specific stream to the parent writer stream
+     * structure
+     */
+    pthread_mutex_lock(&WS_Stream->DataLock);
+    WS_Stream->Readers = realloc(
+        WS_Stream->Readers, sizeof(*WSR_Stream) * (WS_Stream->ReaderCount + 1));
+    WS_Stream->Readers[WS_Stream->ReaderCount] = WSR_Stream;
+    WS_Stream->ReaderCount++;
+    pthread_mutex_unlock(&WS_Stream->DataLock);
+
+    /* HostID is owned by WS_Stream, FFS copies it when encoding */
+    ContactInfo = malloc(sizeof(struct _ShmWriterContactInfo));
+    memset(ContactInfo, 0, sizeof(struct _ShmWriterContactInfo));
+    ContactInfo->HostID = WS_Stream->HostID;
+    ContactInfo->Pid = (int)getpid();
+    ContactInfo->CookieAddr = &WS_Stream->Cookie;
+    ContactInfo->Cookie = (size_t)WS_Stream->Cookie;
+    ContactInfo->WS_Stream = WSR_Stream;
+    *WriterContactInfoPtr = ContactInfo;
+    WSR_Stream->WriterContactInfo = ContactInfo;
+
+    return WSR_Stream;
+}
+
+// writer-side routine, called from the main program
+static void ShmDestroyWriterPerReader(CP_Services Svcs,
+                                      DP_WSR_Stream WSR_Stream_v)
+{
+    Shm_WSR_Stream WSR_Stream = (Shm_WSR_Stream)WSR_Stream_v;
+    free(WSR_Stream);
+}
+
+// reader-side routine, called from the main program
+static void ShmProvideWriterDataToReader(CP_Services Svcs,
+                                         DP_RS_Stream RS_Stream_v,
+                                         int writerCohortSize,
+                                         CP_PeerCohort PeerCohort,
+                                         void **providedWriterInfo_v)
+{
+    Shm_RS_Stream RS_Stream = (Shm_RS_Stream)RS_Stream_v;
+    ShmWriterContactInfo *providedWriterInfo =
+        (ShmWriterContactInfo *)providedWriterInfo_v;
+    int LocalCount = 0;
+
+    RS_Stream->PeerCohort = PeerCohort;
+    RS_Stream->WriterCohortSize = writerCohortSize;
+
+    /*
+     * make a copy of writer contact information (original will not be
+     * preserved)
+     */
+    RS_Stream->WriterContactInfo =
+        malloc(sizeof(struct _ShmWriterContactInfo) * writerCohortSize);
+    RS_Stream->WriterIsLocal = calloc(writerCohortSize, 1);
+    for (int i = 0; i < writerCohortSize; i++)
+    {
+        ShmWriterContactInfo Info = &RS_Stream->WriterContactInfo[i];
+        *Info = *providedWriterInfo[i];
+        Info->HostID = strdup(providedWriterInfo[i]->HostID
+                                  ? providedWriterInfo[i]->HostID
+                                  : "");
+
+        /*
+         * probe the writer's cookie, this fails if the writer is on another
+         * node, in another pid namespace or if we may not access its memory
+         */
+        if (!RS_Stream->ForceRemote &&
+            (strcmp(Info->HostID, RS_Stream->HostID) == 0))
+        {
+            uint64_t Cookie = 0;
+            int Err = ReadProcessMemory((pid_t)Info->Pid, Info->CookieAddr,
+                                        &Cookie, sizeof(Cookie));
+            if (Err == 0 && Cookie == (uint64_t)Info->Cookie)
+            {
+                RS_Stream->WriterIsLocal[i] = 1;
+                LocalCount++;
+            }
+            else
+            {
+                Svcs->verbose(RS_Stream->CP_Stream, DPPerRankVerbose,
+                              "Writer rank %d (pid %d) is on this node but "
+                              "its memory is not readable (%s), using "
+                              "messages for it\n",
+                              i, Info->Pid,
+                              Err ? strerror(Err) : "cookie mismatch");
+            }
+        }
+        Svcs->verbose(RS_Stream->CP_Stream, DPTraceVerbose,
+                      "Received contact info, host \"%s\", pid %d, WS_stream "
+                      "%p for WSR Rank %d, %s\n",
+                      Info->HostID, Info->Pid, Info->WS_Stream, i,
+                      RS_Stream->WriterIsLocal[i] ? "local" : "remote");
+    }
+    Svcs->verbose(RS_Stream->CP_Stream, DPPerStepVerbose,
+                  "Shm data plane: %d of %d writer ranks readable directly\n",
+                  LocalCount, writerCohortSize);
+}
+
+// reader-side routine, called from the main program
+static void *ShmReadRemoteMemory(CP_Services Svcs, DP_RS_Stream Stream_v,
+                                 int Rank, long Timestep, size_t Offset,
+                                 size_t Length, void *Buffer,
+                                 void *DP_TimestepInfo)
+{
+    Shm_RS_Stream Stream = (Shm_RS_Stream)
+        Stream_v; /* DP_RS_Stream is the return from InitReader */
+    CManager cm = Svcs->getCManager(Stream->CP_Stream);
+    DPCompletionHandle ret = malloc(sizeof(struct _DPCompletionHandle));
+    ShmPerTimestepInfo TimestepInfo = (ShmPerTimestepInfo)DP_TimestepInfo;
+
+    memset(ret, 0, sizeof(*ret));
+    ret->CPStream = Stream->CP_Stream;
+    ret->DPStream = Stream;
+    ret->cm = cm;
+    ret->Buffer = Buffer;
+    ret->Rank = Rank;
+    ret->Offset = Offset;
+    ret->Length = Length;
+    ret->CMcondition = -1;
+
+    if (Stream->WriterIsLocal[Rank] && TimestepInfo &&
+        (Offset + Length <= TimestepInfo->DataSize))
+    {
+        int Err = ReadProcessMemory(
+            (pid_t)Stream->WriterContactInfo[Rank].Pid,
+            (char *)TimestepInfo->Block + Offset, Buffer, Length);
+        if (Err == 0)
+        {
+            Svcs->verbose(Stream->CP_Stream, DPTraceVerbose,
+                          "Read %zu bytes of Timestep %ld directly from "
+                          "writer rank %d\n",
+                          Length, Timestep, Rank);
+            Stream->Stats->DataBytesReceived += Length;
+            return ret;
+        }
+        if (Err == ESRCH)
+        {
+            /* writer process is gone */
+            ret->Failed = 1;
+            return ret;
+        }
+        Svcs->verbose(Stream->CP_Stream, DPCriticalVerbose,
+                      "Direct read from writer rank %d failed (%s), using "
+                      "messages for it from now on\n",
+                      Rank, strerror(Err));
+        Stream->WriterIsLocal[Rank] = 0;
+    }
+
+    ret->CMcondition = CMCondition_get(cm, NULL);
+
+    /*
+     * set the completion handle as client Data on the condition so that
+     * handler has access to it.
+     */
+    pthread_mutex_lock(&Stream->DataLock);
+    DP_AddRequestToList(&Stream->PendingReadRequests, ret);
+    CMCondition_set_client_data(cm, ret->CMcondition, ret);
+    pthread_mutex_unlock(&Stream->DataLock);
+
+    Svcs->verbose(Stream->CP_Stream, DPTraceVerbose,
+                  "Adios requesting to read remote memory for Timestep %d "
+                  "from Rank %d, WSR_Stream = %p\n",
+                  Timestep, Rank, Stream->WriterContactInfo[Rank].WS_Stream);
+
+    /* send request to appropriate writer */
+    DP_SendReadRequest(Svcs, Stream->PeerCohort, Stream->ReadRequestFormat,
+                       ret, Timestep, Stream->WriterContactInfo[Rank].WS_Stream,
+                       Stream->Rank);
+
+    return ret;
+}
+
+// reader-side routine, called from the main program
+static int ShmWaitForCompletion(CP_Services Svcs, void *Handle_v)
+{
+    DPCompletionHandle Handle = (DPCompletionHandle)Handle_v;
+    Shm_RS_Stream Stream = (Shm_RS_Stream)Handle->DPStream;
+    /* direct reads are complete already, their condition is -1 */
+    return DP_WaitForCompletion(Svcs, &Stream->DataLock,
+                                &Stream->PendingReadRequests, Handle);
+}
+
+// reader-side routine, called from the network handler thread
+static void ShmNotifyConnFailure(CP_Services Svcs, DP_RS_Stream Stream_v,
+                                 int FailedPeerRank)
+{
+    Shm_RS_Stream Stream = (Shm_RS_Stream)
+        Stream_v; /* DP_RS_Stream is the return from InitReader */
+    CManager cm = Svcs->getCManager(Stream->CP_Stream);
+    Svcs->verbose(Stream->CP_Stream, DPPerRankVerbose,
+                  "received notification that writer peer "
+                  "%d has failed, failing any pending "
+                  "requests\n",
+                  FailedPeerRank);
+    DP_FailRequestsToRank(Svcs, cm, Stream->CP_Stream, &Stream->DataLock,
+                          &Stream->PendingReadRequests, FailedPeerRank);
+}
+
+// writer-side routine, called from the main program
+static void ShmProvideTimestep(CP_Services Svcs, DP_WS_Stream Stream_v,
+                               struct _SstData *Data,
+                               struct _SstData *LocalMetadata, long Timestep,
+                               void **TimestepInfoPtr)
+{
+    Shm_WS_Stream WS_Stream = (Shm_WS_Stream)Stream_v;
+    TimestepList Entry = malloc(sizeof(struct _TimestepEntry));
+    ShmPerTimestepInfo Info = malloc(sizeof(struct _ShmPerTimestepInfo));
+
+    /*
+     * The data block stays in place until the timestep is released, local
+     * readers copy straight out of it
+     */
+    Info->Block = Data->block;
+    Info->DataSize = Data->DataSize;
+
+    memset(Entry, 0, sizeof(*Entry));
+    Entry->DP_TimestepInfo = Info;
+    Entry->Data = *Data;
+    Entry->Timestep = Timestep;
+    Entry->Next = NULL;
+
+    Svcs->verbose(WS_Stream->CP_Stream, DPPerRankVerbose,
+                  "ProvideTimestep, registering timestep %ld, data %p, size "
+                  "%zu\n",
+                  Timestep, Data->block, Data->DataSize);
+    pthread_mutex_lock(&WS_Stream->DataLock);
+    if (WS_Stream->Timesteps)
+    {
+        TimestepList Last = WS_Stream->Timesteps;
+        while (Last->Next)
+        {
+            Last = Last->Next;
+        }
+        Last->Next = Entry;
+    }
+    else
+    {
+        WS_Stream->Timesteps = Entry;
+    }
+    pthread_mutex_unlock(&WS_Stream->DataLock);
+    *TimestepInfoPtr = Info;
+}
+
+// writer-side routine, called from the main program
+static void ShmReleaseTimestep(CP_Services Svcs, DP_WS_Stream Stream_v,
+                               long Timestep)
+{
+    Shm_WS_Stream WS_Stream = (Shm_WS_Stream)Stream_v;
+    TimestepList List, Last = NULL;
+
+    Svcs->verbose(WS_Stream->CP_Stream, DPPerRankVerbose,
+                  "Releasing timestep %ld\n", Timestep);
+    pthread_mutex_lock(&WS_Stream->DataLock);
+    List = WS_Stream->Timesteps;
+    while (List != NULL)
+    {
+        if (List->Timestep == Timestep)
+        {
+            if (Last)
+            {
+                Last->Next = List->Next;
+            }
+            else
+            {
+                WS_Stream->Timesteps = List->Next;
+            }
+            free(List->DP_TimestepInfo);
+            free(List);
+            pthread_mutex_unlock(&WS_Stream->DataLock);
+            return;
+        }
+        Last = List;
+        List = List->Next;
+    }
+    pthread_mutex_unlock(&WS_Stream->DataLock);
+    /*
+     * Shouldn't ever get here because we should never release a
+     * timestep that we don't have.
+     */
+    fprintf(stderr, "Failed to release Timestep %ld, not found\n", Timestep);
+    assert(0);
+}
+
+static FMField ShmReaderContactList[] = {
+    {"reader_ID", "integer", sizeof(void *),
+     FMOffset(ShmReaderContactInfo, RS_Stream)},
+    {NULL, NULL, 0, 0}};
+
+static FMStructDescRec ShmReaderContactStructs[] = {
+    {"ShmReaderContactInfo", ShmReaderContactList,
+     sizeof(struct _ShmReaderContactInfo), NULL},
+    {NULL, NULL, 0, NULL}};
+
+static FMField ShmWriterContactList[] = {
+    {"HostID", "string", sizeof(char *),
+     FMOffset(ShmWriterContactInfo, HostID)},
+    {"Pid", "integer", sizeof(int), FMOffset(ShmWriterContactInfo, Pid)},
+    {"CookieAddr", "integer", sizeof(void *),
+     FMOffset(ShmWriterContactInfo, CookieAddr)},
+    {"Cookie", "integer", sizeof(size_t),
+     FMOffset(ShmWriterContactInfo, Cookie)},
+    {"writer_ID", "integer", sizeof(void *),
+     FMOffset(ShmWriterContactInfo, WS_Stream)},
+    {NULL, NULL, 0, 0}};
+
+static FMStructDescRec ShmWriterContactStructs[] = {
+    {"ShmWriterContactInfo", ShmWriterContactList,
+     sizeof(struct _ShmWriterContactInfo), NULL},
+    {NULL, NULL, 0, NULL}};
+
+static FMField ShmTimestepInfoList[] = {
+    {"Block", "integer", sizeof(void *), FMOffset(ShmPerTimestepInfo, Block)},
+    {"DataSize", "integer", sizeof(size_t),
+     FMOffset(ShmPerTimestepInfo, DataSize)},
+    {NULL, NULL, 0, 0}};
+
+static FMStructDescRec ShmTimestepInfoStructs[] = {
+    {"ShmTimestepInfo", ShmTimestepInfoList,
+     sizeof(struct _ShmPerTimestepInfo), NULL},
+    {NULL, NULL, 0, NULL}};
+
+static struct _CP_DP_Interface shmDPInterface = {0};
+
+static int ShmGetPriority(CP_Services Svcs, void *CP_Stream,
+                          struct _SstParams *Params)
+{
+    /*
+     * Below evpath (1), so that it is only used when asked for.  Must not
+     * depend on local conditions, see above.
+     */
+    return 0;
+}
+
+extern NO_SANITIZE_THREAD CP_DP_Interface LoadShmDP()
+{
+    shmDPInterface.ReaderContactFormats = ShmReaderContactStructs;
+    shmDPInterface.WriterContactFormats = ShmWriterContactStructs;
+    shmDPInterface.TimestepInfoFormats = ShmTimestepInfoStructs;
+    shmDPInterface.initReader = ShmInitReader;
+    shmDPInterface.initWriter = ShmInitWriter;
+    shmDPInterface.initWriterPerReader = ShmInitWriterPerReader;
+    shmDPInterface.provideWriterDataToReader = ShmProvideWriterDataToReader;
+    shmDPInterface.readRemoteMemory = ShmReadRemoteMemory;
+    shmDPInterface.waitForCompletion = ShmWaitForCompletion;
+    shmDPInterface.notifyConnFailure = ShmNotifyConnFailure;
+    shmDPInterface.provideTimestep = ShmProvideTimestep;
+    shmDPInterface.releaseTimestep = ShmReleaseTimestep;
+    shmDPInterface.readerRegisterTimestep = NULL;
+    shmDPInterface.readerReleaseTimestep = NULL;
+    shmDPInterface.WSRreadPatternLocked = NULL;
+    shmDPInterface.RSreadPatternLocked = NULL;
+    shmDPInterface.timestepArrived = NULL;
+    shmDPInterface.destroyReader = ShmDestroyReader;
+    shmDPInterface.destroyWriter = ShmDestroyWriter;
+    shmDPInterface.destroyWriterPerReader = ShmDestroyWriterPerReader;
+    shmDPInterface.getPriority = ShmGetPriority;
+    shmDPInterface.unGetPriority = NULL;
+    return &shmDPInterface;
+}
@@ -46,11 +46,37 @@ void Transport::WriteV(const core::iovec *iov, const int iovcnt, size_t start)
     }
 }
 
+void Transport::ReadV(const core::iovec *iov, const int iovcnt, size_t start)
+{
+    if (iovcnt > 0)
+    {
+        Read(static_cast<char *>(const_cast<void *>(iov[0].iov_base)),
+             iov[0].iov_len, start);
+        for (int c = 1; c < iovcnt; ++c)
+        {
+            Read(static_cast<char *>(const_cast<void *>(iov[c].iov_base)),
+                 iov[c].iov_len);
+        }
+    }
+    else if (start != MaxSizeT)
+    {
+        Seek(start);
+    }
+}
+
 void Transport::IRead(char *buffer, size_t size, Status &status, size_t start)
 {
     throw std::invalid_argument("ERROR: this class doesn't implement IRead\n");
 }
 
+const char *Transport::MapRange(const size_t /*start*/,
+                                const size_t /*size*/)
+{
+    return nullptr;
+}
+
+void Transport::WaitForCompletion() {}
+
 void Transport::InitProfiler(const Mode openMode, const TimeUnit timeUnit)
 {
     m_Profiler.m_IsActive = true;
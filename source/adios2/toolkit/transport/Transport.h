@@ -130,9 +130,37 @@ public:
      */
     virtual void Read(char *buffer, size_t size, size_t start = MaxSizeT) = 0;
 
+    /**
+     * Reads from transport into several buffers, readv version. The
+     * iov_base pointers are the destinations and must be writable.
+     * @param iovec array pointer
+     * @param iovcnt number of entries
+     * @param start starting position for read, if not passed then start at
+     * current stream position
+     */
+    virtual void ReadV(const core::iovec *iov, const int iovcnt,
+                       size_t start = MaxSizeT);
+
     virtual void IRead(char *buffer, size_t size, Status &status,
                        size_t start = MaxSizeT);
 
+    /**
+     * Returns a pointer to size bytes of the file at start if the transport
+     * can expose them without copying, e.g. from a memory map. The memory
+     * is read-only and stays valid until Close.
+     * Default returns nullptr, callers then use Read.
+     * @param start offset in file
+     * @param size number of bytes
+     */
+    virtual const char *MapRange(const size_t start, const size_t size);
+
+    /**
+     * Blocks until all operations started with IWrite and IRead are
+     * complete. Their buffers and Status objects must stay valid until then.
+     * Default does nothing, for transports that complete them immediately.
+     */
+    virtual void WaitForCompletion();
+
     /**
      * Returns the size of current data in transport
      * @return size as size_t
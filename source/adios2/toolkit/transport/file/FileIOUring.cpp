@@ -0,0 +1,855 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileIOUring.cpp file I/O through io_uring, using the system calls directly
+ *
+ */
+#include "FileIOUring.h"
+#include "adios2/helper/adiosFunctions.h" // LowerCase, StringTo
+
+#include <algorithm> // std::min, std::max
+#include <cstdio>    // remove
+#include <cstring>   // strerror, memset, memcpy
+#include <errno.h>   // errno
+#include <fcntl.h>   // open
+#include <linux/io_uring.h>
+#include <sys/mman.h>    // mmap
+#include <sys/stat.h>    // open, fstat
+#include <sys/syscall.h> // SYS_io_uring_*
+#include <sys/types.h>   // open
+#include <sys/uio.h>     // iovec
+#include <unistd.h>      // close, ftruncate, syscall
+
+/// \cond EXCLUDE_FROM_DOXYGEN
+#include <ios> //std::ios_base::failure
+/// \endcond
+
+namespace adios2
+{
+namespace transport
+{
+
+namespace
+{
+/** blocking calls are cut into pieces of this size so that a single large
+ * buffer still keeps several requests in flight */
+constexpr size_t IOPieceSize = 4 * 1024 * 1024;
+/** the length of a request is 32 bits, longer ones are resubmitted */
+constexpr size_t MaxRequestSize = 1024 * 1024 * 1024;
+}
+
+FileIOUring::FileIOUring(helper::Comm const &comm)
+: Transport("File", "IOUring", comm)
+{
+}
+
+FileIOUring::~FileIOUring()
+{
+    if (m_InFlight > 0)
+    {
+        // the kernel may still access our buffers, let it finish
+        try
+        {
+            WaitForCompletion();
+        }
+        catch (...)
+        {
+        }
+    }
+    if (m_IsOpen)
+    {
+        close(m_FileDescriptor);
+    }
+    DestroyRing();
+}
+
+void FileIOUring::SetParameters(const Params &parameters)
+{
+    for (const auto &pair : parameters)
+    {
+        const std::string key = helper::LowerCase(pair.first);
+        const std::string value = helper::LowerCase(pair.second);
+
+        if (key == "queuedepth")
+        {
+            m_QueueDepth = std::max(
+                1u, helper::StringTo<uint32_t>(
+                        value, " in Parameter key=QueueDepth"));
+        }
+        else if (key == "registerbuffers")
+        {
+            m_RegisterBuffers = helper::StringTo<bool>(
+                value, " in Parameter key=RegisterBuffers");
+        }
+        else if (key == "registeredbuffersize")
+        {
+            m_RegisteredBufferSize = helper::StringToByteUnits(
+                value, " in Parameter key=RegisteredBufferSize");
+        }
+    }
+}
+
+void FileIOUring::WaitForOpen()
+{
+    if (m_IsOpening)
+    {
+        if (m_OpenFuture.valid())
+        {
+            m_FileDescriptor = m_OpenFuture.get();
+        }
+        m_IsOpening = false;
+        CheckFile("couldn't open file " + m_Name + ", in call to POSIX open");
+        m_IsOpen = true;
+    }
+}
+
+void FileIOUring::Open(const std::string &name, const Mode openMode,
+                       const bool async)
+{
+    auto lf_AsyncOpenWrite = [&](const std::string &name) -> int {
+        ProfilerStart("open");
+        errno = 0;
+        int FD = open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        m_Errno = errno;
+        ProfilerStop("open");
+        return FD;
+    };
+
+    m_Name = name;
+    CheckName();
+    m_OpenMode = openMode;
+    SetupRing();
+    m_Offset = 0;
+    switch (m_OpenMode)
+    {
+
+    case (Mode::Write):
+        if (async)
+        {
+            m_IsOpening = true;
+            m_OpenFuture =
+                std::async(std::launch::async, lf_AsyncOpenWrite, name);
+        }
+        else
+        {
+            ProfilerStart("open");
+            errno = 0;
+            m_FileDescriptor =
+                open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            m_Errno = errno;
+            ProfilerStop("open");
+        }
+        break;
+
+    case (Mode::Append):
+        ProfilerStart("open");
+        errno = 0;
+        m_FileDescriptor = open(m_Name.c_str(), O_RDWR | O_CREAT, 0777);
+        m_Errno = errno;
+        if (m_FileDescriptor != -1)
+        {
+            m_Offset =
+                static_cast<size_t>(lseek(m_FileDescriptor, 0, SEEK_END));
+        }
+        ProfilerStop("open");
+        break;
+
+    case (Mode::Read):
+        ProfilerStart("open");
+        errno = 0;
+        m_FileDescriptor = open(m_Name.c_str(), O_RDONLY);
+        m_Errno = errno;
+        ProfilerStop("open");
+        break;
+
+    default:
+        CheckFile("unknown open mode for file " + m_Name +
+                  ", in call to POSIX open");
+    }
+
+    if (!m_IsOpening)
+    {
+        CheckFile("couldn't open file " + m_Name + ", in call to POSIX open");
+        m_IsOpen = true;
+    }
+}
+
+void FileIOUring::OpenChain(const std::string &name, Mode openMode,
+                            const helper::Comm &chainComm, const bool async)
+{
+    auto lf_AsyncOpenWrite = [&](const std::string &name) -> int {
+        ProfilerStart("open");
+        errno = 0;
+        int FD = open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        m_Errno = errno;
+        ProfilerStop("open");
+        return FD;
+    };
+
+    int token = 1;
+    m_Name = name;
+    CheckName();
+
+    if (chainComm.Rank() > 0)
+    {
+        chainComm.Recv(&token, 1, chainComm.Rank() - 1, 0,
+                       "Chain token in FileIOUring::OpenChain");
+    }
+
+    m_OpenMode = openMode;
+    SetupRing();
+    m_Offset = 0;
+    switch (m_OpenMode)
+    {
+
+    case (Mode::Write):
+        if (async && chainComm.Size() == 1)
+        {
+            // only when process is a single writer, can create the file
+            // asynchronously, otherwise other processes are waiting on it
+            m_IsOpening = true;
+            m_OpenFuture =
+                std::async(std::launch::async, lf_AsyncOpenWrite, name);
+        }
+        else
+        {
+            ProfilerStart("open");
+            errno = 0;
+            if (chainComm.Rank() == 0)
+            {
+                m_FileDescriptor =
+                    open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+            }
+            else
+            {
+                m_FileDescriptor = open(m_Name.c_str(), O_WRONLY, 0666);
+            }
+            m_Errno = errno;
+            ProfilerStop("open");
+        }
+        break;
+
+    case (Mode::Append):
+        ProfilerStart("open");
+        errno = 0;
+        if (chainComm.Rank() == 0)
+        {
+            m_FileDescriptor = open(m_Name.c_str(), O_RDWR | O_CREAT, 0666);
+        }
+        else
+        {
+            m_FileDescriptor = open(m_Name.c_str(), O_RDWR);
+        }
+        m_Errno = errno;
+        if (m_FileDescriptor != -1)
+        {
+            m_Offset =
+                static_cast<size_t>(lseek(m_FileDescriptor, 0, SEEK_END));
+        }
+        ProfilerStop("open");
+        break;
+
+    case (Mode::Read):
+        ProfilerStart("open");
+        errno = 0;
+        m_FileDescriptor = open(m_Name.c_str(), O_RDONLY);
+        m_Errno = errno;
+        ProfilerStop("open");
+        break;
+
+    default:
+        CheckFile("unknown open mode for file " + m_Name +
+                  ", in call to POSIX open");
+    }
+
+    if (!m_IsOpening)
+    {
+        CheckFile("couldn't open file " + m_Name + ", in call to POSIX open");
+        m_IsOpen = true;
+    }
+
+    if (chainComm.Rank() < chainComm.Size() - 1)
+    {
+        chainComm.Isend(&token, 1, chainComm.Rank() + 1, 0,
+                        "Sending Chain token in FileIOUring::OpenChain");
+    }
+}
+
+void FileIOUring::Write(const char *buffer, size_t size, size_t start)
+{
+    WaitForOpen();
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+
+    ProfilerStart("write");
+    for (size_t pos = 0; pos < size; pos += IOPieceSize)
+    {
+        Submit(true, const_cast<char *>(buffer) + pos,
+               std::min(IOPieceSize, size - pos), start + pos, nullptr);
+    }
+    WaitForSync();
+    ProfilerStop("write");
+    CheckSyncError("couldn't write to file " + m_Name +
+                   ", in call to io_uring Write");
+    m_Offset = start + size;
+}
+
+void FileIOUring::IWrite(const char *buffer, size_t size, Status &status,
+                         size_t start)
+{
+    WaitForOpen();
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+
+    status = {0, size > 0, size == 0};
+    if (size > 0)
+    {
+        ProfilerStart("write");
+        Submit(true, const_cast<char *>(buffer), size, start, &status);
+        Reap(false);
+        ProfilerStop("write");
+    }
+    m_Offset = start + size;
+}
+
+void FileIOUring::WriteV(const core::iovec *iov, const int iovcnt,
+                         size_t start)
+{
+    WaitForOpen();
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+
+    ProfilerStart("write");
+    size_t offset = start;
+    for (int c = 0; c < iovcnt; ++c)
+    {
+        char *base = static_cast<char *>(const_cast<void *>(iov[c].iov_base));
+        const size_t len = iov[c].iov_len;
+        for (size_t pos = 0; pos < len; pos += IOPieceSize)
+        {
+            Submit(true, base + pos, std::min(IOPieceSize, len - pos),
+                   offset + pos, nullptr);
+        }
+        offset += len;
+    }
+    WaitForSync();
+    ProfilerStop("write");
+    CheckSyncError("couldn't write to file " + m_Name +
+                   ", in call to io_uring Write(iovec)");
+    m_Offset = offset;
+}
+
+void FileIOUring::Read(char *buffer, size_t size, size_t start)
+{
+    WaitForOpen();
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+
+    ProfilerStart("read");
+    for (size_t pos = 0; pos < size; pos += IOPieceSize)
+    {
+        Submit(false, buffer + pos, std::min(IOPieceSize, size - pos),
+               start + pos, nullptr);
+    }
+    WaitForSync();
+    ProfilerStop("read");
+    CheckSyncError("couldn't read from file " + m_Name +
+                   ", in call to io_uring Read");
+    m_Offset = start + size;
+}
+
+void FileIOUring::ReadV(const core::iovec *iov, const int iovcnt,
+                        size_t start)
+{
+    WaitForOpen();
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+
+    ProfilerStart("read");
+    size_t offset = start;
+    for (int c = 0; c < iovcnt; ++c)
+    {
+        char *base = static_cast<char *>(const_cast<void *>(iov[c].iov_base));
+        const size_t len = iov[c].iov_len;
+        for (size_t pos = 0; pos < len; pos += IOPieceSize)
+        {
+            Submit(false, base + pos, std::min(IOPieceSize, len - pos),
+                   offset + pos, nullptr);
+        }
+        offset += len;
+    }
+    WaitForSync();
+    ProfilerStop("read");
+    CheckSyncError("couldn't read from file " + m_Name +
+                   ", in call to io_uring Read(iovec)");
+    m_Offset = offset;
+}
+
+void FileIOUring::IRead(char *buffer, size_t size, Status &status,
+                        size_t start)
+{
+    WaitForOpen();
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+
+    status = {0, size > 0, size == 0};
+    if (size > 0)
+    {
+        ProfilerStart("read");
+        Submit(false, buffer, size, start, &status);
+        Reap(false);
+        ProfilerStop("read");
+    }
+    m_Offset = start + size;
+}
+
+void FileIOUring::WaitForCompletion()
+{
+    while (m_InFlight > 0)
+    {
+        Reap(true);
+    }
+}
+
+size_t FileIOUring::GetSize()
+{
+    struct stat fileStat;
+    WaitForOpen();
+    WaitForCompletion();
+    errno = 0;
+    if (fstat(m_FileDescriptor, &fileStat) == -1)
+    {
+        m_Errno = errno;
+        throw std::ios_base::failure("ERROR: couldn't get size of file " +
+                                     m_Name + SysErrMsg());
+    }
+    m_Errno = errno;
+    return static_cast<size_t>(fileStat.st_size);
+}
+
+void FileIOUring::Flush()
+{
+    WaitForOpen();
+    WaitForCompletion();
+}
+
+void FileIOUring::Close()
+{
+    WaitForOpen();
+    WaitForCompletion();
+    ProfilerStart("close");
+    errno = 0;
+    const int status = close(m_FileDescriptor);
+    m_Errno = errno;
+    ProfilerStop("close");
+    DestroyRing();
+
+    if (status == -1)
+    {
+        throw std::ios_base::failure("ERROR: couldn't close file " + m_Name +
+                                     ", in call to POSIX IO close" +
+                                     SysErrMsg());
+    }
+
+    m_IsOpen = false;
+}
+
+void FileIOUring::Delete()
+{
+    WaitForOpen();
+    if (m_IsOpen)
+    {
+        Close();
+    }
+    std::remove(m_Name.c_str());
+}
+
+void FileIOUring::SeekToEnd() { m_Offset = GetSize(); }
+
+void FileIOUring::SeekToBegin() { m_Offset = 0; }
+
+void FileIOUring::Seek(const size_t start)
+{
+    if (start != MaxSizeT)
+    {
+        m_Offset = start;
+    }
+    else
+    {
+        SeekToEnd();
+    }
+}
+
+void FileIOUring::Truncate(const size_t length)
+{
+    WaitForOpen();
+    WaitForCompletion();
+    errno = 0;
+    const int status = ftruncate(m_FileDescriptor, static_cast<off_t>(length));
+    m_Errno = errno;
+    if (status == -1)
+    {
+        throw std::ios_base::failure(
+            "ERROR: couldn't truncate to " + std::to_string(length) +
+            " bytes of file " + m_Name + ", in call to POSIX IO truncate" +
+            SysErrMsg());
+    }
+}
+
+void FileIOUring::MkDir(const std::string &fileName) {}
+
+bool FileIOUring::BuffersRegistered() const noexcept
+{
+    return !m_FixedBuffers.empty();
+}
+
+// PRIVATE
+void FileIOUring::SetupRing()
+{
+    if (m_RingFD != -1)
+    {
+        return;
+    }
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    errno = 0;
+    m_RingFD = static_cast<int>(
+        syscall(__NR_io_uring_setup, m_QueueDepth, &params));
+    m_Errno = errno;
+    if (m_RingFD < 0)
+    {
+        m_RingFD = -1;
+        throw std::ios_base::failure(
+            "ERROR: couldn't set up io_uring with queue depth " +
+            std::to_string(m_QueueDepth) + " for file " + m_Name + SysErrMsg());
+    }
+
+    m_SQRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_CQRingSize =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (singleMmap)
+    {
+        m_SQRingSize = m_CQRingSize = std::max(m_SQRingSize, m_CQRingSize);
+    }
+    m_SQEsSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    auto lf_Map = [&](const size_t size, const off_t offset) -> void * {
+        void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, m_RingFD, offset);
+        if (p == MAP_FAILED)
+        {
+            m_Errno = errno;
+            DestroyRing();
+            throw std::ios_base::failure(
+                "ERROR: couldn't map the io_uring queues for file " + m_Name +
+                SysErrMsg());
+        }
+        return p;
+    };
+
+    m_SQRing = lf_Map(m_SQRingSize, IORING_OFF_SQ_RING);
+    m_CQRing =
+        singleMmap ? m_SQRing : lf_Map(m_CQRingSize, IORING_OFF_CQ_RING);
+    m_SQEs = static_cast<io_uring_sqe *>(lf_Map(m_SQEsSize, IORING_OFF_SQES));
+
+    char *sq = static_cast<char *>(m_SQRing);
+    m_SQTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_SQMask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_SQArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    char *cq = static_cast<char *>(m_CQRing);
+    m_CQHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_CQTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_CQMask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_CQEs = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    // at most QueueDepth requests are in flight, so neither queue overflows
+    m_Requests.assign(m_QueueDepth, Request());
+    m_FreeRequests.resize(m_QueueDepth);
+    for (unsigned i = 0; i < m_QueueDepth; ++i)
+    {
+        m_FreeRequests[i] = m_QueueDepth - 1 - i;
+    }
+    m_InFlight = 0;
+    m_SyncPending = 0;
+    m_SyncError = 0;
+    m_ToSubmit = 0;
+
+    if (m_RegisterBuffers)
+    {
+        m_FixedBuffers.resize(m_QueueDepth * m_RegisteredBufferSize);
+        std::vector<iovec> iovs(m_QueueDepth);
+        for (unsigned i = 0; i < m_QueueDepth; ++i)
+        {
+            iovs[i].iov_base =
+                m_FixedBuffers.data() + i * m_RegisteredBufferSize;
+            iovs[i].iov_len = m_RegisteredBufferSize;
+        }
+        if (syscall(__NR_io_uring_register, m_RingFD, IORING_REGISTER_BUFFERS,
+                    iovs.data(), m_QueueDepth) == 0)
+        {
+            m_FreeFixed.resize(m_QueueDepth);
+            for (unsigned i = 0; i < m_QueueDepth; ++i)
+            {
+                m_FreeFixed[i] = static_cast<int>(m_QueueDepth - 1 - i);
+            }
+        }
+        else
+        {
+            // usually RLIMIT_MEMLOCK, run without registered buffers
+            std::vector<char>().swap(m_FixedBuffers);
+            m_FreeFixed.clear();
+        }
+    }
+}
+
+void FileIOUring::DestroyRing() noexcept
+{
+    if (m_SQEs)
+    {
+        munmap(m_SQEs, m_SQEsSize);
+    }
+    if (m_CQRing && m_CQRing != m_SQRing)
+    {
+        munmap(m_CQRing, m_CQRingSize);
+    }
+    if (m_SQRing)
+    {
+        munmap(m_SQRing, m_SQRingSize);
+    }
+    if (m_RingFD != -1)
+    {
+        close(m_RingFD);
+    }
+    m_SQEs = nullptr;
+    m_CQRing = nullptr;
+    m_SQRing = nullptr;
+    m_RingFD = -1;
+    m_FreeFixed.clear();
+    std::vector<char>().swap(m_FixedBuffers);
+}
+
+void FileIOUring::Submit(const bool isWrite, char *buffer, const size_t size,
+                         const size_t offset, Status *async)
+{
+    while (m_FreeRequests.empty())
+    {
+        Reap(true);
+    }
+    const unsigned index = m_FreeRequests.back();
+    m_FreeRequests.pop_back();
+
+    Request &request = m_Requests[index];
+    request.IsWrite = isWrite;
+    request.Buffer = buffer;
+    request.Size = size;
+    request.Offset = offset;
+    request.Done = 0;
+    request.FixedIndex = -1;
+    request.Async = async;
+    if (size <= m_RegisteredBufferSize && !m_FreeFixed.empty())
+    {
+        request.FixedIndex = m_FreeFixed.back();
+        m_FreeFixed.pop_back();
+        if (isWrite)
+        {
+            // the caller's buffer is free again as soon as we return
+            memcpy(m_FixedBuffers.data() +
+                       request.FixedIndex * m_RegisteredBufferSize,
+                   buffer, size);
+        }
+    }
+
+    ++m_InFlight;
+    if (!async)
+    {
+        ++m_SyncPending;
+    }
+    Prepare(index);
+}
+
+void FileIOUring::Prepare(const unsigned index)
+{
+    const Request &request = m_Requests[index];
+    const unsigned tail = *m_SQTail;
+    const unsigned slot = tail & m_SQMask;
+    io_uring_sqe *sqe = &m_SQEs[slot];
+    memset(sqe, 0, sizeof(*sqe));
+
+    char *addr = request.Buffer;
+    if (request.FixedIndex >= 0)
+    {
+        addr = m_FixedBuffers.data() +
+               request.FixedIndex * m_RegisteredBufferSize;
+        sqe->opcode = request.IsWrite ? IORING_OP_WRITE_FIXED
+                                      : IORING_OP_READ_FIXED;
+        sqe->buf_index = static_cast<__u16>(request.FixedIndex);
+    }
+    else
+    {
+        sqe->opcode = request.IsWrite ? IORING_OP_WRITE : IORING_OP_READ;
+    }
+    sqe->fd = m_FileDescriptor;
+    sqe->addr = reinterpret_cast<__u64>(addr + request.Done);
+    sqe->len = static_cast<__u32>(
+        std::min(MaxRequestSize, request.Size - request.Done));
+    sqe->off = request.Offset + request.Done;
+    sqe->user_data = index;
+
+    m_SQArray[slot] = slot;
+    __atomic_store_n(m_SQTail, tail + 1, __ATOMIC_RELEASE);
+    ++m_ToSubmit;
+}
+
+void FileIOUring::Reap(const bool wait)
+{
+    while (m_ToSubmit > 0 || wait)
+    {
+        const unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+        errno = 0;
+        const long ret = syscall(__NR_io_uring_enter, m_RingFD, m_ToSubmit,
+                                 wait ? 1 : 0, flags, nullptr, 0);
+        if (ret < 0)
+        {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+            {
+                if (errno != EINTR)
+                {
+                    // completions first, then try again
+                    break;
+                }
+                continue;
+            }
+            m_Errno = errno;
+            throw std::ios_base::failure(
+                "ERROR: couldn't submit to io_uring for file " + m_Name +
+                SysErrMsg());
+        }
+        m_ToSubmit -= std::min(m_ToSubmit, static_cast<unsigned>(ret));
+        break;
+    }
+
+    unsigned head = *m_CQHead;
+    const unsigned tail = __atomic_load_n(m_CQTail, __ATOMIC_ACQUIRE);
+    while (head != tail)
+    {
+        const io_uring_cqe &cqe = m_CQEs[head & m_CQMask];
+        const unsigned index = static_cast<unsigned>(cqe.user_data);
+        const int result = cqe.res;
+        ++head;
+        __atomic_store_n(m_CQHead, head, __ATOMIC_RELEASE);
+        Complete(index, result);
+    }
+}
+
+void FileIOUring::Complete(const unsigned index, const int result)
+{
+    Request &request = m_Requests[index];
+    if (result == -EINTR || result == -EAGAIN)
+    {
+        Prepare(index);
+        return;
+    }
+
+    int error = 0;
+    if (result < 0)
+    {
+        error = -result;
+    }
+    else if (result == 0)
+    {
+        // end of file on read, nothing written on write
+        error = EIO;
+    }
+    else
+    {
+        request.Done += static_cast<size_t>(result);
+        if (request.Done < request.Size)
+        {
+            Prepare(index);
+            return;
+        }
+    }
+
+    if (request.FixedIndex >= 0)
+    {
+        if (!error && !request.IsWrite)
+        {
+            memcpy(request.Buffer,
+                   m_FixedBuffers.data() +
+                       request.FixedIndex * m_RegisteredBufferSize,
+                   request.Size);
+        }
+        m_FreeFixed.push_back(request.FixedIndex);
+    }
+
+    if (request.Async)
+    {
+        request.Async->Bytes = request.Done;
+        request.Async->Running = false;
+        request.Async->Successful = !error;
+        if (error)
+        {
+            m_Errno = error;
+        }
+    }
+    else
+    {
+        --m_SyncPending;
+        if (error && !m_SyncError)
+        {
+            m_SyncError = error;
+        }
+    }
+    m_FreeRequests.push_back(index);
+    --m_InFlight;
+}
+
+void FileIOUring::WaitForSync()
+{
+    while (m_SyncPending > 0)
+    {
+        Reap(true);
+    }
+}
+
+void FileIOUring::CheckSyncError(const std::string &hint)
+{
+    if (m_SyncError)
+    {
+        m_Errno = m_SyncError;
+        m_SyncError = 0;
+        throw std::ios_base::failure("ERROR: " + hint + SysErrMsg());
+    }
+}
+
+void FileIOUring::CheckFile(const std::string hint) const
+{
+    if (m_FileDescriptor == -1)
+    {
+        throw std::ios_base::failure("ERROR: " + hint + SysErrMsg());
+    }
+}
+
+std::string FileIOUring::SysErrMsg() const
+{
+    return std::string(": errno = " + std::to_string(m_Errno) + ": " +
+                       strerror(m_Errno));
+}
+
+} // end namespace transport
+} // end namespace adios2
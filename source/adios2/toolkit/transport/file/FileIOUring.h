@@ -0,0 +1,175 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileIOUring.h file I/O through a Linux io_uring submission/completion queue
+ * pair, keeping up to QueueDepth requests in flight
+ */
+
+#ifndef ADIOS2_TOOLKIT_TRANSPORT_FILE_FILEIOURING_H_
+#define ADIOS2_TOOLKIT_TRANSPORT_FILE_FILEIOURING_H_
+
+#include <future> //std::async, std::future
+#include <vector>
+
+#include "adios2/common/ADIOSConfig.h"
+#include "adios2/toolkit/transport/Transport.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace adios2
+{
+namespace helper
+{
+class Comm;
+}
+namespace transport
+{
+
+/**
+ * File transport on io_uring, selected with {"Library", "uring"}.
+ * Write/WriteV/Read split the data into pieces that are all submitted before
+ * waiting, IWrite/IRead return right after submission.
+ * Parameters:
+ *   QueueDepth        requests in flight, default 32
+ *   RegisterBuffers   register QueueDepth staging buffers with the kernel,
+ *                     requests that fit use them, default false
+ *   RegisteredBufferSize  size of each staging buffer, default 1Mb
+ */
+class FileIOUring : public Transport
+{
+
+public:
+    FileIOUring(helper::Comm const &comm);
+
+    ~FileIOUring();
+
+    void SetParameters(const Params &parameters) final;
+
+    void Open(const std::string &name, const Mode openMode,
+              const bool async = false) final;
+
+    void OpenChain(const std::string &name, Mode openMode,
+                   const helper::Comm &chainComm,
+                   const bool async = false) final;
+
+    void Write(const char *buffer, size_t size, size_t start = MaxSizeT) final;
+
+    void IWrite(const char *buffer, size_t size, Status &status,
+                size_t start = MaxSizeT) final;
+
+    void WriteV(const core::iovec *iov, const int iovcnt,
+                size_t start = MaxSizeT) final;
+
+    void Read(char *buffer, size_t size, size_t start = MaxSizeT) final;
+
+    void ReadV(const core::iovec *iov, const int iovcnt,
+               size_t start = MaxSizeT) final;
+
+    void IRead(char *buffer, size_t size, Status &status,
+               size_t start = MaxSizeT) final;
+
+    void WaitForCompletion() final;
+
+    size_t GetSize() final;
+
+    /** Waits for outstanding requests, the data is then with the OS */
+    void Flush() final;
+
+    void Close() final;
+
+    void Delete() final;
+
+    void SeekToEnd() final;
+
+    void SeekToBegin() final;
+
+    void Seek(const size_t start = MaxSizeT) final;
+
+    void Truncate(const size_t length) final;
+
+    void MkDir(const std::string &fileName) final;
+
+    /** for adios2 internal testing: true if the RegisterBuffers staging
+     * buffers are registered with the kernel */
+    bool BuffersRegistered() const noexcept;
+
+private:
+    /** one submitted read or write, resubmitted on short transfers */
+    struct Request
+    {
+        bool IsWrite = false;
+        char *Buffer = nullptr;
+        size_t Size = 0;
+        size_t Offset = 0;
+        size_t Done = 0;
+        /** registered staging buffer, -1 if none */
+        int FixedIndex = -1;
+        /** nullptr for pieces of the blocking calls */
+        Status *Async = nullptr;
+    };
+
+    int m_FileDescriptor = -1;
+    int m_Errno = 0;
+    bool m_IsOpening = false;
+    std::future<int> m_OpenFuture;
+    /** file position used when start == MaxSizeT */
+    size_t m_Offset = 0;
+
+    unsigned int m_QueueDepth = 32;
+    bool m_RegisterBuffers = false;
+    size_t m_RegisteredBufferSize = 1024 * 1024;
+
+    /* ring */
+    int m_RingFD = -1;
+    void *m_SQRing = nullptr;
+    size_t m_SQRingSize = 0;
+    void *m_CQRing = nullptr;
+    size_t m_CQRingSize = 0;
+    io_uring_sqe *m_SQEs = nullptr;
+    size_t m_SQEsSize = 0;
+    unsigned *m_SQTail = nullptr;
+    unsigned m_SQMask = 0;
+    unsigned *m_SQArray = nullptr;
+    unsigned *m_CQHead = nullptr;
+    unsigned *m_CQTail = nullptr;
+    unsigned m_CQMask = 0;
+    io_uring_cqe *m_CQEs = nullptr;
+    unsigned m_ToSubmit = 0;
+
+    std::vector<Request> m_Requests;
+    std::vector<unsigned> m_FreeRequests;
+    unsigned m_InFlight = 0;
+    /** pieces of the current blocking call still in flight */
+    unsigned m_SyncPending = 0;
+    /** errno of the first failed piece of the current blocking call */
+    int m_SyncError = 0;
+
+    std::vector<char> m_FixedBuffers;
+    std::vector<int> m_FreeFixed;
+
+    void SetupRing();
+    void DestroyRing() noexcept;
+
+    void Submit(const bool isWrite, char *buffer, const size_t size,
+                const size_t offset, Status *async);
+    void Prepare(const unsigned index);
+    /** submits prepared requests and processes completions, optionally
+     * waiting for at least one */
+    void Reap(const bool wait);
+    void Complete(const unsigned index, const int result);
+    /** waits for the pieces of a blocking call */
+    void WaitForSync();
+    /** throws if a piece of the last blocking call failed */
+    void CheckSyncError(const std::string &hint);
+
+    void CheckFile(const std::string hint) const;
+    void WaitForOpen();
+    std::string SysErrMsg() const;
+};
+
+} // end namespace transport
+} // end namespace adios2
+
+#endif /* ADIOS2_TOOLKIT_TRANSPORT_FILE_FILEIOURING_H_ */
@@ -0,0 +1,244 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileMMap.cpp read-only file transport on a memory map of the whole file
+ */
+#include "FileMMap.h"
+
+#include <cstdio>     // remove
+#include <cstring>    // strerror, memcpy
+#include <errno.h>    // errno
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+
+/// \cond EXCLUDE_FROM_DOXYGEN
+#include <ios> //std::ios_base::failure
+/// \endcond
+
+namespace adios2
+{
+namespace transport
+{
+
+FileMMap::FileMMap(helper::Comm const &comm) : Transport("File", "mmap", comm)
+{
+}
+
+FileMMap::~FileMMap()
+{
+    Unmap();
+    if (m_IsOpen)
+    {
+        close(m_FileDescriptor);
+    }
+}
+
+void FileMMap::Open(const std::string &name, const Mode openMode,
+                    const bool /*async*/)
+{
+    m_Name = name;
+    CheckName();
+    m_OpenMode = openMode;
+    if (m_OpenMode != Mode::Read)
+    {
+        throw std::invalid_argument("ERROR: mmap transport only supports "
+                                    "Mode::Read, file " +
+                                    m_Name + ", in call to mmap open\n");
+    }
+
+    ProfilerStart("open");
+    errno = 0;
+    m_FileDescriptor = open(m_Name.c_str(), O_RDONLY);
+    m_Errno = errno;
+    ProfilerStop("open");
+
+    CheckFile("couldn't open file " + m_Name + ", in call to mmap open");
+    m_IsOpen = true;
+    m_Offset = 0;
+    Remap();
+}
+
+void FileMMap::OpenChain(const std::string &name, Mode openMode,
+                         const helper::Comm &chainComm, const bool async)
+{
+    int token = 1;
+    if (chainComm.Rank() > 0)
+    {
+        chainComm.Recv(&token, 1, chainComm.Rank() - 1, 0,
+                       "Chain token in FileMMap::OpenChain");
+    }
+
+    Open(name, openMode, async);
+
+    if (chainComm.Rank() < chainComm.Size() - 1)
+    {
+        chainComm.Isend(&token, 1, chainComm.Rank() + 1, 0,
+                        "Sending Chain token in FileMMap::OpenChain");
+    }
+}
+
+void FileMMap::Write(const char * /*buffer*/, size_t /*size*/,
+                     size_t /*start*/)
+{
+    throw std::invalid_argument("ERROR: mmap transport is read-only, file " +
+                                m_Name + ", in call to mmap Write\n");
+}
+
+void FileMMap::Read(char *buffer, size_t size, size_t start)
+{
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+    ProfilerStart("read");
+    std::memcpy(buffer, MapRange(start, size), size);
+    ProfilerStop("read");
+    m_Offset = start + size;
+}
+
+const char *FileMMap::MapRange(const size_t start, const size_t size)
+{
+    if (start + size > m_MapSize)
+    {
+        Remap();
+        if (start + size > m_MapSize)
+        {
+            throw std::ios_base::failure(
+                "ERROR: couldn't read " + std::to_string(size) +
+                " bytes at offset " + std::to_string(start) + " of file " +
+                m_Name + " of size " + std::to_string(m_MapSize) +
+                ", in call to mmap MapRange\n");
+        }
+    }
+    // m_Map is nullptr only for empty files, then size is 0 as well
+    return m_Map + start;
+}
+
+size_t FileMMap::GetSize()
+{
+    struct stat fileStat;
+    errno = 0;
+    if (fstat(m_FileDescriptor, &fileStat) == -1)
+    {
+        m_Errno = errno;
+        throw std::ios_base::failure("ERROR: couldn't get size of file " +
+                                     m_Name + SysErrMsg());
+    }
+    m_Errno = errno;
+    return static_cast<size_t>(fileStat.st_size);
+}
+
+void FileMMap::Close()
+{
+    ProfilerStart("close");
+    Unmap();
+    errno = 0;
+    const int status = close(m_FileDescriptor);
+    m_Errno = errno;
+    ProfilerStop("close");
+
+    if (status == -1)
+    {
+        throw std::ios_base::failure("ERROR: couldn't close file " + m_Name +
+                                     ", in call to mmap close" + SysErrMsg());
+    }
+
+    m_IsOpen = false;
+}
+
+void FileMMap::Delete()
+{
+    if (m_IsOpen)
+    {
+        Close();
+    }
+    std::remove(m_Name.c_str());
+}
+
+void FileMMap::SeekToEnd() { m_Offset = GetSize(); }
+
+void FileMMap::SeekToBegin() { m_Offset = 0; }
+
+void FileMMap::Seek(const size_t start)
+{
+    if (start != MaxSizeT)
+    {
+        m_Offset = start;
+    }
+    else
+    {
+        SeekToEnd();
+    }
+}
+
+void FileMMap::Truncate(const size_t /*length*/)
+{
+    throw std::invalid_argument("ERROR: mmap transport is read-only, file " +
+                                m_Name + ", in call to mmap Truncate\n");
+}
+
+void FileMMap::MkDir(const std::string & /*fileName*/) {}
+
+void FileMMap::Remap()
+{
+    const size_t size = GetSize();
+    if (size <= m_MapSize)
+    {
+        return;
+    }
+
+    ProfilerStart("open");
+    errno = 0;
+    void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, m_FileDescriptor, 0);
+    m_Errno = errno;
+    ProfilerStop("open");
+    if (map == MAP_FAILED)
+    {
+        throw std::ios_base::failure("ERROR: couldn't map " +
+                                     std::to_string(size) + " bytes of file " +
+                                     m_Name + ", in call to mmap" +
+                                     SysErrMsg());
+    }
+
+    if (m_Map != nullptr)
+    {
+        m_OldMaps.emplace_back(m_Map, m_MapSize);
+    }
+    m_Map = static_cast<char *>(map);
+    m_MapSize = size;
+}
+
+void FileMMap::Unmap() noexcept
+{
+    for (const auto &oldMap : m_OldMaps)
+    {
+        munmap(oldMap.first, oldMap.second);
+    }
+    m_OldMaps.clear();
+    if (m_Map != nullptr)
+    {
+        munmap(m_Map, m_MapSize);
+        m_Map = nullptr;
+    }
+    m_MapSize = 0;
+}
+
+void FileMMap::CheckFile(const std::string hint) const
+{
+    if (m_FileDescriptor == -1)
+    {
+        throw std::ios_base::failure("ERROR: " + hint + SysErrMsg());
+    }
+}
+
+std::string FileMMap::SysErrMsg() const
+{
+    return std::string(": errno = " + std::to_string(m_Errno) + ": " +
+                       strerror(m_Errno));
+}
+
+} // end namespace transport
+} // end namespace adios2
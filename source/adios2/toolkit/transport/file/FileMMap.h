@@ -0,0 +1,95 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileMMap.h read-only file transport on a memory map of the whole file
+ */
+
+#ifndef ADIOS2_TOOLKIT_TRANSPORT_FILE_FILEMMAP_H_
+#define ADIOS2_TOOLKIT_TRANSPORT_FILE_FILEMMAP_H_
+
+#include <utility> //std::pair
+#include <vector>
+
+#include "adios2/common/ADIOSConfig.h"
+#include "adios2/toolkit/transport/Transport.h"
+
+namespace adios2
+{
+namespace helper
+{
+class Comm;
+}
+namespace transport
+{
+
+/**
+ * Read-only file transport selected with {"Library", "mmap"}. The file is
+ * mapped as a whole, Read copies out of the map and MapRange returns
+ * pointers into it so readers can skip the copy.
+ * If the file grew since it was mapped (a reader following a writer) it is
+ * mapped again, the old map stays valid until Close.
+ */
+class FileMMap : public Transport
+{
+
+public:
+    FileMMap(helper::Comm const &comm);
+
+    ~FileMMap();
+
+    void Open(const std::string &name, const Mode openMode,
+              const bool async = false) final;
+
+    void OpenChain(const std::string &name, Mode openMode,
+                   const helper::Comm &chainComm,
+                   const bool async = false) final;
+
+    /** throws, the transport is read-only */
+    void Write(const char *buffer, size_t size, size_t start = MaxSizeT) final;
+
+    void Read(char *buffer, size_t size, size_t start = MaxSizeT) final;
+
+    const char *MapRange(const size_t start, const size_t size) final;
+
+    size_t GetSize() final;
+
+    void Close() final;
+
+    void Delete() final;
+
+    void SeekToEnd() final;
+
+    void SeekToBegin() final;
+
+    void Seek(const size_t start = MaxSizeT) final;
+
+    /** throws, the transport is read-only */
+    void Truncate(const size_t length) final;
+
+    void MkDir(const std::string &fileName) final;
+
+private:
+    int m_FileDescriptor = -1;
+    int m_Errno = 0;
+    /** file position used when start == MaxSizeT */
+    size_t m_Offset = 0;
+
+    char *m_Map = nullptr;
+    size_t m_MapSize = 0;
+    /** maps replaced by a larger one, pointers into them may still be in
+     * use, unmapped at Close */
+    std::vector<std::pair<char *, size_t>> m_OldMaps;
+
+    /** maps the file again if it is now larger than the current map */
+    void Remap();
+    void Unmap() noexcept;
+
+    void CheckFile(const std::string hint) const;
+    std::string SysErrMsg() const;
+};
+
+} // end namespace transport
+} // end namespace adios2
+
+#endif /* ADIOS2_TOOLKIT_TRANSPORT_FILE_FILEMMAP_H_ */
@@ -8,17 +8,24 @@
  *      Author: William F Godoy godoywf@ornl.gov
  */
 #include "FilePOSIX.h"
+#include "adios2/helper/adiosFunctions.h" // LowerCase, StringTo
 
 #include <cstdio>      // remove
+#include <cstdint>     // uintptr_t
+#include <cstdlib>     // posix_memalign, free
 #include <cstring>     // strerror
 #include <errno.h>     // errno
-#include <fcntl.h>     // open
+#include <fcntl.h>     // open, sync_file_range, posix_fadvise
 #include <stddef.h>    // write output
 #include <sys/stat.h>  // open, fstat
 #include <sys/types.h> // open
 #include <sys/uio.h>   // writev
 #include <unistd.h>    // write, close, ftruncate
 
+#include <algorithm> // std::min
+#include <climits>   // IOV_MAX
+#include <vector>
+
 #include <iostream>
 
 /// \cond EXCLUDE_FROM_DOXYGEN
@@ -30,6 +37,12 @@ namespace adios2
 namespace transport
 {
 
+namespace
+{
+/** staging buffer for data that is not aligned in memory */
+constexpr size_t DirectIOBounceSize = 4 * 1024 * 1024;
+}
+
 FilePOSIX::FilePOSIX(helper::Comm const &comm)
 : Transport("File", "POSIX", comm)
 {
@@ -41,6 +54,49 @@ FilePOSIX::~FilePOSIX()
     {
         close(m_FileDescriptor);
     }
+    if (m_DirectFileDescriptor != -1)
+    {
+        close(m_DirectFileDescriptor);
+    }
+    free(m_Bounce);
+}
+
+void FilePOSIX::SetParameters(const Params &parameters)
+{
+    for (const auto &pair : parameters)
+    {
+        const std::string key = helper::LowerCase(pair.first);
+        const std::string value = helper::LowerCase(pair.second);
+
+        if (key == "directio")
+        {
+            m_DirectIO =
+                helper::StringTo<bool>(value, " in Parameter key=DirectIO");
+        }
+        else if (key == "directioalignment")
+        {
+            m_DirectIOAlignment = helper::StringToByteUnits(
+                value, " in Parameter key=DirectIOAlignment");
+            if (m_DirectIOAlignment < 512 ||
+                (m_DirectIOAlignment & (m_DirectIOAlignment - 1)))
+            {
+                throw std::invalid_argument(
+                    "ERROR: DirectIOAlignment must be a power of 2 and at "
+                    "least 512, in call to POSIX SetParameters\n");
+            }
+        }
+        else if (key == "writebehindsize")
+        {
+            m_WriteBehindSize = helper::StringToByteUnits(
+                value, " in Parameter key=WriteBehindSize");
+            if (m_WriteBehindSize > 0 && m_Profiler.m_IsActive)
+            {
+                m_Profiler.m_Timers.emplace(
+                    "writebehind",
+                    profiling::Timer("writebehind", TimeUnit::Microseconds));
+            }
+        }
+    }
 }
 
 void FilePOSIX::WaitForOpen()
@@ -54,6 +110,25 @@ void FilePOSIX::WaitForOpen()
         m_IsOpening = false;
         CheckFile("couldn't open file " + m_Name + ", in call to POSIX open");
         m_IsOpen = true;
+        OpenDirect();
+    }
+}
+
+void FilePOSIX::OpenDirect()
+{
+    if (!m_DirectIO || m_OpenMode == Mode::Read)
+    {
+        return;
+    }
+#ifdef O_DIRECT
+    errno = 0;
+    m_DirectFileDescriptor = open(m_Name.c_str(), O_WRONLY | O_DIRECT);
+    m_Errno = errno;
+#endif
+    if (m_DirectFileDescriptor == -1)
+    {
+        // e.g. tmpfs does not support O_DIRECT, stay with buffered I/O
+        m_DirectIO = false;
     }
 }
 
@@ -63,7 +138,7 @@ void FilePOSIX::Open(const std::string &name, const Mode openMode,
     auto lf_AsyncOpenWrite = [&](const std::string &name) -> int {
         ProfilerStart("open");
         errno = 0;
-        int FD = open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+        int FD = open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
         m_Errno = errno;
         ProfilerStop("open");
         return FD;
@@ -87,7 +162,7 @@ void FilePOSIX::Open(const std::string &name, const Mode openMode,
             ProfilerStart("open");
             errno = 0;
             m_FileDescriptor =
-                open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+                open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
             m_Errno = errno;
             ProfilerStop("open");
         }
@@ -97,7 +172,7 @@ void FilePOSIX::Open(const std::string &name, const Mode openMode,
         ProfilerStart("open");
         errno = 0;
         // m_FileDescriptor = open(m_Name.c_str(), O_RDWR);
-        m_FileDescriptor = open(m_Name.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0777);
+        m_FileDescriptor = open(m_Name.c_str(), O_RDWR | O_CREAT, 0777);
         lseek(m_FileDescriptor, 0, SEEK_END);
         m_Errno = errno;
         ProfilerStop("open");
@@ -120,6 +195,7 @@ void FilePOSIX::Open(const std::string &name, const Mode openMode,
     {
         CheckFile("couldn't open file " + m_Name + ", in call to POSIX open");
         m_IsOpen = true;
+        OpenDirect();
     }
 }
 
@@ -129,7 +205,7 @@ void FilePOSIX::OpenChain(const std::string &name, Mode openMode,
     auto lf_AsyncOpenWrite = [&](const std::string &name) -> int {
         ProfilerStart("open");
         errno = 0;
-        int FD = open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+        int FD = open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
         m_Errno = errno;
         ProfilerStop("open");
         return FD;
@@ -165,11 +241,11 @@ void FilePOSIX::OpenChain(const std::string &name, Mode openMode,
             if (chainComm.Rank() == 0)
             {
                 m_FileDescriptor =
-                    open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0666);
+                    open(m_Name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
             }
             else
             {
-                m_FileDescriptor = open(m_Name.c_str(), O_WRONLY | O_DIRECT, 0666);
+                m_FileDescriptor = open(m_Name.c_str(), O_WRONLY, 0666);
                 lseek(m_FileDescriptor, 0, SEEK_SET);
             }
             m_Errno = errno;
@@ -182,7 +258,7 @@ void FilePOSIX::OpenChain(const std::string &name, Mode openMode,
         errno = 0;
         if (chainComm.Rank() == 0)
         {
-            m_FileDescriptor = open(m_Name.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0666);
+            m_FileDescriptor = open(m_Name.c_str(), O_RDWR | O_CREAT, 0666);
         }
         else
         {
@@ -210,6 +286,7 @@ void FilePOSIX::OpenChain(const std::string &name, Mode openMode,
     {
         CheckFile("couldn't open file " + m_Name + ", in call to POSIX open");
         m_IsOpen = true;
+        OpenDirect();
     }
 
     if (chainComm.Rank() < chainComm.Size() - 1)
@@ -248,6 +325,13 @@ void FilePOSIX::Write(const char *buffer, size_t size, size_t start)
     };
 
     WaitForOpen();
+    if (m_DirectIO)
+    {
+        const core::iovec iov = {buffer, size};
+        WriteV(&iov, 1, start);
+        return;
+    }
+
     if (start != MaxSizeT)
     {
         errno = 0;
@@ -285,101 +369,156 @@ void FilePOSIX::Write(const char *buffer, size_t size, size_t start)
     {
         lf_Write(buffer, size);
     }
+    WriteBehind(start, size);
 }
 
-#ifdef REALLY_WANT_WRITEV
 void FilePOSIX::WriteV(const core::iovec *iov, const int iovcnt, size_t start)
 {
-    auto lf_Write = [&](const core::iovec *iov, const int iovcnt) {
-        ProfilerStart("write");
-        errno = 0;
-        size_t nBytesExpected = 0;
-        for (int i = 0; i < iovcnt; ++i)
-        {
-            nBytesExpected += iov[i].iov_len;
-        }
-        const iovec *v = reinterpret_cast<const iovec *>(iov);
-        const auto ret = writev(m_FileDescriptor, v, iovcnt);
-        m_Errno = errno;
-        ProfilerStop("write");
+    WaitForOpen();
+    start = SkipV(iov, iovcnt, start);
+    if (m_DirectIO)
+    {
+        WriteDirect(iov, iovcnt, start);
+    }
+    else
+    {
+        WriteBehind(start, TransferV(iov, iovcnt, start, true));
+    }
+}
 
-        size_t written;
-        if (ret == -1)
+void FilePOSIX::ReadV(const core::iovec *iov, const int iovcnt, size_t start)
+{
+    WaitForOpen();
+    start = SkipV(iov, iovcnt, start);
+    TransferV(iov, iovcnt, start, false);
+}
+
+size_t FilePOSIX::SkipV(const core::iovec *iov, const int iovcnt,
+                        const size_t start)
+{
+    size_t size = 0;
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        size += iov[i].iov_len;
+    }
+    errno = 0;
+    const off_t end =
+        (start == MaxSizeT)
+            ? lseek(m_FileDescriptor, static_cast<off_t>(size), SEEK_CUR)
+            : lseek(m_FileDescriptor, static_cast<off_t>(start + size),
+                    SEEK_SET);
+    m_Errno = errno;
+    if (end == -1)
+    {
+        throw std::ios_base::failure(
+            "ERROR: couldn't move past a vectored transfer of " +
+            std::to_string(size) + " bytes in file " + m_Name +
+            ", in call to POSIX lseek" + SysErrMsg());
+    }
+    return static_cast<size_t>(end) - size;
+}
+
+size_t FilePOSIX::TransferV(const core::iovec *iov, const int iovcnt,
+                            size_t offset, const bool isWrite)
+{
+#ifdef IOV_MAX
+    const size_t maxBatch = IOV_MAX;
+#else
+    const size_t maxBatch = 1024;
+#endif
+    const char *timer = isWrite ? "write" : "read";
+
+    std::vector<iovec> batch;
+    batch.reserve(std::min(maxBatch, static_cast<size_t>(iovcnt)));
+    size_t transferred = 0;
+    int c = 0;
+    // bytes of iov[c] already transferred after a short pwritev/preadv
+    size_t done = 0;
+    while (true)
+    {
+        while (c < iovcnt && iov[c].iov_len == done)
         {
-            if (errno != EINTR)
-            {
-                throw std::ios_base::failure(
-                    "ERROR: couldn't write to file " + m_Name +
-                    ", in call to POSIX Write(iovec)" + SysErrMsg());
-            }
-            written = 0;
+            ++c;
+            done = 0;
         }
-        else
+        if (c == iovcnt)
         {
-            written = static_cast<size_t>(ret);
+            break;
         }
 
-        if (written < nBytesExpected)
+        batch.clear();
+        for (int k = c; k < iovcnt && batch.size() < maxBatch; ++k)
         {
-            /* Fall back to write calls with individual buffers */
-            // find where the writing has ended
-            int c = 0;
-            size_t n = 0;
-            size_t pos = 0;
-            while (n < written)
+            const size_t skip = (k == c) ? done : 0;
+            if (iov[k].iov_len > skip)
             {
-                if (n + iov[c].iov_len <= written)
-                {
-                    n += iov[c].iov_len;
-                    ++c;
-                }
-                else
-                {
-                    pos = written - n;
-                    n = written;
-                }
-            }
-
-            // write the rest one by one
-            Write(static_cast<const char *>(iov[c].iov_base) + pos,
-                  iov[c].iov_len - pos);
-            for (; c < iovcnt; ++c)
-            {
-                Write(static_cast<const char *>(iov[c].iov_base),
-                      iov[c].iov_len);
+                iovec v;
+                v.iov_base =
+                    static_cast<char *>(const_cast<void *>(iov[k].iov_base)) +
+                    skip;
+                v.iov_len = iov[k].iov_len - skip;
+                batch.push_back(v);
             }
         }
-    };
 
-    WaitForOpen();
-    if (start != MaxSizeT)
-    {
+        ProfilerStart(timer);
         errno = 0;
-        const auto newPosition = lseek(m_FileDescriptor, start, SEEK_SET);
+        const auto ret =
+            isWrite ? pwritev(m_FileDescriptor, batch.data(),
+                              static_cast<int>(batch.size()),
+                              static_cast<off_t>(offset))
+                    : preadv(m_FileDescriptor, batch.data(),
+                             static_cast<int>(batch.size()),
+                             static_cast<off_t>(offset));
         m_Errno = errno;
+        ProfilerStop(timer);
 
-        if (static_cast<size_t>(newPosition) != start)
+        if (ret == -1)
         {
+            if (errno == EINTR)
+            {
+                continue;
+            }
             throw std::ios_base::failure(
-                "ERROR: couldn't move to start position " +
-                std::to_string(start) + " in file " + m_Name +
-                ", in call to POSIX lseek" + SysErrMsg());
+                "ERROR: couldn't " +
+                std::string(isWrite ? "write to" : "read from") + " file " +
+                m_Name + " at offset " + std::to_string(offset) +
+                ", in call to POSIX " + (isWrite ? "pwritev" : "preadv") +
+                SysErrMsg());
+        }
+        if (ret == 0)
+        {
+            throw std::ios_base::failure(
+                "ERROR: couldn't " +
+                std::string(isWrite ? "write to" : "read from") + " file " +
+                m_Name + " at offset " + std::to_string(offset) +
+                ", in call to POSIX " + (isWrite ? "pwritev" : "preadv") +
+                (isWrite ? ", no bytes written" : ", end of file reached"));
         }
-    }
 
-    int cntTotal = 0;
-    while (cntTotal < iovcnt)
-    {
-        int cnt = iovcnt - cntTotal;
-        if (cnt > 8)
+        // skip over what was transferred, a short transfer continues in
+        // the middle of an entry
+        size_t n = static_cast<size_t>(ret);
+        offset += n;
+        transferred += n;
+        while (n > 0)
         {
-            cnt = 8;
+            const size_t left = iov[c].iov_len - done;
+            if (n >= left)
+            {
+                n -= left;
+                ++c;
+                done = 0;
+            }
+            else
+            {
+                done += n;
+                n = 0;
+            }
         }
-        lf_Write(iov + cntTotal, cnt);
-        cntTotal += cnt;
     }
+    return transferred;
 }
-#endif
 
 void FilePOSIX::Read(char *buffer, size_t size, size_t start)
 {
@@ -476,7 +615,13 @@ void FilePOSIX::Flush()
 void FilePOSIX::Close()
 {
     WaitForOpen();
+    WriteBehindClose();
     ProfilerStart("close");
+    if (m_DirectFileDescriptor != -1)
+    {
+        close(m_DirectFileDescriptor);
+        m_DirectFileDescriptor = -1;
+    }
     errno = 0;
     const int status = close(m_FileDescriptor);
     m_Errno = errno;
@@ -502,6 +647,216 @@ void FilePOSIX::Delete()
     std::remove(m_Name.c_str());
 }
 
+size_t FilePOSIX::WriteDirect(const core::iovec *iov, const int iovcnt,
+                              const size_t start)
+{
+    const size_t align = m_DirectIOAlignment;
+    size_t total = 0;
+    for (int c = 0; c < iovcnt; ++c)
+    {
+        total += iov[c].iov_len;
+    }
+    const size_t end = start + total;
+    // [alignedStart, alignedEnd) is written with O_DIRECT, the unaligned
+    // head and tail through the page cache. They never share a block with
+    // the direct part, and writers of neighbouring ranges in the same file
+    // are not clobbered the way padding the tail to a full block would.
+    const size_t alignedStart =
+        std::min((start + align - 1) / align * align, end);
+    const size_t alignedEnd = std::max(end / align * align, alignedStart);
+
+    if (!m_Bounce)
+    {
+        void *p = nullptr;
+        m_BounceSize = std::max(align, DirectIOBounceSize / align * align);
+        if (posix_memalign(&p, align, m_BounceSize) != 0)
+        {
+            throw std::ios_base::failure(
+                "ERROR: couldn't allocate the direct I/O staging buffer for "
+                "file " +
+                m_Name);
+        }
+        m_Bounce = static_cast<char *>(p);
+    }
+
+    // walks the iovec entries, copying or handing out contiguous pieces
+    int c = 0;
+    size_t done = 0;
+    auto lf_Gather = [&](char *dest, size_t n) {
+        while (n > 0)
+        {
+            const size_t len = std::min(n, iov[c].iov_len - done);
+            std::memcpy(dest,
+                        static_cast<const char *>(iov[c].iov_base) + done,
+                        len);
+            dest += len;
+            n -= len;
+            done += len;
+            if (done == iov[c].iov_len)
+            {
+                ++c;
+                done = 0;
+            }
+        }
+    };
+    auto lf_SkipEmpty = [&]() {
+        while (c < iovcnt && iov[c].iov_len == done)
+        {
+            ++c;
+            done = 0;
+        }
+    };
+
+    ProfilerStart("write");
+    if (alignedStart > start)
+    {
+        const size_t n = alignedStart - start;
+        lf_Gather(m_Bounce, n);
+        PWriteAll(m_FileDescriptor, m_Bounce, n, start);
+    }
+
+    size_t pos = alignedStart;
+    while (pos < alignedEnd)
+    {
+        lf_SkipEmpty();
+        const char *src = static_cast<const char *>(iov[c].iov_base) + done;
+        const size_t left = std::min(iov[c].iov_len - done, alignedEnd - pos);
+        size_t n;
+        if ((reinterpret_cast<uintptr_t>(src) % align == 0) && (left >= align))
+        {
+            // already aligned in memory, no copy
+            n = left / align * align;
+            PWriteAll(m_DirectFileDescriptor, src, n, pos);
+            done += n;
+            if (done == iov[c].iov_len)
+            {
+                ++c;
+                done = 0;
+            }
+        }
+        else
+        {
+            n = std::min(m_BounceSize, alignedEnd - pos);
+            lf_Gather(m_Bounce, n);
+            PWriteAll(m_DirectFileDescriptor, m_Bounce, n, pos);
+        }
+        pos += n;
+    }
+
+    if (end > alignedEnd)
+    {
+        lf_SkipEmpty();
+        const size_t n = end - alignedEnd;
+        lf_Gather(m_Bounce, n);
+        PWriteAll(m_FileDescriptor, m_Bounce, n, alignedEnd);
+    }
+    ProfilerStop("write");
+    return total;
+}
+
+void FilePOSIX::PWriteAll(const int fd, const char *buffer, size_t size,
+                          size_t offset)
+{
+    while (size > 0)
+    {
+        errno = 0;
+        const auto written =
+            pwrite(fd, buffer, size, static_cast<off_t>(offset));
+        m_Errno = errno;
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::ios_base::failure(
+                "ERROR: couldn't write to file " + m_Name + " at offset " +
+                std::to_string(offset) + ", in call to POSIX pwrite" +
+                (fd == m_DirectFileDescriptor ? " (direct I/O)" : "") +
+                SysErrMsg());
+        }
+        buffer += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+}
+
+void FilePOSIX::WriteBehind(const size_t start, const size_t size)
+{
+    if (m_WriteBehindSize == 0 || size == 0)
+    {
+        return;
+    }
+    m_WriteBehindBegin = std::min(m_WriteBehindBegin, start);
+    m_WriteBehindEnd = std::max(m_WriteBehindEnd, start + size);
+    m_WriteBehindBytes += size;
+    if (m_WriteBehindBytes >= m_WriteBehindSize)
+    {
+        WriteBehindStep();
+    }
+}
+
+void FilePOSIX::WriteBehindStep()
+{
+    // Failures below only mean the pages stay dirty or cached a bit longer,
+    // so they are not reported
+    ProfilerStart("writebehind");
+#ifdef SYNC_FILE_RANGE_WRITE
+    if (m_WriteBehindEnd > m_WriteBehindBegin)
+    {
+        // start writeback of what was just written, without waiting
+        sync_file_range(
+            m_FileDescriptor, static_cast<off64_t>(m_WriteBehindBegin),
+            static_cast<off64_t>(m_WriteBehindEnd - m_WriteBehindBegin),
+            SYNC_FILE_RANGE_WRITE);
+    }
+#endif
+    if (m_WriteBehindPrevEnd > m_WriteBehindPrevBegin)
+    {
+        const size_t length = m_WriteBehindPrevEnd - m_WriteBehindPrevBegin;
+#ifdef SYNC_FILE_RANGE_WRITE
+        // the previous range had a whole step to be written out, wait for
+        // its last pages so that DONTNEED can drop all of them
+        sync_file_range(m_FileDescriptor,
+                        static_cast<off64_t>(m_WriteBehindPrevBegin),
+                        static_cast<off64_t>(length),
+                        SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE |
+                            SYNC_FILE_RANGE_WAIT_AFTER);
+#endif
+#ifdef POSIX_FADV_DONTNEED
+        posix_fadvise(m_FileDescriptor,
+                      static_cast<off_t>(m_WriteBehindPrevBegin),
+                      static_cast<off_t>(length), POSIX_FADV_DONTNEED);
+#endif
+    }
+    ProfilerStop("writebehind");
+
+    if (m_WriteBehindEnd > m_WriteBehindBegin)
+    {
+        m_WriteBehindPrevBegin = m_WriteBehindBegin;
+        m_WriteBehindPrevEnd = m_WriteBehindEnd;
+    }
+    else
+    {
+        m_WriteBehindPrevBegin = m_WriteBehindPrevEnd = 0;
+    }
+    m_WriteBehindBegin = MaxSizeT;
+    m_WriteBehindEnd = 0;
+    m_WriteBehindBytes = 0;
+}
+
+void FilePOSIX::WriteBehindClose()
+{
+    if (m_WriteBehindSize == 0 || m_OpenMode == Mode::Read)
+    {
+        return;
+    }
+    // the first step starts writeback of the last, partial range and evicts
+    // the previous one, the second evicts the last range
+    WriteBehindStep();
+    WriteBehindStep();
+}
+
 void FilePOSIX::CheckFile(const std::string hint) const
 {
     if (m_FileDescriptor == -1)
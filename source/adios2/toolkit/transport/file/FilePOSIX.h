@@ -34,6 +34,16 @@ public:
 
     ~FilePOSIX();
 
+    /**
+     * DirectIO=true: write the block aligned part of every write with
+     * O_DIRECT, bypassing the page cache. Default false.
+     * DirectIOAlignment: block size for O_DIRECT, default 4096
+     * WriteBehindSize: every time this many bytes (e.g. 64Mb) have been
+     * written, start writeback of them and drop the previous ones from the
+     * page cache, default 0 (off)
+     */
+    void SetParameters(const Params &parameters) final;
+
     void Open(const std::string &name, const Mode openMode,
               const bool async = false) final;
 
@@ -43,14 +53,16 @@ public:
 
     void Write(const char *buffer, size_t size, size_t start = MaxSizeT) final;
 
-#ifdef REALLY_WANT_WRITEV
-    /* Actual writev() function, inactive for now */
+    /** One pwritev call per IOV_MAX entries, at start without lseek */
     void WriteV(const core::iovec *iov, const int iovcnt,
                 size_t start = MaxSizeT) final;
-#endif
 
     void Read(char *buffer, size_t size, size_t start = MaxSizeT) final;
 
+    /** One preadv call per IOV_MAX entries, at start without lseek */
+    void ReadV(const core::iovec *iov, const int iovcnt,
+               size_t start = MaxSizeT) final;
+
     size_t GetSize() final;
 
     /** Does nothing, each write is supposed to flush */
@@ -77,13 +89,52 @@ private:
     bool m_IsOpening = false;
     std::future<int> m_OpenFuture;
 
+    bool m_DirectIO = false;
+    size_t m_DirectIOAlignment = 4096;
+    /** second handle on the file opened with O_DIRECT, -1 if not used */
+    int m_DirectFileDescriptor = -1;
+    /** aligned staging buffer for direct writes */
+    char *m_Bounce = nullptr;
+    size_t m_BounceSize = 0;
+
+    size_t m_WriteBehindSize = 0;
+    /** range written since the last write-behind step */
+    size_t m_WriteBehindBegin = MaxSizeT;
+    size_t m_WriteBehindEnd = 0;
+    size_t m_WriteBehindBytes = 0;
+    /** range whose writeback was started in the last write-behind step */
+    size_t m_WriteBehindPrevBegin = 0;
+    size_t m_WriteBehindPrevEnd = 0;
+
     /**
      * Check if m_FileDescriptor is -1 after an operation
      * @param hint exception message
      */
     void CheckFile(const std::string hint) const;
     void WaitForOpen();
+    void OpenDirect();
     std::string SysErrMsg() const;
+    /** pwritev/preadv do not move the file position: a single lseek moves
+     * it past the transfer (from start, or from the current position if
+     * start is MaxSizeT) and returns where the transfer begins */
+    size_t SkipV(const core::iovec *iov, const int iovcnt, const size_t start);
+    /** pwritev/preadv loop from offset, resumes after short transfers,
+     * returns the bytes transferred */
+    size_t TransferV(const core::iovec *iov, const int iovcnt, size_t offset,
+                     const bool isWrite);
+    /** DirectIO version of WriteV, returns the bytes written */
+    size_t WriteDirect(const core::iovec *iov, const int iovcnt,
+                       const size_t start);
+    void PWriteAll(const int fd, const char *buffer, size_t size,
+                   size_t offset);
+    /** records a buffered write, calls WriteBehindStep every
+     * m_WriteBehindSize bytes */
+    void WriteBehind(const size_t start, const size_t size);
+    /** starts writeback of the range written since the last step, waits for
+     * the range of the last step and drops it from the page cache */
+    void WriteBehindStep();
+    /** two last steps, so nothing written is left in the page cache */
+    void WriteBehindClose();
 };
 
 } // end namespace transport
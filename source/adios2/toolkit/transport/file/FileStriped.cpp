@@ -0,0 +1,336 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileStriped.cpp one logical file striped round-robin over files on several
+ * devices, each accessed with the POSIX transport
+ */
+#include "FileStriped.h"
+#include "FilePOSIX.h"
+
+#include "adios2/helper/adiosFunctions.h" // CreateDirectory, StringTo
+
+#include <algorithm> // std::min, std::max
+#include <sstream>   // std::getline
+
+/// \cond EXCLUDE_FROM_DOXYGEN
+#include <ios> //std::ios_base::failure
+/// \endcond
+
+namespace adios2
+{
+namespace transport
+{
+
+FileStriped::FileStriped(helper::Comm const &comm)
+: Transport("File", "striped", comm)
+{
+}
+
+FileStriped::~FileStriped() = default;
+
+void FileStriped::SetParameters(const Params &parameters)
+{
+    for (const auto &pair : parameters)
+    {
+        const std::string key = helper::LowerCase(pair.first);
+
+        if (key == "stripepaths")
+        {
+            m_StripePaths.clear();
+            std::istringstream paths(pair.second);
+            std::string path;
+            while (std::getline(paths, path, ','))
+            {
+                path.erase(0, path.find_first_not_of(" \t"));
+                path.erase(path.find_last_not_of(" \t") + 1);
+                if (!path.empty())
+                {
+                    m_StripePaths.push_back(helper::RemoveTrailingSlash(path));
+                }
+            }
+        }
+        else if (key == "stripesize")
+        {
+            m_StripeSize = helper::StringToByteUnits(
+                helper::LowerCase(pair.second),
+                " in Parameter key=StripeSize");
+            if (m_StripeSize == 0)
+            {
+                throw std::invalid_argument(
+                    "ERROR: StripeSize must be larger than 0, in call to "
+                    "striped SetParameters\n");
+            }
+        }
+        else
+        {
+            m_StripeParameters[pair.first] = pair.second;
+        }
+    }
+}
+
+void FileStriped::Open(const std::string &name, const Mode openMode,
+                       const bool async)
+{
+    OpenStripes(name, openMode, nullptr, async);
+}
+
+void FileStriped::OpenChain(const std::string &name, Mode openMode,
+                            const helper::Comm &chainComm, const bool async)
+{
+    OpenStripes(name, openMode, &chainComm, async);
+}
+
+void FileStriped::Write(const char *buffer, size_t size, size_t start)
+{
+    const core::iovec iov = {buffer, size};
+    Transfer(&iov, 1, start, true);
+}
+
+void FileStriped::WriteV(const core::iovec *iov, const int iovcnt,
+                         size_t start)
+{
+    Transfer(iov, iovcnt, start, true);
+}
+
+void FileStriped::Read(char *buffer, size_t size, size_t start)
+{
+    const core::iovec iov = {buffer, size};
+    Transfer(&iov, 1, start, false);
+}
+
+void FileStriped::ReadV(const core::iovec *iov, const int iovcnt,
+                        size_t start)
+{
+    Transfer(iov, iovcnt, start, false);
+}
+
+size_t FileStriped::GetSize()
+{
+    const size_t nStripes = m_Stripes.size();
+    size_t size = 0;
+    for (size_t s = 0; s < nStripes; ++s)
+    {
+        const size_t stripeSize = m_Stripes[s]->GetSize();
+        if (stripeSize == 0)
+        {
+            continue;
+        }
+        // logical position of the last byte of this stripe file
+        const size_t last = stripeSize - 1;
+        const size_t row = last / m_StripeSize;
+        const size_t logicalLast =
+            (row * nStripes + s) * m_StripeSize + last % m_StripeSize;
+        size = std::max(size, logicalLast + 1);
+    }
+    return size;
+}
+
+void FileStriped::Flush()
+{
+    for (auto &stripe : m_Stripes)
+    {
+        stripe->Flush();
+    }
+}
+
+void FileStriped::Close()
+{
+    ProfilerStart("close");
+    for (auto &stripe : m_Stripes)
+    {
+        stripe->Close();
+    }
+    ProfilerStop("close");
+    m_IsOpen = false;
+}
+
+void FileStriped::Delete()
+{
+    for (auto &stripe : m_Stripes)
+    {
+        stripe->Delete();
+    }
+    m_IsOpen = false;
+}
+
+void FileStriped::SeekToEnd() { m_Offset = GetSize(); }
+
+void FileStriped::SeekToBegin() { m_Offset = 0; }
+
+void FileStriped::Seek(const size_t start)
+{
+    if (start != MaxSizeT)
+    {
+        m_Offset = start;
+    }
+    else
+    {
+        SeekToEnd();
+    }
+}
+
+void FileStriped::Truncate(const size_t length)
+{
+    const size_t nStripes = m_Stripes.size();
+    const size_t rowSize = m_StripeSize * nStripes;
+    const size_t fullRows = length / rowSize;
+    const size_t lastRow = length % rowSize;
+    for (size_t s = 0; s < nStripes; ++s)
+    {
+        // bytes of stripe s in the last, partial row
+        const size_t stripeBegin = s * m_StripeSize;
+        const size_t inLastRow =
+            (lastRow > stripeBegin)
+                ? std::min(lastRow - stripeBegin, m_StripeSize)
+                : 0;
+        m_Stripes[s]->Truncate(fullRows * m_StripeSize + inLastRow);
+    }
+}
+
+void FileStriped::MkDir(const std::string & /*fileName*/) {}
+
+void FileStriped::OpenStripes(const std::string &name, const Mode openMode,
+                              const helper::Comm *chainComm, const bool async)
+{
+    m_Name = name;
+    CheckName();
+    m_OpenMode = openMode;
+    if (m_StripePaths.empty())
+    {
+        throw std::invalid_argument("ERROR: striped transport requires the "
+                                    "StripePaths parameter, file " +
+                                    m_Name + ", in call to striped open\n");
+    }
+
+    m_Stripes.clear();
+    for (size_t s = 0; s < m_StripePaths.size(); ++s)
+    {
+        const std::string stripeName = StripeName(s);
+        if (m_OpenMode != Mode::Read)
+        {
+            helper::CreateDirectory(
+                stripeName.substr(0, stripeName.rfind('/')));
+        }
+        m_Stripes.emplace_back(new FilePOSIX(m_Comm));
+        m_Stripes.back()->SetParameters(m_StripeParameters);
+        if (chainComm)
+        {
+            // each stripe file is created by the first process of the chain
+            m_Stripes.back()->OpenChain(stripeName, m_OpenMode, *chainComm,
+                                        async);
+        }
+        else
+        {
+            m_Stripes.back()->Open(stripeName, m_OpenMode, async);
+        }
+    }
+    m_IsOpen = true;
+    m_Offset = (m_OpenMode == Mode::Append) ? GetSize() : 0;
+}
+
+std::string FileStriped::StripeName(const size_t stripe) const
+{
+    if (!m_Name.empty() && m_Name[0] == '/')
+    {
+        return m_StripePaths[stripe] + m_Name;
+    }
+    return m_StripePaths[stripe] + "/" + m_Name;
+}
+
+void FileStriped::MapToStripes(
+    const core::iovec *iov, const int iovcnt, size_t start,
+    std::vector<std::vector<core::iovec>> &stripeIOV,
+    std::vector<size_t> &stripeStarts) const
+{
+    const size_t nStripes = m_Stripes.size();
+    stripeIOV.assign(nStripes, std::vector<core::iovec>());
+    stripeStarts.assign(nStripes, 0);
+
+    for (int c = 0; c < iovcnt; ++c)
+    {
+        const char *data = static_cast<const char *>(iov[c].iov_base);
+        size_t size = iov[c].iov_len;
+        while (size > 0)
+        {
+            const size_t stripeBlock = start / m_StripeSize;
+            const size_t stripe = stripeBlock % nStripes;
+            const size_t inBlock = start % m_StripeSize;
+            const size_t length = std::min(size, m_StripeSize - inBlock);
+
+            // a contiguous logical range is contiguous in each stripe file
+            if (stripeIOV[stripe].empty())
+            {
+                stripeStarts[stripe] =
+                    (stripeBlock / nStripes) * m_StripeSize + inBlock;
+            }
+            stripeIOV[stripe].push_back({data, length});
+
+            data += length;
+            size -= length;
+            start += length;
+        }
+    }
+}
+
+void FileStriped::ForEachStripe(
+    const std::vector<std::vector<core::iovec>> &stripeIOV, const size_t size,
+    const std::function<void(const size_t)> &function)
+{
+    std::vector<size_t> active;
+    for (size_t s = 0; s < stripeIOV.size(); ++s)
+    {
+        if (!stripeIOV[s].empty())
+        {
+            active.push_back(s);
+        }
+    }
+    if (size <= m_StripeSize)
+    {
+        // at most two stripes, not worth handing one to a worker
+        for (const size_t s : active)
+        {
+            function(s);
+        }
+        return;
+    }
+    m_Workers.Run(active.size(),
+                  [&](const size_t i) { function(active[i]); });
+}
+
+void FileStriped::Transfer(const core::iovec *iov, const int iovcnt,
+                           size_t start, const bool isWrite)
+{
+    if (start == MaxSizeT)
+    {
+        start = m_Offset;
+    }
+    size_t size = 0;
+    for (int c = 0; c < iovcnt; ++c)
+    {
+        size += iov[c].iov_len;
+    }
+
+    std::vector<std::vector<core::iovec>> stripeIOV;
+    std::vector<size_t> stripeStarts;
+    MapToStripes(iov, iovcnt, start, stripeIOV, stripeStarts);
+
+    ProfilerStart(isWrite ? "write" : "read");
+    ForEachStripe(stripeIOV, size, [&](const size_t s) {
+        const int count = static_cast<int>(stripeIOV[s].size());
+        if (isWrite)
+        {
+            m_Stripes[s]->WriteV(stripeIOV[s].data(), count, stripeStarts[s]);
+        }
+        else
+        {
+            m_Stripes[s]->ReadV(stripeIOV[s].data(), count, stripeStarts[s]);
+        }
+    });
+    ProfilerStop(isWrite ? "write" : "read");
+
+    m_Offset = start + size;
+}
+
+} // end namespace transport
+} // end namespace adios2
@@ -0,0 +1,125 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * FileStriped.h one logical file striped round-robin over files on several
+ * devices, each accessed with the POSIX transport
+ */
+
+#ifndef ADIOS2_TOOLKIT_TRANSPORT_FILE_FILESTRIPED_H_
+#define ADIOS2_TOOLKIT_TRANSPORT_FILE_FILESTRIPED_H_
+
+#include <functional> //std::function
+#include <memory>     //std::unique_ptr
+#include <vector>
+
+#include "adios2/common/ADIOSConfig.h"
+#include "adios2/helper/adiosThreads.h"
+#include "adios2/toolkit/transport/Transport.h"
+
+namespace adios2
+{
+namespace helper
+{
+class Comm;
+}
+namespace transport
+{
+
+class FilePOSIX;
+
+/**
+ * File transport selected with {"Library", "striped"}. Byte k of the logical
+ * file lives in stripe (k / StripeSize) % N, stored as
+ * StripePaths[stripe] + "/" + name. Reads and writes touching several
+ * stripes access them in parallel, one thread per stripe.
+ * Parameters:
+ *   StripePaths  comma separated list of N directories, required
+ *   StripeSize   bytes per stripe, default 1Mb
+ * All other parameters are passed to the POSIX transport of each stripe.
+ * Readers must use the same StripePaths and StripeSize.
+ */
+class FileStriped : public Transport
+{
+
+public:
+    FileStriped(helper::Comm const &comm);
+
+    ~FileStriped();
+
+    void SetParameters(const Params &parameters) final;
+
+    void Open(const std::string &name, const Mode openMode,
+              const bool async = false) final;
+
+    void OpenChain(const std::string &name, Mode openMode,
+                   const helper::Comm &chainComm,
+                   const bool async = false) final;
+
+    void Write(const char *buffer, size_t size, size_t start = MaxSizeT) final;
+
+    void WriteV(const core::iovec *iov, const int iovcnt,
+                size_t start = MaxSizeT) final;
+
+    void Read(char *buffer, size_t size, size_t start = MaxSizeT) final;
+
+    void ReadV(const core::iovec *iov, const int iovcnt,
+               size_t start = MaxSizeT) final;
+
+    /** logical size, computed from the sizes of the stripe files */
+    size_t GetSize() final;
+
+    void Flush() final;
+
+    void Close() final;
+
+    void Delete() final;
+
+    void SeekToEnd() final;
+
+    void SeekToBegin() final;
+
+    void Seek(const size_t start = MaxSizeT) final;
+
+    void Truncate(const size_t length) final;
+
+    void MkDir(const std::string &fileName) final;
+
+private:
+    std::vector<std::string> m_StripePaths;
+    size_t m_StripeSize = 1024 * 1024;
+    /** parameters passed on to the stripe transports */
+    Params m_StripeParameters;
+
+    std::vector<std::unique_ptr<FilePOSIX>> m_Stripes;
+    /** threads transferring the stripes after the first */
+    helper::WorkerThreads m_Workers;
+    /** logical position used when start == MaxSizeT */
+    size_t m_Offset = 0;
+
+    /** opens all stripe files, in a chain if chainComm is not nullptr */
+    void OpenStripes(const std::string &name, const Mode openMode,
+                     const helper::Comm *chainComm, const bool async);
+
+    std::string StripeName(const size_t stripe) const;
+
+    /** maps [start, start + size) of the logical file to one iovec list per
+     * stripe, contiguous in the stripe file from stripeStarts[stripe] */
+    void MapToStripes(const core::iovec *iov, const int iovcnt, size_t start,
+                      std::vector<std::vector<core::iovec>> &stripeIOV,
+                      std::vector<size_t> &stripeStarts) const;
+
+    /** calls function(stripe) for every stripe with data, in parallel
+     * unless the transfer of size bytes is no larger than one stripe */
+    void ForEachStripe(const std::vector<std::vector<core::iovec>> &stripeIOV,
+                       const size_t size,
+                       const std::function<void(const size_t)> &function);
+
+    void Transfer(const core::iovec *iov, const int iovcnt, size_t start,
+                  const bool isWrite);
+};
+
+} // end namespace transport
+} // end namespace adios2
+
+#endif /* ADIOS2_TOOLKIT_TRANSPORT_FILE_FILESTRIPED_H_ */
@@ -18,11 +18,16 @@
 
 /// transports
 #ifndef _WIN32
+#include "adios2/toolkit/transport/file/FileMMap.h"
 #include "adios2/toolkit/transport/file/FilePOSIX.h"
+#include "adios2/toolkit/transport/file/FileStriped.h"
 #endif
 #ifdef ADIOS2_HAVE_DAOS
 #include "adios2/toolkit/transport/file/FileDaos.h"
 #endif
+#ifdef ADIOS2_HAVE_IOURING
+#include "adios2/toolkit/transport/file/FileIOUring.h"
+#endif
 #ifdef ADIOS2_HAVE_IME
 #include "adios2/toolkit/transport/file/FileIME.h"
 #endif
@@ -223,14 +228,8 @@ void TransportMan::WriteFiles(const char *buffer, const size_t size,
 {
     if (transportIndex == -1)
     {
-        for (auto &transportPair : m_Transports)
-        {
-            auto &transport = transportPair.second;
-            if (transport->m_Type == "File")
-            {
-                transport->Write(buffer, size);
-            }
-        }
+        WriteAllFiles(
+            [&](Transport &transport) { transport.Write(buffer, size); });
     }
     else
     {
@@ -246,14 +245,9 @@ void TransportMan::WriteFileAt(const char *buffer, const size_t size,
 {
     if (transportIndex == -1)
     {
-        for (auto &transportPair : m_Transports)
-        {
-            auto &transport = transportPair.second;
-            if (transport->m_Type == "File")
-            {
-                transport->Write(buffer, size, start);
-            }
-        }
+        WriteAllFiles([&](Transport &transport) {
+            transport.Write(buffer, size, start);
+        });
     }
     else
     {
@@ -269,14 +263,9 @@ void TransportMan::WriteFiles(const core::iovec *iov, const size_t iovcnt,
 {
     if (transportIndex == -1)
     {
-        for (auto &transportPair : m_Transports)
-        {
-            auto &transport = transportPair.second;
-            if (transport->m_Type == "File")
-            {
-                transport->WriteV(iov, static_cast<int>(iovcnt));
-            }
-        }
+        WriteAllFiles([&](Transport &transport) {
+            transport.WriteV(iov, static_cast<int>(iovcnt));
+        });
     }
     else
     {
@@ -292,14 +281,9 @@ void TransportMan::WriteFileAt(const core::iovec *iov, const size_t iovcnt,
 {
     if (transportIndex == -1)
     {
-        for (auto &transportPair : m_Transports)
-        {
-            auto &transport = transportPair.second;
-            if (transport->m_Type == "File")
-            {
-                transport->WriteV(iov, static_cast<int>(iovcnt), start);
-            }
-        }
+        WriteAllFiles([&](Transport &transport) {
+            transport.WriteV(iov, static_cast<int>(iovcnt), start);
+        });
     }
     else
     {
@@ -310,6 +294,32 @@ void TransportMan::WriteFileAt(const core::iovec *iov, const size_t iovcnt,
     }
 }
 
+void TransportMan::WriteAllFiles(
+    const std::function<void(Transport &transport)> &writeFunction)
+{
+    std::vector<Transport *> files;
+    for (auto &transportPair : m_Transports)
+    {
+        if (transportPair.second->m_Type == "File")
+        {
+            files.push_back(transportPair.second.get());
+        }
+    }
+
+    if (!m_ConcurrentWrites || files.size() < 2)
+    {
+        for (auto file : files)
+        {
+            writeFunction(*file);
+        }
+        return;
+    }
+
+    // each transport keeps its own position and profiler
+    m_Workers.Run(files.size(),
+                  [&](const size_t i) { writeFunction(*files[i]); });
+}
+
 void TransportMan::SeekToFileEnd(const int transportIndex)
 {
     if (transportIndex == -1)
@@ -415,6 +425,24 @@ void TransportMan::ReadFile(char *buffer, const size_t size, const size_t start,
     itTransport->second->Read(buffer, size, start);
 }
 
+void TransportMan::ReadFile(const core::iovec *iov, const size_t iovcnt,
+                            const size_t start, const size_t transportIndex)
+{
+    auto itTransport = m_Transports.find(transportIndex);
+    CheckFile(itTransport, ", in call to ReadFile with index " +
+                               std::to_string(transportIndex));
+    itTransport->second->ReadV(iov, static_cast<int>(iovcnt), start);
+}
+
+const char *TransportMan::MapFile(const size_t start, const size_t size,
+                                  const size_t transportIndex)
+{
+    auto itTransport = m_Transports.find(transportIndex);
+    CheckFile(itTransport, ", in call to MapFile with index " +
+                               std::to_string(transportIndex));
+    return itTransport->second->MapRange(start, size);
+}
+
 void TransportMan::FlushFiles(const int transportIndex)
 {
     if (transportIndex == -1)
@@ -438,6 +466,29 @@ void TransportMan::FlushFiles(const int transportIndex)
     }
 }
 
+void TransportMan::WaitForCompletion(const int transportIndex)
+{
+    if (transportIndex == -1)
+    {
+        for (auto &transportPair : m_Transports)
+        {
+            auto &transport = transportPair.second;
+
+            if (transport->m_Type == "File")
+            {
+                transport->WaitForCompletion();
+            }
+        }
+    }
+    else
+    {
+        auto itTransport = m_Transports.find(transportIndex);
+        CheckFile(itTransport, ", in call to WaitForCompletion with index " +
+                                   std::to_string(transportIndex));
+        itTransport->second->WaitForCompletion();
+    }
+}
+
 void TransportMan::CloseFiles(const int transportIndex)
 {
     if (transportIndex == -1)
@@ -569,6 +620,26 @@ std::shared_ptr<Transport> TransportMan::OpenFileTransport(
                     " transport does not support buffered I/O.");
             }
         }
+        else if (library == "mmap" || library == "MMap")
+        {
+            transport = std::make_shared<transport::FileMMap>(m_Comm);
+            if (lf_GetBuffered("false"))
+            {
+                throw std::invalid_argument(
+                    "ERROR: " + library +
+                    " transport does not support buffered I/O.");
+            }
+        }
+        else if (library == "striped" || library == "Striped")
+        {
+            transport = std::make_shared<transport::FileStriped>(m_Comm);
+            if (lf_GetBuffered("false"))
+            {
+                throw std::invalid_argument(
+                    "ERROR: " + library +
+                    " transport does not support buffered I/O.");
+            }
+        }
 #endif
 #ifdef ADIOS2_HAVE_DAOS
         else if (library == "Daos" || library == "daos")
@@ -582,6 +653,19 @@ std::shared_ptr<Transport> TransportMan::OpenFileTransport(
             }
         }
 #endif
+#ifdef ADIOS2_HAVE_IOURING
+        else if (library == "uring" || library == "io_uring" ||
+                 library == "IOUring")
+        {
+            transport = std::make_shared<transport::FileIOUring>(m_Comm);
+            if (lf_GetBuffered("false"))
+            {
+                throw std::invalid_argument(
+                    "ERROR: " + library +
+                    " transport does not support buffered I/O.");
+            }
+        }
+#endif
 #ifdef ADIOS2_HAVE_IME
         else if (library == "IME" || library == "ime")
         {
@@ -11,6 +11,7 @@
 #ifndef ADIOS2_TOOLKIT_TRANSPORT_TRANSPORTMANAGER_H_
 #define ADIOS2_TOOLKIT_TRANSPORT_TRANSPORTMANAGER_H_
 
+#include <functional> //std::function
 #include <future> //std::async, std::future
 #include <memory> //std::shared_ptr
 #include <string>
@@ -18,6 +19,7 @@
 #include <vector>
 
 #include "adios2/core/CoreTypes.h"
+#include "adios2/helper/adiosThreads.h"
 #include "adios2/toolkit/transport/Transport.h"
 
 namespace adios2
@@ -42,6 +44,13 @@ public:
      */
     std::unordered_map<size_t, std::shared_ptr<Transport>> m_Transports;
 
+    /**
+     * true: WriteFiles/WriteFileAt with transportIndex -1 write to all file
+     * transports at the same time, one thread each, and return when all are
+     * done. false (default): one transport after the other
+     */
+    bool m_ConcurrentWrites = false;
+
     /**
      * Unique base constructor
      * @param comm
@@ -174,6 +183,28 @@ public:
     void ReadFile(char *buffer, const size_t size, const size_t start = 0,
                   const size_t transportIndex = 0);
 
+    /**
+     * Read contiguous contents from a single file into several buffers,
+     * readv version
+     * @param iovec array pointer, iov_base are the destinations
+     * @param iovcnt number of entries
+     * @param start offset in file
+     * @param transportIndex
+     */
+    void ReadFile(const core::iovec *iov, const size_t iovcnt,
+                  const size_t start, const size_t transportIndex = 0);
+
+    /**
+     * Pointer to contents of a single file without copying them, if its
+     * transport supports it (e.g. mmap), valid until the file is closed
+     * @param start offset in file
+     * @param size
+     * @param transportIndex
+     * @return read-only pointer, nullptr if the transport can only Read
+     */
+    const char *MapFile(const size_t start, const size_t size,
+                        const size_t transportIndex = 0);
+
     /**
      * Flush file or files depending on transport index. Throws an exception
      * if transport is not a file when transportIndex > -1.
@@ -181,6 +212,14 @@ public:
      */
     void FlushFiles(const int transportIndex = -1);
 
+    /**
+     * Wait for the outstanding IWrite/IRead operations of file or files
+     * depending on transport index. Throws an exception if transport is not a
+     * file when transportIndex > -1.
+     * @param transportIndex -1: all transports, otherwise index in m_Transports
+     */
+    void WaitForCompletion(const int transportIndex = -1);
+
     /**
      * Close file or files depending on transport index. Throws an exception
      * if transport is not a file when transportIndex > -1.
@@ -217,6 +256,11 @@ public:
 protected:
     helper::Comm const &m_Comm;
 
+    /** calls writeFunction for every file transport, concurrently if
+     * m_ConcurrentWrites is set and there is more than one */
+    void WriteAllFiles(
+        const std::function<void(Transport &transport)> &writeFunction);
+
     std::shared_ptr<Transport>
     OpenFileTransport(const std::string &fileName, const Mode openMode,
                       const Params &parameters, const bool profile,
@@ -228,6 +272,9 @@ protected:
         const std::string hint) const;
 
     void WaitForAsync() const;
+
+    /** threads writing the file transports after the first */
+    helper::WorkerThreads m_Workers;
 };
 
 } // end namespace transport
@@ -11,6 +11,11 @@
 
 #include <adios2.h>
 
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
 #include <gtest/gtest.h>
 
 #include "../SmallTestData.h"
@@ -2082,6 +2087,353 @@ TEST_F(BPWriteReadTestADIOS2, ADIOS2BPWriteReadEmptyProcess)
 #endif
 }
 
+//******************************************************************************
+// Variables that are not written on every step
+//******************************************************************************
+
+TEST_F(BPWriteReadTestADIOS2, ADIOS2BPWriteReadIntermittentVariable)
+{
+    // "all" is written on every step, "odd" on odd steps only and "late"
+    // on steps 2 and 3, the reader must count only the steps written.
+    // Lazy metadata does not decode the steps at Open and counts from the
+    // step that introduced the variable to the last one.
+    const std::string fname("ADIOS2BPWriteReadIntermittentVariable.bp");
+
+    int mpiRank = 0, mpiSize = 1;
+    const size_t Nx = 4;
+    const size_t NSteps = 6;
+
+#if ADIOS2_USE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+#endif
+
+#if ADIOS2_USE_MPI
+    adios2::ADIOS adios(MPI_COMM_WORLD);
+#else
+    adios2::ADIOS adios;
+#endif
+    const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize)};
+    const adios2::Dims start{static_cast<size_t>(Nx * mpiRank)};
+    const adios2::Dims count{Nx};
+    {
+        adios2::IO io = adios.DeclareIO("IntermittentWrite");
+        if (!engineName.empty())
+        {
+            io.SetEngine(engineName);
+        }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+
+        auto var_all = io.DefineVariable<int32_t>("all", shape, start, count);
+        auto var_odd = io.DefineVariable<int32_t>("odd", shape, start, count);
+        auto var_late =
+            io.DefineVariable<int32_t>("late", shape, start, count);
+
+        adios2::Engine bpWriter = io.Open(fname, adios2::Mode::Write);
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            std::vector<int32_t> data(Nx, static_cast<int32_t>(step));
+            bpWriter.BeginStep();
+            bpWriter.Put(var_all, data.data(), adios2::Mode::Sync);
+            if (step % 2 == 1)
+            {
+                bpWriter.Put(var_odd, data.data(), adios2::Mode::Sync);
+            }
+            if (step == 2 || step == 3)
+            {
+                bpWriter.Put(var_late, data.data(), adios2::Mode::Sync);
+            }
+            bpWriter.EndStep();
+        }
+        bpWriter.Close();
+    }
+
+    {
+        adios2::IO io = adios.DeclareIO("IntermittentRead");
+        if (!engineName.empty())
+        {
+            io.SetEngine(engineName);
+        }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+
+        adios2::Engine bpReader =
+            io.Open(fname, adios2::Mode::ReadRandomAccess);
+        EXPECT_EQ(bpReader.Steps(), NSteps);
+
+        auto var_all = io.InquireVariable<int32_t>("all");
+        auto var_odd = io.InquireVariable<int32_t>("odd");
+        auto var_late = io.InquireVariable<int32_t>("late");
+        ASSERT_TRUE(var_all);
+        ASSERT_TRUE(var_odd);
+        ASSERT_TRUE(var_late);
+        const bool lazy =
+            (engineParameters.find("LazyMetadata=true") != std::string::npos) ||
+            (engineParameters.find("NodeSharedMetadata=true") !=
+             std::string::npos);
+        EXPECT_EQ(var_all.Steps(), NSteps);
+        EXPECT_EQ(var_odd.Steps(), lazy ? NSteps - 1 : 3);
+        EXPECT_EQ(var_late.Steps(), lazy ? NSteps - 2 : 2);
+
+        // the shape of a step is found whether or not it is decoded
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            var_all.SetStepSelection({step, 1});
+            EXPECT_EQ(var_all.Shape(), shape);
+            std::vector<int32_t> in;
+            bpReader.Get(var_all, in, adios2::Mode::Sync);
+            ASSERT_EQ(in.size(), Nx * mpiSize);
+            EXPECT_EQ(in[0], static_cast<int32_t>(step));
+        }
+
+        bpReader.Close();
+    }
+}
+
+TEST_F(BPWriteReadTestADIOS2, ADIOS2BPWriteReadDeferredMinMax)
+{
+    // deferred puts larger than MinDeferredSize, step 0 is copied by
+    // PerformPuts and then overwritten, step 1 is written at EndStep
+    const std::string fname("ADIOS2BPWriteReadDeferredMinMax.bp");
+
+    int mpiRank = 0, mpiSize = 1;
+    const size_t Nx = 1200000;
+    const size_t NSteps = 2;
+
+#if ADIOS2_USE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+#endif
+
+#if ADIOS2_USE_MPI
+    adios2::ADIOS adios(MPI_COMM_WORLD);
+#else
+    adios2::ADIOS adios;
+#endif
+    const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize)};
+    const adios2::Dims start{static_cast<size_t>(Nx * mpiRank)};
+    const adios2::Dims count{Nx};
+    auto lf_Value = [&](size_t step, int rank, size_t i) {
+        return static_cast<float>(step * 10 + rank) +
+               static_cast<float>(i) / static_cast<float>(Nx);
+    };
+    {
+        adios2::IO io = adios.DeclareIO("DeferredMinMaxWrite");
+        if (!engineName.empty())
+        {
+            io.SetEngine(engineName);
+        }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+
+        auto var = io.DefineVariable<float>("r32", shape, start, count);
+
+        adios2::Engine bpWriter = io.Open(fname, adios2::Mode::Write);
+        std::vector<float> data(Nx);
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            for (size_t i = 0; i < Nx; ++i)
+            {
+                data[i] = lf_Value(step, mpiRank, i);
+            }
+            bpWriter.BeginStep();
+            bpWriter.Put(var, data.data(), adios2::Mode::Deferred);
+            if (step == 0)
+            {
+                bpWriter.PerformPuts();
+                std::fill(data.begin(), data.end(), -1.0f);
+            }
+            bpWriter.EndStep();
+        }
+        bpWriter.Close();
+    }
+
+    {
+        adios2::IO io = adios.DeclareIO("DeferredMinMaxRead");
+        if (!engineName.empty())
+        {
+            io.SetEngine(engineName);
+        }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+
+        adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
+        std::vector<float> in;
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            ASSERT_EQ(bpReader.BeginStep(), adios2::StepStatus::OK);
+            auto var = io.InquireVariable<float>("r32");
+            ASSERT_TRUE(var);
+            EXPECT_EQ(var.Min(), lf_Value(step, 0, 0));
+            EXPECT_EQ(var.Max(), lf_Value(step, mpiSize - 1, Nx - 1));
+
+            var.SetSelection({start, count});
+            bpReader.Get(var, in, adios2::Mode::Sync);
+            ASSERT_EQ(in.size(), Nx);
+            EXPECT_EQ(in[0], lf_Value(step, mpiRank, 0));
+            EXPECT_EQ(in[Nx - 1], lf_Value(step, mpiRank, Nx - 1));
+            bpReader.EndStep();
+        }
+        bpReader.Close();
+    }
+}
+
+TEST_F(BPWriteReadTestADIOS2, ADIOS2BPWriteReadMetadataQueueFull)
+{
+    // one pending metadata write at most, EndStep waits for the metadata
+    // thread on every step
+    if (engineName != "BP5")
+    {
+        return;
+    }
+    const std::string fname("ADIOS2BPWriteReadMetadataQueueFull.bp");
+
+    int mpiRank = 0, mpiSize = 1;
+    const size_t Nx = 10;
+    const size_t NSteps = 50;
+
+#if ADIOS2_USE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+    adios2::ADIOS adios(MPI_COMM_WORLD);
+#else
+    adios2::ADIOS adios;
+#endif
+    const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize)};
+    const adios2::Dims start{static_cast<size_t>(Nx * mpiRank)};
+    const adios2::Dims count{Nx};
+    {
+        adios2::IO io = adios.DeclareIO("MetadataQueueWrite");
+        io.SetEngine(engineName);
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+        io.SetParameter("AsyncMetadataWrite", "true");
+        io.SetParameter("MaxQueuedMetadataWrites", "1");
+
+        auto var = io.DefineVariable<int32_t>("i32", shape, start, count);
+
+        adios2::Engine bpWriter = io.Open(fname, adios2::Mode::Write);
+        std::vector<int32_t> data(Nx);
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            std::iota(data.begin(), data.end(),
+                      static_cast<int32_t>(step * 100 + mpiRank * Nx));
+            bpWriter.BeginStep();
+            bpWriter.Put(var, data.data());
+            bpWriter.EndStep();
+        }
+        bpWriter.Close();
+    }
+
+    {
+        adios2::IO io = adios.DeclareIO("MetadataQueueRead");
+        io.SetEngine(engineName);
+
+        adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
+        std::vector<int32_t> in;
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            ASSERT_EQ(bpReader.BeginStep(), adios2::StepStatus::OK);
+            auto var = io.InquireVariable<int32_t>("i32");
+            ASSERT_TRUE(var);
+            var.SetSelection({start, count});
+            bpReader.Get(var, in, adios2::Mode::Sync);
+            bpReader.EndStep();
+            ASSERT_EQ(in.size(), Nx);
+            for (size_t i = 0; i < Nx; ++i)
+            {
+                ASSERT_EQ(in[i],
+                          static_cast<int32_t>(step * 100 + mpiRank * Nx + i));
+            }
+        }
+        EXPECT_EQ(bpReader.BeginStep(), adios2::StepStatus::EndOfStream);
+        bpReader.Close();
+    }
+}
+
+#ifndef _WIN32
+TEST_F(BPWriteReadTestADIOS2, ADIOS2BPWriteMetadataError)
+{
+    // md.0 hits the file size limit, with AsyncMetadataWrite the error of
+    // the metadata thread comes out of a later EndStep or Close
+    if (engineName != "BP5")
+    {
+        return;
+    }
+    int mpiRank = 0;
+#if ADIOS2_USE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    // only rank 0 writes metadata, a rank that throws leaves the others
+    // waiting in the collectives of EndStep
+    adios2::ADIOS adios(MPI_COMM_SELF);
+#else
+    adios2::ADIOS adios;
+#endif
+    const std::string fname("ADIOS2BPWriteMetadataError_" +
+                            std::to_string(mpiRank) + ".bp");
+    const rlim_t limit = 1024 * 1024;
+
+    struct rlimit oldLimit;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &oldLimit), 0);
+    if (oldLimit.rlim_cur != RLIM_INFINITY && oldLimit.rlim_cur < 4 * limit)
+    {
+        GTEST_SKIP() << "file size limit is below " << 4 * limit;
+    }
+
+    adios2::IO io = adios.DeclareIO("MetadataErrorWrite");
+    io.SetEngine(engineName);
+    if (!engineParameters.empty())
+    {
+        io.SetParameters(engineParameters);
+    }
+    auto var = io.DefineVariable<double>("r64", {10}, {0}, {10});
+    const std::vector<double> data(10, 1.0);
+    // attributes go into md.0 only, the data file stays small
+    const std::string big(2 * limit, 'x');
+
+    adios2::Engine bpWriter = io.Open(fname, adios2::Mode::Write);
+    bpWriter.BeginStep();
+    bpWriter.Put(var, data.data());
+    bpWriter.EndStep();
+
+    auto oldHandler = std::signal(SIGXFSZ, SIG_IGN);
+    struct rlimit newLimit = oldLimit;
+    newLimit.rlim_cur = limit;
+    ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &newLimit), 0);
+    bool failed = false;
+    try
+    {
+        for (size_t step = 1; step < 4; ++step)
+        {
+            bpWriter.BeginStep();
+            io.DefineAttribute<std::string>("big" + std::to_string(step),
+                                            big);
+            bpWriter.Put(var, data.data());
+            bpWriter.EndStep();
+        }
+        bpWriter.Close();
+    }
+    catch (std::ios_base::failure &)
+    {
+        failed = true;
+    }
+    setrlimit(RLIMIT_FSIZE, &oldLimit);
+    std::signal(SIGXFSZ, oldHandler);
+    EXPECT_TRUE(failed);
+}
+#endif
+
 //******************************************************************************
 // main
 //******************************************************************************
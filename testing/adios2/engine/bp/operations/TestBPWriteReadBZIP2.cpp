@@ -13,7 +13,8 @@
 
 #include <gtest/gtest.h>
 
-std::string engineName; // comes from command line
+std::string engineName;       // comes from command line
+std::string engineParameters; // comes from command line
 
 void BZIP2Accuracy1D(const std::string accuracy)
 {
@@ -57,6 +58,10 @@ void BZIP2Accuracy1D(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize)};
         const adios2::Dims start{static_cast<size_t>(Nx * mpiRank)};
@@ -101,6 +106,10 @@ void BZIP2Accuracy1D(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
 
@@ -193,6 +202,10 @@ void BZIP2Accuracy2D(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize), Ny};
         const adios2::Dims start{static_cast<size_t>(Nx * mpiRank), 0};
@@ -237,6 +250,10 @@ void BZIP2Accuracy2D(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
 
@@ -332,6 +349,10 @@ void BZIP2Accuracy3D(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize), Ny, Nz};
         const adios2::Dims start{static_cast<size_t>(Nx * mpiRank), 0, 0};
@@ -376,6 +397,10 @@ void BZIP2Accuracy3D(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
 
@@ -471,6 +496,10 @@ void BZIP2Accuracy1DSel(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize)};
         const adios2::Dims start{static_cast<size_t>(Nx * mpiRank)};
@@ -515,6 +544,10 @@ void BZIP2Accuracy1DSel(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
 
@@ -607,6 +640,10 @@ void BZIP2Accuracy2DSel(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize), Ny};
         const adios2::Dims start{static_cast<size_t>(Nx * mpiRank), 0};
@@ -651,6 +688,10 @@ void BZIP2Accuracy2DSel(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
 
@@ -746,6 +787,10 @@ void BZIP2Accuracy3DSel(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         const adios2::Dims shape{static_cast<size_t>(Nx * mpiSize), Ny, Nz};
         const adios2::Dims start{static_cast<size_t>(Nx * mpiRank), 0, 0};
@@ -790,6 +835,10 @@ void BZIP2Accuracy3DSel(const std::string accuracy)
             // Create the BP Engine
             io.SetEngine("BPFile");
         }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
 
         adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
 
@@ -845,6 +894,121 @@ void BZIP2Accuracy3DSel(const std::string accuracy)
     }
 }
 
+void BZIP2ManyBlocks(const std::string accuracy)
+{
+    // Each process writes NBlocks compressed blocks of Nx doubles per step,
+    // and every process reads the whole array, so that a reader has many
+    // blocks to decompress at once
+    const std::string fname("BPWRBZIP2ManyBlocks_" + accuracy + ".bp");
+
+    int mpiRank = 0, mpiSize = 1;
+    const size_t Nx = 1000;
+    const size_t NBlocks = 8;
+    const size_t NSteps = 3;
+
+#if ADIOS2_USE_MPI
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+#endif
+    const size_t Size = Nx * NBlocks * mpiSize;
+
+#if ADIOS2_USE_MPI
+    adios2::ADIOS adios(MPI_COMM_WORLD);
+#else
+    adios2::ADIOS adios;
+#endif
+    {
+        adios2::IO io = adios.DeclareIO("TestIO");
+
+        if (!engineName.empty())
+        {
+            io.SetEngine(engineName);
+        }
+        else
+        {
+            // Create the BP Engine
+            io.SetEngine("BPFile");
+        }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+
+        adios2::Variable<double> var_r64 =
+            io.DefineVariable<double>("r64", {Size}, {0}, {Nx});
+
+        adios2::Operator BZIP2Op =
+            adios.DefineOperator("BZIP2Compressor", adios2::ops::LosslessBZIP2);
+        var_r64.AddOperation(
+            BZIP2Op, {{adios2::ops::bzip2::key::blockSize100k, accuracy}});
+
+        adios2::Engine bpWriter = io.Open(fname, adios2::Mode::Write);
+
+        std::vector<double> r64s(Nx);
+        for (size_t step = 0; step < NSteps; ++step)
+        {
+            bpWriter.BeginStep();
+            for (size_t b = 0; b < NBlocks; ++b)
+            {
+                const size_t start = (mpiRank * NBlocks + b) * Nx;
+                std::iota(r64s.begin(), r64s.end(),
+                          static_cast<double>(start + step * Size));
+                var_r64.SetSelection({{start}, {Nx}});
+                bpWriter.Put(var_r64, r64s.data(), adios2::Mode::Sync);
+            }
+            bpWriter.EndStep();
+        }
+
+        bpWriter.Close();
+    }
+
+    {
+        adios2::IO io = adios.DeclareIO("ReadIO");
+
+        if (!engineName.empty())
+        {
+            io.SetEngine(engineName);
+        }
+        else
+        {
+            // Create the BP Engine
+            io.SetEngine("BPFile");
+        }
+        if (!engineParameters.empty())
+        {
+            io.SetParameters(engineParameters);
+        }
+
+        adios2::Engine bpReader = io.Open(fname, adios2::Mode::Read);
+
+        unsigned int t = 0;
+        std::vector<double> decompressedR64s;
+
+        while (bpReader.BeginStep() == adios2::StepStatus::OK)
+        {
+            auto var_r64 = io.InquireVariable<double>("r64");
+            EXPECT_TRUE(var_r64);
+            ASSERT_EQ(var_r64.Shape()[0], Size);
+
+            bpReader.Get(var_r64, decompressedR64s);
+            bpReader.EndStep();
+
+            ASSERT_EQ(decompressedR64s.size(), Size);
+            for (size_t i = 0; i < Size; ++i)
+            {
+                ASSERT_EQ(decompressedR64s[i],
+                          static_cast<double>(i + t * Size))
+                    << "t=" << t << " i=" << i << " rank=" << mpiRank;
+            }
+            ++t;
+        }
+
+        EXPECT_EQ(t, NSteps);
+
+        bpReader.Close();
+    }
+}
+
 class BPWriteReadBZIP2 : public ::testing::TestWithParam<std::string>
 {
 public:
@@ -877,6 +1041,10 @@ TEST_P(BPWriteReadBZIP2, ADIOS2BPWriteReadBZIP23DSel)
 {
     BZIP2Accuracy3DSel(GetParam());
 }
+TEST_P(BPWriteReadBZIP2, ADIOS2BPWriteReadBZIP2ManyBlocks)
+{
+    BZIP2ManyBlocks(GetParam());
+}
 
 INSTANTIATE_TEST_SUITE_P(
     BZIP2Accuracy, BPWriteReadBZIP2,
@@ -903,6 +1071,10 @@ int main(int argc, char **argv)
     {
         engineName = std::string(argv[1]);
     }
+    if (argc > 2)
+    {
+        engineParameters = std::string(argv[2]);
+    }
     result = RUN_ALL_TESTS();
 
 #if ADIOS2_USE_MPI
@@ -0,0 +1,214 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ */
+
+#include "TestSscCommon.h"
+#include <adios2.h>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mpi.h>
+#include <numeric>
+#include <thread>
+
+using namespace adios2;
+int mpiRank = 0;
+int mpiSize = 1;
+MPI_Comm mpiComm;
+
+class SscEngineTest : public ::testing::Test
+{
+public:
+    SscEngineTest() = default;
+};
+
+void Writer(const Dims &shape, const Dims &start, const Dims &count,
+            const size_t steps, const adios2::Params &engineParams,
+            const std::string &name, const bool discard)
+{
+    size_t datasize =
+        std::accumulate(count.begin(), count.end(), static_cast<size_t>(1),
+                        std::multiplies<size_t>());
+    adios2::ADIOS adios(mpiComm);
+    adios2::IO io = adios.DeclareIO("Test");
+    io.SetEngine("ssc");
+    io.SetParameters(engineParams);
+    std::vector<int> myInts(datasize);
+    std::vector<double> myDoubles(datasize);
+    auto bpInts = io.DefineVariable<int>("bpInts", shape, start, count);
+    auto bpDoubles =
+        io.DefineVariable<double>("bpDoubles", shape, start, count);
+    auto scalarInt = io.DefineVariable<int>("scalarInt");
+    adios2::Engine engine = io.Open(name, adios2::Mode::Write);
+    engine.LockWriterDefinitions();
+    auto startTime = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < steps; ++i)
+    {
+        engine.BeginStep();
+        GenData(myInts, i, start, count, shape);
+        GenData(myDoubles, i, start, count, shape);
+        engine.Put(bpInts, myInts.data(), adios2::Mode::Sync);
+        engine.Put(bpDoubles, myDoubles.data(), adios2::Mode::Sync);
+        engine.Put(scalarInt, static_cast<int>(i));
+        engine.EndStep();
+    }
+    std::chrono::duration<double> loopTime =
+        std::chrono::steady_clock::now() - startTime;
+    if (!discard)
+    {
+        // the reader takes 20ms per step and receives at most the queued
+        // steps ahead, so a writer that blocks on the full queue cannot end
+        // its last step much earlier than the reader gets there
+        ASSERT_GT(loopTime.count(), 0.02 * (steps / 2));
+    }
+    engine.Close();
+}
+
+void Reader(const Dims &shape, const Dims &start, const Dims &count,
+            const size_t steps, const adios2::Params &engineParams,
+            const std::string &name, const bool discard)
+{
+    adios2::ADIOS adios(mpiComm);
+    adios2::IO io = adios.DeclareIO("Test");
+    io.SetEngine("ssc");
+    io.SetParameters(engineParams);
+    adios2::Engine engine = io.Open(name, adios2::Mode::Read);
+
+    size_t datasize =
+        std::accumulate(count.begin(), count.end(), static_cast<size_t>(1),
+                        std::multiplies<size_t>());
+    std::vector<int> myInts(datasize);
+    std::vector<double> myDoubles(datasize);
+
+    engine.LockReaderSelections();
+
+    size_t receivedSteps = 0;
+    int lastWriterStep = -1;
+    while (true)
+    {
+        adios2::StepStatus status = engine.BeginStep(StepMode::Read, 5);
+        if (status == adios2::StepStatus::OK)
+        {
+            auto scalarInt = io.InquireVariable<int>("scalarInt");
+            auto bpInts = io.InquireVariable<int>("bpInts");
+            auto bpDoubles = io.InquireVariable<double>("bpDoubles");
+            bpInts.SetSelection({start, count});
+            bpDoubles.SetSelection({start, count});
+
+            int writerStep;
+            engine.Get(scalarInt, &writerStep);
+            engine.Get(bpInts, myInts.data());
+            engine.Get(bpDoubles, myDoubles.data());
+            engine.PerformGets();
+
+            // steps are delivered in order, numbered as on the writer
+            ASSERT_GT(writerStep, lastWriterStep);
+            ASSERT_EQ(writerStep, engine.CurrentStep());
+            lastWriterStep = writerStep;
+            ++receivedSteps;
+
+            VerifyData(myInts.data(), writerStep, start, count, shape,
+                       mpiRank);
+            VerifyData(myDoubles.data(), writerStep, start, count, shape,
+                       mpiRank);
+
+            // a slow reader, which the writer either waits for or leaves
+            // behind
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            engine.EndStep();
+        }
+        else if (status == adios2::StepStatus::EndOfStream)
+        {
+            std::cout << "[Rank " + std::to_string(mpiRank) +
+                             "] SscTest reader end of stream!"
+                      << std::endl;
+            break;
+        }
+    }
+    if (discard)
+    {
+        ASSERT_GT(receivedSteps, 0u);
+        ASSERT_LT(receivedSteps, steps);
+    }
+    else
+    {
+        ASSERT_EQ(receivedSteps, steps);
+    }
+    engine.Close();
+}
+
+void RunQueueTest(const std::string &filename,
+                  const adios2::Params &writerParams,
+                  const adios2::Params &readerParams, const bool discard)
+{
+    int worldRank, worldSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+    int mpiGroup = worldRank / (worldSize / 2);
+    MPI_Comm_split(MPI_COMM_WORLD, mpiGroup, worldRank, &mpiComm);
+
+    MPI_Comm_rank(mpiComm, &mpiRank);
+    MPI_Comm_size(mpiComm, &mpiSize);
+
+    // blocks well above the MPI eager limit, so that a step is only sent
+    // when the reader has posted its receive
+    Dims shape = {10, (size_t)mpiSize * 10000};
+    Dims start = {2, (size_t)mpiRank * 10000};
+    Dims count = {5, 10000};
+    size_t steps = 50;
+
+    if (mpiGroup == 0)
+    {
+        Writer(shape, start, count, steps, writerParams, filename, discard);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    if (mpiGroup == 1)
+    {
+        Reader(shape, start, count, steps, readerParams, filename, discard);
+    }
+
+    MPI_Barrier(MPI_COMM_WORLD);
+}
+
+TEST_F(SscEngineTest, TestSscQueueBlock)
+{
+    RunQueueTest("TestSscQueueBlock", {{"QueueLimit", "4"}},
+                 {{"QueueLimit", "2"}}, false);
+}
+
+TEST_F(SscEngineTest, TestSscQueueDiscard)
+{
+    RunQueueTest("TestSscQueueDiscard",
+                 {{"QueueLimit", "2"}, {"QueueFullPolicy", "Discard"}}, {},
+                 true);
+}
+
+TEST_F(SscEngineTest, TestSscQueueNegativeLimit)
+{
+    adios2::ADIOS adios(MPI_COMM_WORLD);
+    adios2::IO writerIO = adios.DeclareIO("Writer");
+    writerIO.SetEngine("ssc");
+    writerIO.SetParameters({{"QueueLimit", "-1"}});
+    EXPECT_ANY_THROW(
+        writerIO.Open("TestSscQueueNegativeLimit", adios2::Mode::Write));
+    adios2::IO readerIO = adios.DeclareIO("Reader");
+    readerIO.SetEngine("ssc");
+    readerIO.SetParameters({{"QueueLimit", "-1"}});
+    EXPECT_ANY_THROW(
+        readerIO.Open("TestSscQueueNegativeLimit", adios2::Mode::Read));
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    int worldRank, worldSize;
+    MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+    MPI_Comm_size(MPI_COMM_WORLD, &worldSize);
+    ::testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+    MPI_Finalize();
+    return result;
+}
@@ -68,6 +68,7 @@ set (1x1DefSync_CMD "TestDefSyncWrite --data_size 200 --engine_params ChunkSize=
 set (1x1Flush_CMD "TestDefSyncWrite --flush --data_size 200 --engine_params ChunkSize=500,MinDeferredSize=150")
 set (1x1.NoPreload_CMD "run_test.py.$<CONFIG> -nw 1 -nr 1 --rarg=PreloadMode=SstPreloadNone,RENGINE_PARAMS")
 set (1x1.SstRUDP_CMD "run_test.py.$<CONFIG> -nw 1 -nr 1 --rarg=DataTransport=WAN,WANDataTransport=enet,RENGINE_PARAMS --warg=DataTransport=WAN,WANDataTransport=enet,WENGINE_PARAMS")
+set (1x1.SstShm_CMD "run_test.py.$<CONFIG> -nw 1 -nr 1 --rarg=DataTransport=shm,RENGINE_PARAMS --warg=DataTransport=shm,WENGINE_PARAMS")
 set (1x1.NoData_CMD "run_test.py.$<CONFIG> -nw 1 -nr 1 --warg=--no_data --rarg=--no_data")
 set (2x2.NoData_CMD "run_test.py.$<CONFIG> -nw 2 -nr 2 --warg=--no_data --rarg=--no_data")
 set (2x2.HalfNoData_CMD "run_test.py.$<CONFIG> -nw 2 -nr 2 --warg=--no_data --warg=--no_data_node --warg=1 --rarg=--no_data --rarg=--no_data_node --rarg=1" )
@@ -80,6 +81,9 @@ set (2x1ZeroDataR64_CMD "run_test.py.$<CONFIG> -nw 2 -nr 1  -r $<TARGET_FILE:Tes
 set (2x1.NoPreload_CMD "run_test.py.$<CONFIG> -nw 2 -nr 1 --rarg=PreloadMode=SstPreloadNone,RENGINE_PARAMS")
 set (2x3.ForcePreload_CMD "run_test.py.$<CONFIG> -nw 2 -nr 3 --rarg=PreloadMode=SstPreloadOn,RENGINE_PARAMS")
 set (2x3.SstRUDP_CMD "run_test.py.$<CONFIG> -nw 2 -nr 3 --rarg=DataTransport=WAN,WANDataTransport=enet,RENGINE_PARAMS --warg=DataTransport=WAN,WANDataTransport=enet,WENGINE_PARAMS")
+set (2x3.SstShm_CMD "run_test.py.$<CONFIG> -nw 2 -nr 3 --rarg=DataTransport=shm,RENGINE_PARAMS --warg=DataTransport=shm,WENGINE_PARAMS")
+# the readers use the message fallback of the shm data plane for all writers
+set (2x3.SstShmRemote_CMD "run_test.py.$<CONFIG> -nw 2 -nr 3 --rarg=DataTransport=shm,ShmForceRemote=true,RENGINE_PARAMS --warg=DataTransport=shm,WENGINE_PARAMS")
 set (1x2_CMD "run_test.py.$<CONFIG> -nw 1 -nr 2")
 set (3x5_CMD "run_test.py.$<CONFIG> -nw 3 -nr 5")
 set (3x5LockGeometry_CMD "run_test.py.$<CONFIG> -nw 3 -nr 5 --warg=--num_steps --warg=50 --warg=--ms_delay --warg=10 --rarg=--num_steps --rarg=50 --warg=--lock_geometry --rarg=--lock_geometry")
@@ -135,6 +135,18 @@ TEST(ADIOS2HelperString, ADIOS2HelperStringConversion)
                  std::invalid_argument);
 }
 
+TEST(ADIOS2HelperString, ADIOS2HelperStringByteUnits)
+{
+    const std::string hint("");
+
+    ASSERT_EQ(adios2::helper::StringToByteUnits("123", hint), 123);
+    ASSERT_EQ(adios2::helper::StringToByteUnits("123b", hint), 123);
+    ASSERT_EQ(adios2::helper::StringToByteUnits("2kb", hint), 2048);
+    ASSERT_EQ(adios2::helper::StringToByteUnits("16Mb", hint), 16777216);
+    ASSERT_EQ(adios2::helper::StringToByteUnits("16MB", hint), 16777216);
+    ASSERT_EQ(adios2::helper::StringToByteUnits("1GB", hint), 1073741824);
+}
+
 TEST(ADIOS2HelperString, ADIOS2HelperDimString)
 {
 
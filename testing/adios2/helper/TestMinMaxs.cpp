@@ -1170,6 +1170,48 @@ TEST(ADIOS2MinMaxs, ADIOS2MinMaxs_4D_3x2x5x4)
     }
 }
 
+TEST(ADIOS2MinMaxs, ADIOS2CopyGetMinMax)
+{
+    // odd size so that the tail after the vectorized lanes is exercised
+    const size_t size = 2000003;
+    std::vector<float> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<float>((i * 7919) % size) - 1000.0f;
+    }
+    data[size - 1] = -2000.0f;
+    data[size / 2] = 3000000.0f;
+
+    for (const unsigned int threads : {1u, 3u})
+    {
+        std::vector<float> copy(size, 0.0f);
+        float min = 0.0f;
+        float max = 0.0f;
+        adios2::helper::CopyGetMinMaxThreads(data.data(), size, copy.data(),
+                                             min, max, threads);
+        EXPECT_EQ(min, -2000.0f);
+        EXPECT_EQ(max, 3000000.0f);
+        EXPECT_EQ(copy, data);
+
+        min = max = 0.0f;
+        adios2::helper::CopyGetMinMaxThreads(data.data(), size,
+                                             static_cast<float *>(nullptr),
+                                             min, max, threads);
+        EXPECT_EQ(min, -2000.0f);
+        EXPECT_EQ(max, 3000000.0f);
+    }
+
+    const std::vector<int8_t> small = {3, -4, 5};
+    std::vector<int8_t> smallCopy(small.size());
+    int8_t smallMin = 0;
+    int8_t smallMax = 0;
+    adios2::helper::CopyGetMinMax(small.data(), small.size(), smallCopy.data(),
+                                  smallMin, smallMax);
+    EXPECT_EQ(smallMin, -4);
+    EXPECT_EQ(smallMax, 5);
+    EXPECT_EQ(smallCopy, small);
+}
+
 int main(int argc, char **argv)
 {
 
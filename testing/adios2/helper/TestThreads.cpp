@@ -0,0 +1,96 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ */
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <adios2/helper/adiosThreads.h>
+
+#include <gtest/gtest.h>
+
+TEST(ADIOS2WorkerThreads, EveryCallOnce)
+{
+    adios2::helper::WorkerThreads workers;
+    for (const size_t n : {0, 1, 2, 5, 3})
+    {
+        std::vector<std::atomic<int>> calls(n);
+        for (auto &c : calls)
+        {
+            c = 0;
+        }
+        workers.Run(n, [&](const size_t i) { ++calls[i]; });
+        for (size_t i = 0; i < n; ++i)
+        {
+            EXPECT_EQ(calls[i], 1) << "call " << i << " of " << n;
+        }
+    }
+}
+
+TEST(ADIOS2WorkerThreads, ConcurrentAndReused)
+{
+    const size_t n = 4;
+    adios2::helper::WorkerThreads workers;
+    std::mutex mutex;
+    std::set<std::thread::id> first;
+    std::set<std::thread::id> second;
+    std::atomic<size_t> arrived(0);
+    const std::thread::id caller = std::this_thread::get_id();
+
+    auto lf_Run = [&](std::set<std::thread::id> &ids) {
+        arrived = 0;
+        workers.Run(n, [&](const size_t i) {
+            // only returns if all calls run at the same time
+            ++arrived;
+            while (arrived < n)
+            {
+                std::this_thread::yield();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ids.insert(std::this_thread::get_id());
+            if (i == 0)
+            {
+                EXPECT_EQ(std::this_thread::get_id(), caller);
+            }
+        });
+    };
+    lf_Run(first);
+    lf_Run(second);
+    EXPECT_EQ(first.size(), n);
+    // the second run starts no new threads
+    EXPECT_EQ(first, second);
+}
+
+TEST(ADIOS2WorkerThreads, Exception)
+{
+    adios2::helper::WorkerThreads workers;
+    std::atomic<int> calls(0);
+    EXPECT_THROW(workers.Run(3,
+                             [&](const size_t i) {
+                                 ++calls;
+                                 if (i == 2)
+                                 {
+                                     throw std::runtime_error("call 2");
+                                 }
+                             }),
+                 std::runtime_error);
+    EXPECT_EQ(calls, 3);
+
+    // the workers are still usable
+    calls = 0;
+    workers.Run(3, [&](const size_t) { ++calls; });
+    EXPECT_EQ(calls, 3);
+}
+
+int main(int argc, char **argv)
+{
+    int result;
+    ::testing::InitGoogleTest(&argc, argv);
+    result = RUN_ALL_TESTS();
+
+    return result;
+}
@@ -0,0 +1,102 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ *
+ * PerfPutOverhead.cpp
+ *
+ * Measure the cost of a single Put() as the number of variables written per
+ * step grows. Every variable is a small local array so that the time is
+ * dominated by per-variable bookkeeping in the engine, not by copying data.
+ *
+ * How to run: mpirun -np <N> PerfPutOverhead [engine] [max nvars] [steps]
+ *   engine    default BP5
+ *   max nvars default 20000, the variable count is doubled from 100 up to it
+ *   steps     default 5
+ * Output: put_overhead_<nvars>.bp, one line per variable count on rank 0
+ */
+
+#include <adios2.h>
+#include <mpi.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+double RunOnce(adios2::ADIOS &adios, const std::string &engineType,
+               const size_t nvars, const size_t nsteps, MPI_Comm comm)
+{
+    const size_t count = 4;
+    std::vector<double> data(count, 1.0);
+
+    adios2::IO io = adios.DeclareIO("PutOverhead" + std::to_string(nvars));
+    io.SetEngine(engineType);
+    std::vector<adios2::Variable<double>> vars;
+    vars.reserve(nvars);
+    for (size_t i = 0; i < nvars; ++i)
+    {
+        vars.push_back(io.DefineVariable<double>("v" + std::to_string(i), {},
+                                                 {}, {count}));
+    }
+
+    adios2::Engine writer = io.Open(
+        "put_overhead_" + std::to_string(nvars) + ".bp", adios2::Mode::Write);
+
+    double putSeconds = 0.0;
+    for (size_t step = 0; step < nsteps; ++step)
+    {
+        writer.BeginStep();
+        MPI_Barrier(comm);
+        const auto start = std::chrono::steady_clock::now();
+        for (auto &var : vars)
+        {
+            writer.Put(var, data.data());
+        }
+        const auto end = std::chrono::steady_clock::now();
+        putSeconds += std::chrono::duration<double>(end - start).count();
+        writer.EndStep();
+    }
+    writer.Close();
+
+    double maxSeconds = 0.0;
+    MPI_Reduce(&putSeconds, &maxSeconds, 1, MPI_DOUBLE, MPI_MAX, 0, comm);
+    return maxSeconds;
+}
+
+} // end anonymous namespace
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+    const std::string engineType = (argc > 1) ? argv[1] : "BP5";
+    const size_t maxVars = (argc > 2) ? std::strtoul(argv[2], NULL, 10) : 20000;
+    const size_t nsteps = (argc > 3) ? std::strtoul(argv[3], NULL, 10) : 5;
+
+    {
+        adios2::ADIOS adios(MPI_COMM_WORLD);
+        if (!rank)
+        {
+            std::printf("%10s %12s %14s\n", "nvars", "put [s]", "per put [ns]");
+        }
+        for (size_t nvars = 100; nvars <= maxVars; nvars *= 2)
+        {
+            const double seconds =
+                RunOnce(adios, engineType, nvars, nsteps, MPI_COMM_WORLD);
+            if (!rank)
+            {
+                std::printf("%10zu %12.6f %14.1f\n", nvars, seconds,
+                            1e9 * seconds / static_cast<double>(nvars * nsteps));
+            }
+        }
+    }
+
+    MPI_Finalize();
+    return 0;
+}
@@ -2,11 +2,37 @@
  * Distributed under the OSI-approved Apache License, Version 2.0.  See
  * accompanying file Copyright.txt for details.
  */
+#include <algorithm>
 #include <array>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <regex>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #include <adios2.h>
+#include <adios2/core/ADIOS.h>
+#include <adios2/core/Engine.h>
+#include <adios2/core/IO.h>
+#ifndef _WIN32
+#include <adios2/helper/adiosCommDummy.h>
+#include <adios2/toolkit/transport/file/FileMMap.h>
+#include <adios2/toolkit/transport/file/FilePOSIX.h>
+#ifdef ADIOS2_HAVE_IOURING
+#include <adios2/toolkit/transport/file/FileIOUring.h>
+#include <adios2/toolkit/transportman/TransportMan.h>
+#endif
+
+#include <climits>
+#include <csignal>
+#include <cstdlib>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 #include <gtest/gtest.h>
 
@@ -41,6 +67,10 @@ TEST_P(BufferTest, WriteRead)
         const size_t transportID = io.AddTransport("file");
         io.SetTransportParameter(transportID, "Library", transportWriteLibrary);
         io.SetTransportParameter(transportID, "Buffer", transportWriteBuffer);
+        if (transportWriteLibrary == "uring")
+        {
+            io.SetTransportParameter(transportID, "RegisterBuffers", "true");
+        }
 
         auto var = io.DefineVariable<double>("var", {100}, {0}, {100});
         adios2::Engine writer = io.Open(fname, adios2::Mode::Write);
@@ -59,6 +89,10 @@ TEST_P(BufferTest, WriteRead)
         const size_t transportID = io.AddTransport("file");
         io.SetTransportParameter(transportID, "Library", transportReadLibrary);
         io.SetTransportParameter(transportID, "Buffer", transportReadBuffer);
+        if (transportReadLibrary == "uring")
+        {
+            io.SetTransportParameter(transportID, "RegisterBuffers", "true");
+        }
 
         adios2::Engine reader = io.Open(fname, adios2::Mode::Read);
         auto var = io.InquireVariable<double>("var");
@@ -75,6 +109,826 @@ TEST_P(BufferTest, WriteRead)
     }
 }
 
+#ifndef _WIN32
+/* Split data into pieces of 1 to mod bytes */
+static std::vector<adios2::core::iovec> SplitBuffer(std::vector<char> &data,
+                                                    const size_t mod)
+{
+    std::vector<adios2::core::iovec> iov;
+    size_t pos = 0;
+    for (size_t i = 0; pos < data.size(); ++i)
+    {
+        const size_t len = std::min(i % mod + 1, data.size() - pos);
+        iov.push_back({data.data() + pos, len});
+        pos += len;
+    }
+    return iov;
+}
+
+TEST(FilePOSIXTest, WriteVReadVManyPieces)
+{
+    // more entries than one pwritev/preadv call takes (IOV_MAX)
+    const std::string fname("FilePOSIXTest_ManyPieces.bin");
+    std::vector<char> dataOrig(20000);
+    for (size_t i = 0; i < dataOrig.size(); ++i)
+    {
+        dataOrig[i] = static_cast<char>(i * 7);
+    }
+    const std::vector<char> tailOrig = {'t', 'a', 'i', 'l'};
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+
+    {
+        adios2::transport::FilePOSIX file(comm);
+        file.Open(fname, adios2::Mode::Write);
+        const auto iov = SplitBuffer(dataOrig, 13);
+        ASSERT_GT(iov.size(), 2048);
+        file.WriteV(iov.data(), static_cast<int>(iov.size()));
+        // continues after the vectored write
+        file.Write(tailOrig.data(), tailOrig.size());
+        file.Close();
+    }
+
+    {
+        adios2::transport::FilePOSIX file(comm);
+        file.Open(fname, adios2::Mode::Read);
+        ASSERT_EQ(file.GetSize(), dataOrig.size() + tailOrig.size());
+        std::vector<char> dataRead(dataOrig.size());
+        const auto iov = SplitBuffer(dataRead, 7);
+        file.ReadV(iov.data(), static_cast<int>(iov.size()), 0);
+        std::vector<char> tailRead(tailOrig.size());
+        file.Read(tailRead.data(), tailRead.size());
+        ASSERT_EQ(dataRead, dataOrig);
+        ASSERT_EQ(tailRead, tailOrig);
+
+        // from the current position, which moves past the data
+        file.SeekToBegin();
+        std::fill(dataRead.begin(), dataRead.end(), 0);
+        file.ReadV(iov.data(), static_cast<int>(iov.size()));
+        std::fill(tailRead.begin(), tailRead.end(), 0);
+        file.Read(tailRead.data(), tailRead.size());
+        file.Close();
+        ASSERT_EQ(dataRead, dataOrig);
+        ASSERT_EQ(tailRead, tailOrig);
+    }
+    std::remove(fname.c_str());
+}
+
+TEST(FilePOSIXTest, ShortWriteRead)
+{
+    // a file size limit in the middle of an entry makes pwritev write
+    // only part of it, the retry of the rest then fails
+    const std::string fname("FilePOSIXTest_ShortWrite.bin");
+    const size_t limit = 10000;
+    std::vector<char> dataOrig(3 * 4096);
+    for (size_t i = 0; i < dataOrig.size(); ++i)
+    {
+        dataOrig[i] = static_cast<char>(i * 3);
+    }
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+
+    struct rlimit oldLimit;
+    ASSERT_EQ(getrlimit(RLIMIT_FSIZE, &oldLimit), 0);
+    if (oldLimit.rlim_cur != RLIM_INFINITY && oldLimit.rlim_cur < limit)
+    {
+        GTEST_SKIP() << "file size limit is below " << limit;
+    }
+    {
+        adios2::transport::FilePOSIX file(comm);
+        file.Open(fname, adios2::Mode::Write);
+        const auto iov = SplitBuffer(dataOrig, 4096);
+        auto oldHandler = std::signal(SIGXFSZ, SIG_IGN);
+        struct rlimit newLimit = oldLimit;
+        newLimit.rlim_cur = limit;
+        ASSERT_EQ(setrlimit(RLIMIT_FSIZE, &newLimit), 0);
+        EXPECT_THROW(file.WriteV(iov.data(), static_cast<int>(iov.size())),
+                     std::ios_base::failure);
+        setrlimit(RLIMIT_FSIZE, &oldLimit);
+        std::signal(SIGXFSZ, oldHandler);
+        file.Close();
+    }
+
+    {
+        adios2::transport::FilePOSIX file(comm);
+        file.Open(fname, adios2::Mode::Read);
+        ASSERT_EQ(file.GetSize(), limit);
+        // preadv stops at the end of file, the retry reads nothing
+        std::vector<char> dataRead(dataOrig.size());
+        const auto iov = SplitBuffer(dataRead, 4096);
+        EXPECT_THROW(file.ReadV(iov.data(), static_cast<int>(iov.size()), 0),
+                     std::ios_base::failure);
+        file.Close();
+        for (size_t i = 0; i < limit; ++i)
+        {
+            ASSERT_EQ(dataRead[i], dataOrig[i]);
+        }
+    }
+    std::remove(fname.c_str());
+}
+
+#ifdef ADIOS2_HAVE_IOURING
+/* n bytes of a pattern that differs for each seed */
+static std::vector<char> UringData(const size_t n, const size_t seed)
+{
+    std::vector<char> data(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        data[i] = static_cast<char>(i * 13 + seed);
+    }
+    return data;
+}
+
+TEST(FileIOUringTest, AsyncWriteRead)
+{
+    // twelve requests on a queue of four, IWrite waits for free slots, and
+    // one request longer than the 4Mb pieces of the blocking calls
+    const std::string fname("FileIOUringTest_Async.bin");
+    const size_t nRequests = 12;
+    const size_t requestSize = 100000;
+    const size_t largeSize = 10 * 1024 * 1024 + 7;
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+
+    std::vector<std::vector<char>> dataOrig;
+    for (size_t r = 0; r < nRequests; ++r)
+    {
+        dataOrig.push_back(UringData(requestSize, r));
+    }
+    const std::vector<char> largeOrig = UringData(largeSize, nRequests);
+    {
+        adios2::transport::FileIOUring file(comm);
+        file.SetParameters({{"QueueDepth", "4"}});
+        file.Open(fname, adios2::Mode::Write);
+        std::vector<adios2::Transport::Status> status(nRequests + 1);
+        // in reverse order, each at its own offset
+        for (size_t r = nRequests; r-- > 0;)
+        {
+            file.IWrite(dataOrig[r].data(), requestSize, status[r],
+                        r * requestSize);
+        }
+        file.IWrite(largeOrig.data(), largeSize, status[nRequests],
+                    nRequests * requestSize);
+        file.WaitForCompletion();
+        for (size_t r = 0; r < nRequests; ++r)
+        {
+            EXPECT_FALSE(status[r].Running) << r;
+            EXPECT_TRUE(status[r].Successful) << r;
+            EXPECT_EQ(status[r].Bytes, requestSize) << r;
+        }
+        EXPECT_FALSE(status[nRequests].Running);
+        EXPECT_TRUE(status[nRequests].Successful);
+        EXPECT_EQ(status[nRequests].Bytes, largeSize);
+        file.Close();
+    }
+
+    {
+        adios2::transport::FileIOUring file(comm);
+        file.SetParameters({{"QueueDepth", "4"}});
+        file.Open(fname, adios2::Mode::Read);
+        ASSERT_EQ(file.GetSize(), nRequests * requestSize + largeSize);
+        std::vector<std::vector<char>> dataRead(
+            nRequests, std::vector<char>(requestSize));
+        std::vector<char> largeRead(largeSize);
+        std::vector<adios2::Transport::Status> status(nRequests + 1);
+        file.IRead(largeRead.data(), largeSize, status[nRequests],
+                   nRequests * requestSize);
+        for (size_t r = 0; r < nRequests; ++r)
+        {
+            file.IRead(dataRead[r].data(), requestSize, status[r],
+                       r * requestSize);
+        }
+        file.WaitForCompletion();
+        for (size_t r = 0; r < nRequests; ++r)
+        {
+            EXPECT_FALSE(status[r].Running) << r;
+            EXPECT_TRUE(status[r].Successful) << r;
+            EXPECT_EQ(status[r].Bytes, requestSize) << r;
+            EXPECT_EQ(dataRead[r], dataOrig[r]) << r;
+        }
+        EXPECT_TRUE(status[nRequests].Successful);
+        EXPECT_EQ(status[nRequests].Bytes, largeSize);
+        EXPECT_EQ(largeRead, largeOrig);
+
+        // the blocking Read of more than 4Mb is cut into pieces
+        std::fill(largeRead.begin(), largeRead.end(), 0);
+        file.Read(largeRead.data(), largeSize, nRequests * requestSize);
+        EXPECT_EQ(largeRead, largeOrig);
+        file.Close();
+    }
+    std::remove(fname.c_str());
+}
+
+TEST(FileIOUringTest, ShortRead)
+{
+    // a read across the end of file gets part of the data, the request is
+    // resubmitted for the rest, which then fails
+    const std::string fname("FileIOUringTest_Short.bin");
+    const size_t fileSize = 100000;
+    const size_t readStart = 60000;
+    const std::vector<char> dataOrig = UringData(fileSize, 1);
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+    {
+        adios2::transport::FileIOUring file(comm);
+        file.Open(fname, adios2::Mode::Write);
+        file.Write(dataOrig.data(), fileSize);
+        file.Close();
+    }
+
+    adios2::transport::FileIOUring file(comm);
+    file.Open(fname, adios2::Mode::Read);
+    std::vector<char> dataRead(fileSize, 0);
+    adios2::Transport::Status status;
+    file.IRead(dataRead.data(), fileSize, status, readStart);
+    file.WaitForCompletion();
+    EXPECT_FALSE(status.Running);
+    EXPECT_FALSE(status.Successful);
+    EXPECT_EQ(status.Bytes, fileSize - readStart);
+    for (size_t i = 0; i < fileSize - readStart; ++i)
+    {
+        ASSERT_EQ(dataRead[i], dataOrig[readStart + i]) << i;
+    }
+
+    // a zero sized request completes right away
+    adios2::Transport::Status empty;
+    file.IRead(dataRead.data(), 0, empty, 0);
+    EXPECT_FALSE(empty.Running);
+    EXPECT_TRUE(empty.Successful);
+    EXPECT_EQ(empty.Bytes, 0);
+
+    EXPECT_THROW(file.Read(dataRead.data(), fileSize, readStart),
+                 std::ios_base::failure);
+    file.Close();
+    std::remove(fname.c_str());
+}
+
+/* Writes and reads requests that fit in the registered buffers and requests
+ * that do not, asynchronous and blocking */
+static void UringRegisteredWriteRead(const std::string &fname,
+                                     const adios2::Params &params,
+                                     const bool expectRegistered)
+{
+    const size_t smallSize = 3000;
+    const size_t largeSize = 50000;
+    const size_t nSmall = 10;
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+    std::vector<std::vector<char>> dataOrig;
+    for (size_t r = 0; r < nSmall; ++r)
+    {
+        dataOrig.push_back(UringData(smallSize, r));
+    }
+    const std::vector<char> largeOrig = UringData(largeSize, nSmall);
+    const size_t largeStart = nSmall * smallSize;
+    {
+        adios2::transport::FileIOUring file(comm);
+        file.SetParameters(params);
+        file.Open(fname, adios2::Mode::Write);
+        EXPECT_EQ(file.BuffersRegistered(), expectRegistered);
+        std::vector<adios2::Transport::Status> status(nSmall);
+        for (size_t r = 0; r < nSmall; ++r)
+        {
+            std::vector<char> scratch = dataOrig[r];
+            file.IWrite(scratch.data(), smallSize, status[r], r * smallSize);
+            // with a registered buffer the data was copied at submission
+            if (expectRegistered)
+            {
+                std::fill(scratch.begin(), scratch.end(), 0);
+            }
+            else
+            {
+                file.WaitForCompletion();
+            }
+        }
+        file.Write(largeOrig.data(), largeSize, largeStart);
+        file.WaitForCompletion();
+        for (size_t r = 0; r < nSmall; ++r)
+        {
+            EXPECT_TRUE(status[r].Successful) << r;
+            EXPECT_EQ(status[r].Bytes, smallSize) << r;
+        }
+        file.Close();
+    }
+
+    {
+        adios2::transport::FileIOUring file(comm);
+        file.SetParameters(params);
+        file.Open(fname, adios2::Mode::Read);
+        EXPECT_EQ(file.BuffersRegistered(), expectRegistered);
+        std::vector<std::vector<char>> dataRead(nSmall,
+                                                std::vector<char>(smallSize));
+        std::vector<adios2::Transport::Status> status(nSmall);
+        for (size_t r = 0; r < nSmall; ++r)
+        {
+            file.IRead(dataRead[r].data(), smallSize, status[r],
+                       r * smallSize);
+        }
+        file.WaitForCompletion();
+        for (size_t r = 0; r < nSmall; ++r)
+        {
+            EXPECT_TRUE(status[r].Successful) << r;
+            EXPECT_EQ(dataRead[r], dataOrig[r]) << r;
+        }
+        std::vector<char> largeRead(largeSize);
+        file.Read(largeRead.data(), largeSize, largeStart);
+        EXPECT_EQ(largeRead, largeOrig);
+        file.Close();
+    }
+    std::remove(fname.c_str());
+}
+
+TEST(FileIOUringTest, RegisteredBuffers)
+{
+    UringRegisteredWriteRead("FileIOUringTest_Registered.bin",
+                             {{"QueueDepth", "4"},
+                              {"RegisterBuffers", "true"},
+                              {"RegisteredBufferSize", "4Kb"}},
+                             true);
+}
+
+TEST(FileIOUringTest, RegisteredBuffersFallback)
+{
+    // the kernel registers at most 16384 buffers, one per request of a
+    // deeper queue is refused and the transport runs without them
+    UringRegisteredWriteRead("FileIOUringTest_Fallback.bin",
+                             {{"QueueDepth", "16385"},
+                              {"RegisterBuffers", "true"},
+                              {"RegisteredBufferSize", "512"}},
+                             false);
+}
+
+TEST(FileIOUringTest, TransportManWaitForCompletion)
+{
+    const std::string fname("FileIOUringTest_TransportMan.bin");
+    const size_t size = 5 * 1024 * 1024;
+    const std::vector<char> dataOrig = UringData(size, 5);
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+    const std::vector<adios2::Params> params = {
+        {{"transport", "File"}, {"Library", "uring"}}};
+
+    adios2::transportman::TransportMan tm(comm);
+    tm.OpenFiles({fname}, adios2::Mode::Write, params, false);
+    ASSERT_EQ(tm.m_Transports.size(), 1);
+    adios2::Transport::Status first, second;
+    tm.m_Transports[0]->IWrite(dataOrig.data(), size / 2, first, 0);
+    tm.m_Transports[0]->IWrite(dataOrig.data() + size / 2, size - size / 2,
+                               second, size / 2);
+    tm.WaitForCompletion();
+    EXPECT_FALSE(first.Running);
+    EXPECT_TRUE(first.Successful);
+    EXPECT_FALSE(second.Running);
+    EXPECT_TRUE(second.Successful);
+    EXPECT_EQ(first.Bytes + second.Bytes, size);
+    tm.CloseFiles();
+
+    adios2::transportman::TransportMan reader(comm);
+    reader.OpenFiles({fname}, adios2::Mode::Read, params, false);
+    std::vector<char> dataRead(size);
+    adios2::Transport::Status status;
+    reader.m_Transports[0]->IRead(dataRead.data(), size, status, 0);
+    reader.WaitForCompletion(0);
+    EXPECT_TRUE(status.Successful);
+    EXPECT_EQ(dataRead, dataOrig);
+    reader.CloseFiles();
+    std::remove(fname.c_str());
+}
+#endif
+#endif
+
+/* The tests below write NSteps steps of Nx doubles, i + step * Nx, and
+ * optionally of 13 chars, 'a' + i + step, through the given transports and
+ * read them back. Count > 0 reads Count elements from Start + step. */
+struct StepsCase
+{
+    std::string Engine;
+    size_t Nx;
+    size_t NSteps = 3;
+    bool Small = false;
+    size_t Start = 0;
+    size_t Count = 0;
+};
+
+static void WriteSteps(adios2::ADIOS &adios, const StepsCase &c,
+                       const std::string &fname,
+                       const std::vector<adios2::Params> &transports,
+                       const adios2::Params &parameters = adios2::Params())
+{
+    adios2::IO io = adios.DeclareIO("Write_" + fname);
+    io.SetEngine(c.Engine);
+    io.SetParameters(parameters);
+    for (const auto &transport : transports)
+    {
+        io.AddTransport("file", transport);
+    }
+
+    std::vector<double> dataOrig(c.Nx);
+    std::vector<char> small(13);
+    auto var = io.DefineVariable<double>("var", {c.Nx}, {0}, {c.Nx});
+    auto varSmall = io.DefineVariable<char>("small", {13}, {0}, {13});
+    adios2::Engine writer = io.Open(fname, adios2::Mode::Write);
+    for (size_t step = 0; step < c.NSteps; ++step)
+    {
+        for (size_t i = 0; i < c.Nx; ++i)
+        {
+            dataOrig[i] = static_cast<double>(i + step * c.Nx);
+        }
+        for (size_t i = 0; i < small.size(); ++i)
+        {
+            small[i] = static_cast<char>('a' + i + step);
+        }
+        writer.BeginStep();
+        if (c.Small)
+        {
+            writer.Put(varSmall, small.data());
+        }
+        writer.Put(var, dataOrig.data());
+        writer.EndStep();
+    }
+    writer.Close();
+}
+
+static void ReadSteps(adios2::ADIOS &adios, const StepsCase &c,
+                      const std::string &fname,
+                      const std::vector<adios2::Params> &transports)
+{
+    adios2::IO io = adios.DeclareIO("Read_" + fname);
+    io.SetEngine(c.Engine);
+    for (const auto &transport : transports)
+    {
+        io.AddTransport("file", transport);
+    }
+
+    adios2::Engine reader = io.Open(fname, adios2::Mode::Read);
+    for (size_t step = 0; step < c.NSteps; ++step)
+    {
+        ASSERT_EQ(reader.BeginStep(), adios2::StepStatus::OK);
+        auto var = io.InquireVariable<double>("var");
+        ASSERT_TRUE(var);
+        const size_t start = c.Count ? c.Start + step : 0;
+        const size_t count = c.Count ? c.Count : c.Nx;
+        var.SetSelection({{start}, {count}});
+        std::vector<double> dataRead;
+        reader.Get(var, dataRead, adios2::Mode::Sync);
+        std::vector<char> smallRead;
+        if (c.Small)
+        {
+            auto varSmall = io.InquireVariable<char>("small");
+            ASSERT_TRUE(varSmall);
+            reader.Get(varSmall, smallRead, adios2::Mode::Sync);
+        }
+        reader.EndStep();
+
+        ASSERT_EQ(dataRead.size(), count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            ASSERT_EQ(dataRead[i],
+                      static_cast<double>(start + i + step * c.Nx));
+        }
+        for (size_t i = 0; i < smallRead.size(); ++i)
+        {
+            ASSERT_EQ(smallRead[i], static_cast<char>('a' + i + step));
+        }
+    }
+    reader.Close();
+}
+
+static std::string ReadWholeFile(const std::string &fname)
+{
+    std::ifstream file(fname);
+    return std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+}
+
+#ifdef __linux__
+/* true if O_DIRECT can be used in the working directory, it cannot on
+ * e.g. tmpfs where FilePOSIX falls back to buffered I/O */
+static bool DirectIOSupported()
+{
+    const char *probe = "FileDirectIOProbe";
+    const int fd = open(probe, O_WRONLY | O_CREAT | O_DIRECT, 0666);
+    if (fd == -1)
+    {
+        return false;
+    }
+    close(fd);
+    std::remove(probe);
+    return true;
+}
+
+/* true if this process has a descriptor on fname opened with O_DIRECT */
+static bool HasDirectDescriptor(const std::string &fname)
+{
+    char *path = realpath(fname.c_str(), nullptr);
+    if (path == nullptr)
+    {
+        return false;
+    }
+    const std::string target(path);
+    free(path);
+
+    bool found = false;
+    DIR *dir = opendir("/proc/self/fd");
+    while (dirent *entry = readdir(dir))
+    {
+        const std::string fd(entry->d_name);
+        char link[PATH_MAX];
+        const ssize_t len =
+            readlink(("/proc/self/fd/" + fd).c_str(), link, sizeof(link));
+        if (len <= 0 || target != std::string(link, len))
+        {
+            continue;
+        }
+        const std::string info = ReadWholeFile("/proc/self/fdinfo/" + fd);
+        const size_t pos = info.find("flags:");
+        if (pos != std::string::npos &&
+            (std::stoul(info.substr(pos + 6), nullptr, 8) & O_DIRECT))
+        {
+            found = true;
+        }
+    }
+    closedir(dir);
+    return found;
+}
+
+/* true if [p, p + size) lies in a memory mapping of fname */
+static bool IsMappedFrom(const char *p, const size_t size,
+                         const std::string &fname)
+{
+    char *path = realpath(fname.c_str(), nullptr);
+    if (path == nullptr)
+    {
+        return false;
+    }
+    const std::string target(path);
+    free(path);
+
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    while (std::getline(maps, line))
+    {
+        // start-end perms offset dev inode path
+        if (line.size() < target.size() ||
+            line.compare(line.size() - target.size(), target.size(),
+                         target) != 0)
+        {
+            continue;
+        }
+        const size_t dash = line.find('-');
+        const uintptr_t start = std::stoull(line.substr(0, dash), nullptr, 16);
+        const uintptr_t end = std::stoull(line.substr(dash + 1), nullptr, 16);
+        const uintptr_t addr = reinterpret_cast<uintptr_t>(p);
+        if (start <= addr && addr + size <= end)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST(FilePOSIXTest, DirectIO)
+{
+    if (!DirectIOSupported())
+    {
+        GTEST_SKIP() << "O_DIRECT is not supported here";
+    }
+    const std::string fname("FilePOSIXTest_DirectIO.bin");
+    // unaligned head and tail around the aligned middle
+    std::vector<char> dataOrig(3 * 4096 + 100);
+    for (size_t i = 0; i < dataOrig.size(); ++i)
+    {
+        dataOrig[i] = static_cast<char>(i * 5);
+    }
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+
+    {
+        adios2::transport::FilePOSIX file(comm);
+        file.SetParameters({{"DirectIO", "true"}});
+        file.Open(fname, adios2::Mode::Write);
+        file.Write(dataOrig.data(), 50);
+        ASSERT_TRUE(HasDirectDescriptor(fname));
+        file.Write(dataOrig.data() + 50, dataOrig.size() - 50);
+        file.Close();
+    }
+    ASSERT_EQ(ReadWholeFile(fname),
+              std::string(dataOrig.data(), dataOrig.size()));
+    std::remove(fname.c_str());
+}
+
+class DirectIOTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(DirectIOTest, WriteRead)
+{
+    if (!DirectIOSupported())
+    {
+        GTEST_SKIP() << "O_DIRECT is not supported here";
+    }
+    // odd sizes so that every write has an unaligned head or tail
+    StepsCase c;
+    c.Engine = GetParam();
+    c.Nx = 100003;
+    c.Small = true;
+    const std::string fname("FileDirectIOTest_" + c.Engine + ".bp");
+
+    adios2::ADIOS adios;
+    WriteSteps(adios, c, fname,
+               {{{"Library", "posix"},
+                 {"DirectIO", "true"},
+                 {"DirectIOAlignment", "4096"}}});
+    ReadSteps(adios, c, fname, {{{"Library", "posix"}}});
+}
+
+INSTANTIATE_TEST_SUITE_P(TransportTests, DirectIOTest,
+                         ::testing::Values("BP4"
+#ifdef ADIOS2_HAVE_BP5
+                                           ,
+                                           "BP5"
+#endif
+                                           ));
+
+class WriteBehindTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(WriteBehindTest, WriteRead)
+{
+    // 2.4MB per step, so several write-behind steps run during the writes
+    // and a partial range is left for close
+    StepsCase c;
+    c.Engine = GetParam();
+    c.Nx = 300001;
+    const std::string fname("FileWriteBehindTest_" + c.Engine + ".bp");
+
+    adios2::ADIOS adios;
+    WriteSteps(adios, c, fname,
+               {{{"Library", "posix"}, {"WriteBehindSize", "1Mb"}}});
+    ReadSteps(adios, c, fname, {{{"Library", "posix"}}});
+
+    // the transport profile has the time spent starting write-behind,
+    // "writebehind":{ "mus":N (BP5) or "writebehind_mus": N (BP4)
+    const std::string profile = ReadWholeFile(fname + "/profiling.json");
+    const std::regex timer("\"writebehind(\":\\{ \"mus\":|_mus\": )([0-9]+)");
+    bool used = false;
+    for (std::sregex_iterator it(profile.begin(), profile.end(), timer);
+         it != std::sregex_iterator(); ++it)
+    {
+        used = used || std::stoul((*it)[2]) > 0;
+    }
+    ASSERT_TRUE(used) << profile;
+}
+
+INSTANTIATE_TEST_SUITE_P(TransportTests, WriteBehindTest,
+                         ::testing::Values("BP4"
+#ifdef ADIOS2_HAVE_BP5
+                                           ,
+                                           "BP5"
+#endif
+                                           ));
+#endif
+
+class ConcurrentWritesTest : public ::testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(ConcurrentWritesTest, WriteRead)
+{
+    StepsCase c;
+    c.Engine = GetParam();
+    c.Nx = 10000;
+    const std::array<std::string, 2> fnames = {
+        "FileConcurrentWritesTest_A_" + c.Engine + ".bp",
+        "FileConcurrentWritesTest_B_" + c.Engine + ".bp"};
+
+    adios2::ADIOS adios;
+    WriteSteps(adios, c, fnames[0],
+               {{{"Library", "posix"}, {"Name", fnames[0]}},
+                {{"Library", "posix"}, {"Name", fnames[1]}}},
+               {{"ConcurrentTransportWrites", "true"}});
+    for (const auto &fname : fnames)
+    {
+        ReadSteps(adios, c, fname, {});
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(TransportTests, ConcurrentWritesTest,
+                         ::testing::Values("BP4"
+#ifdef ADIOS2_HAVE_BP5
+                                           ,
+                                           "BP5"
+#endif
+                                           ));
+
+#ifdef ADIOS2_HAVE_BP5
+TEST(MMapTest, BP5SelectionRead)
+{
+    StepsCase c;
+    c.Engine = "BP5";
+    c.Nx = 1000;
+    c.Start = 100;
+    c.Count = 200;
+    const std::string fname("FileMMapTest_BP5.bp");
+
+    adios2::ADIOS adios;
+    WriteSteps(adios, c, fname, {});
+    ReadSteps(adios, c, fname, {{{"Library", "mmap"}}});
+}
+
+#ifdef __linux__
+TEST(MMapTest, MapRange)
+{
+    const std::string fname("FileMMapTest_MapRange.bin");
+    std::vector<char> dataOrig(3 * 4096 + 100);
+    for (size_t i = 0; i < dataOrig.size(); ++i)
+    {
+        dataOrig[i] = static_cast<char>(i * 7);
+    }
+    {
+        std::ofstream file(fname, std::ios::binary);
+        file.write(dataOrig.data(), dataOrig.size());
+    }
+
+    adios2::helper::Comm comm = adios2::helper::CommDummy();
+    adios2::transport::FileMMap transport(comm);
+    transport.Open(fname, adios2::Mode::Read);
+
+    // pointers into one map of the file, not copies
+    const char *head = transport.MapRange(0, 100);
+    const char *middle = transport.MapRange(5000, 4096);
+    ASSERT_TRUE(IsMappedFrom(head, dataOrig.size(), fname));
+    ASSERT_EQ(middle, head + 5000);
+    ASSERT_TRUE(std::equal(middle, middle + 4096, dataOrig.begin() + 5000));
+
+    std::vector<char> dataRead(4096);
+    transport.Read(dataRead.data(), dataRead.size(), 5000);
+    ASSERT_TRUE(std::equal(dataRead.begin(), dataRead.end(), middle));
+    transport.Close();
+}
+
+TEST(MMapTest, BP5ZeroCopyRead)
+{
+    // every selection of a contiguous block is extracted from the map
+    StepsCase c;
+    c.Engine = "BP5";
+    c.Nx = 1000;
+    const std::string fname("FileMMapTest_BP5ZeroCopy.bp");
+    {
+        adios2::ADIOS adios;
+        WriteSteps(adios, c, fname, {});
+    }
+
+    adios2::core::ADIOS adios("C++");
+    adios2::core::IO &io = adios.DeclareIO("ZeroCopy");
+    io.SetEngine("BP5");
+    io.AddTransport("file", {{"Library", "mmap"}});
+    adios2::core::Engine &reader = io.Open(fname, adios2::Mode::Read);
+    for (size_t step = 0; step < c.NSteps; ++step)
+    {
+        ASSERT_EQ(reader.BeginStep(), adios2::StepStatus::OK);
+        auto *var = io.InquireVariable<double>("var");
+        ASSERT_NE(var, nullptr);
+        var->SetSelection({{100}, {200}});
+        std::vector<double> dataRead;
+        reader.Get(*var, dataRead, adios2::Mode::Sync);
+        reader.EndStep();
+        ASSERT_EQ(reader.DebugGetMappedReads(), step + 1);
+        for (size_t i = 0; i < dataRead.size(); ++i)
+        {
+            ASSERT_EQ(dataRead[i], static_cast<double>(100 + i + step * c.Nx));
+        }
+    }
+    reader.Close();
+}
+#endif
+
+#ifndef _WIN32
+TEST(StripedTest, BP5WriteRead)
+{
+    // 4Kb stripes over three directories, each step spans several rows,
+    // the selection crosses stripe boundaries
+    StepsCase c;
+    c.Engine = "BP5";
+    c.Nx = 10000;
+    c.Start = 1000;
+    c.Count = 5000;
+    const std::string fname("FileStripedTest_BP5.bp");
+    const adios2::Params stripedParams = {
+        {"Library", "striped"},
+        {"StripePaths",
+         "FileStripedTest_0, FileStripedTest_1,FileStripedTest_2"},
+        {"StripeSize", "4Kb"}};
+
+    adios2::ADIOS adios;
+    WriteSteps(adios, c, fname, {stripedParams});
+    ReadSteps(adios, c, fname, {stripedParams});
+
+    // every stripe directory got a share of the data
+    for (int s = 0; s < 3; ++s)
+    {
+        const std::string stripe =
+            "FileStripedTest_" + std::to_string(s) + "/" + fname + "/data.0";
+        ASSERT_GT(ReadWholeFile(stripe).size(), 4096) << stripe;
+    }
+}
+#endif
+#endif
+
 #ifdef __unix__
 INSTANTIATE_TEST_SUITE_P(
     TransportTests, BufferTest,
@@ -85,6 +939,8 @@ INSTANTIATE_TEST_SUITE_P(
                       std::make_tuple("posix", "false", "fstream", "true"),
                       std::make_tuple("posix", "false", "fstream", "false"),
                       std::make_tuple("posix", "false", "posix", "false"),
+                      std::make_tuple("posix", "false", "mmap", "false"),
+                      std::make_tuple("stdio", "true", "mmap", "false"),
                       std::make_tuple("stdio", "true", "posix", "false"),
                       std::make_tuple("stdio", "false", "posix", "false"),
 
@@ -127,6 +983,16 @@ INSTANTIATE_TEST_SUITE_P(
                       std::make_tuple("fstream", "false", "fstream", "false")));
 #endif
 
+#ifdef ADIOS2_HAVE_IOURING
+INSTANTIATE_TEST_SUITE_P(
+    IOUringTransportTests, BufferTest,
+    ::testing::Values(std::make_tuple("uring", "false", "posix", "false"),
+                      std::make_tuple("posix", "false", "uring", "false"),
+                      std::make_tuple("uring", "false", "uring", "false"),
+                      std::make_tuple("uring", "false", "stdio", "true"),
+                      std::make_tuple("fstream", "true", "uring", "false")));
+#endif
+
 int main(int argc, char **argv)
 {
     int result;
@@ -0,0 +1,206 @@
+/*
+ * Distributed under the OSI-approved Apache License, Version 2.0.  See
+ * accompanying file Copyright.txt for details.
+ */
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <adios2/toolkit/burstbuffer/FileDrainerMultiThread.h>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+std::vector<char> MakeData(const size_t size, const int seed)
+{
+    std::vector<char> data(size);
+    for (size_t i = 0; i < size; ++i)
+    {
+        data[i] = static_cast<char>(i * 131 + seed);
+    }
+    return data;
+}
+
+void WriteFile(const std::string &path, const std::vector<char> &data)
+{
+    std::ofstream file(path, std::ios::binary);
+    file.write(data.data(), data.size());
+}
+
+std::vector<char> ReadFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file),
+                             std::istreambuf_iterator<char>());
+}
+
+bool FileExists(const std::string &path)
+{
+    return std::ifstream(path).good();
+}
+
+/* target file contents after applying the operations one after the other */
+struct Expected
+{
+    std::vector<char> data;
+    size_t position = 0;
+
+    void Write(const char *bytes, const size_t count)
+    {
+        if (data.size() < position + count)
+        {
+            data.resize(position + count);
+        }
+        std::copy(bytes, bytes + count, data.begin() + position);
+        position += count;
+    }
+};
+
+} // end anonymous namespace
+
+class FileDrainerTest : public ::testing::TestWithParam<unsigned int>
+{
+};
+
+TEST_P(FileDrainerTest, Ordering)
+{
+    // small chunks so that copies and writes to the same range are in
+    // flight on several workers at once
+    const unsigned int nThreads = GetParam();
+    const std::string prefix = "FileDrainerOrdering" +
+                               std::to_string(nThreads) + "_";
+    const std::string src = prefix + "src", target = prefix + "target";
+    const std::vector<char> srcData = MakeData(1000000, 1);
+    const std::vector<char> over = MakeData(50000, 2);
+    const std::vector<char> tail = MakeData(20000, 3);
+    WriteFile(src, srcData);
+
+    Expected expected;
+    adios2::burstbuffer::FileDrainerMultiThread drainer(nThreads);
+    drainer.SetChunkSize(4096);
+    drainer.Start();
+
+    drainer.AddOperationOpen(target, adios2::Mode::Write);
+    drainer.AddOperationCopy(src, target, 600000);
+    expected.Write(srcData.data(), 600000);
+    // overwrites the middle of the copy, the copy continues after it
+    drainer.AddOperationWriteAt(target, 100000, over.size(), over.data());
+    expected.position = 100000;
+    expected.Write(over.data(), over.size());
+    drainer.AddOperationCopy(src, target, 400000);
+    expected.Write(srcData.data() + 600000, 400000);
+    drainer.AddOperationCopyAt(src, target, 0, 700000, 100000);
+    expected.position = 700000;
+    expected.Write(srcData.data(), 100000);
+    drainer.AddOperationSeekEnd(target);
+    expected.position = expected.data.size();
+    drainer.AddOperationWrite(target, tail.size(), tail.data());
+    expected.Write(tail.data(), tail.size());
+
+    drainer.Finish();
+    drainer.Join();
+
+    EXPECT_EQ(drainer.GetBytesDrained(), drainer.GetBytesQueued());
+    EXPECT_TRUE(ReadFile(target) == expected.data);
+    std::remove(src.c_str());
+    std::remove(target.c_str());
+}
+
+TEST_P(FileDrainerTest, MultipleFiles)
+{
+    const unsigned int nThreads = GetParam();
+    const std::string prefix = "FileDrainerMultiple" +
+                               std::to_string(nThreads) + "_";
+    const size_t nFiles = 5;
+
+    adios2::burstbuffer::FileDrainerMultiThread drainer(nThreads);
+    drainer.SetChunkSize(8192);
+    drainer.Start();
+
+    std::vector<std::vector<char>> data;
+    for (size_t f = 0; f < nFiles; ++f)
+    {
+        const std::string name = prefix + std::to_string(f);
+        data.push_back(MakeData(200000 + f * 1000, static_cast<int>(f)));
+        WriteFile(name + ".src", data[f]);
+        drainer.AddOperationOpen(name, adios2::Mode::Write);
+    }
+    // copies of all files interleaved, in two pieces each
+    for (size_t f = 0; f < nFiles; ++f)
+    {
+        const std::string name = prefix + std::to_string(f);
+        drainer.AddOperationCopy(name + ".src", name, 100000);
+    }
+    for (size_t f = 0; f < nFiles; ++f)
+    {
+        const std::string name = prefix + std::to_string(f);
+        drainer.AddOperationCopy(name + ".src", name, data[f].size() - 100000);
+    }
+    // the last one is deleted after it is complete
+    const std::string deleted = prefix + std::to_string(nFiles - 1);
+    drainer.AddOperationDelete(deleted);
+
+    drainer.Finish();
+    drainer.Join();
+
+    EXPECT_EQ(drainer.GetBytesDrained(), drainer.GetBytesQueued());
+    for (size_t f = 0; f + 1 < nFiles; ++f)
+    {
+        const std::string name = prefix + std::to_string(f);
+        EXPECT_TRUE(ReadFile(name) == data[f]) << name;
+        std::remove(name.c_str());
+    }
+    EXPECT_FALSE(FileExists(deleted));
+    for (size_t f = 0; f < nFiles; ++f)
+    {
+        std::remove((prefix + std::to_string(f) + ".src").c_str());
+    }
+}
+
+TEST_P(FileDrainerTest, Errors)
+{
+    // failing operations are reported and skipped, the others complete and
+    // the drained byte count shows what is missing
+    const unsigned int nThreads = GetParam();
+    const std::string prefix = "FileDrainerErrors" +
+                               std::to_string(nThreads) + "_";
+    const std::string src = prefix + "src", target = prefix + "target";
+    const std::vector<char> srcData = MakeData(100000, 4);
+    WriteFile(src, srcData);
+
+    adios2::burstbuffer::FileDrainerMultiThread drainer(nThreads);
+    drainer.SetChunkSize(4096);
+    drainer.Start();
+
+    drainer.AddOperationCopy(prefix + "missing", prefix + "fromMissing",
+                             1000);
+    drainer.AddOperationWrite(prefix + "nodir/target", 2000,
+                              srcData.data());
+    drainer.AddOperationOpen(target, adios2::Mode::Write);
+    drainer.AddOperationCopy(src, target, srcData.size());
+
+    drainer.Finish();
+    drainer.Join();
+
+    EXPECT_EQ(drainer.GetBytesQueued(), 1000 + 2000 + srcData.size());
+    EXPECT_EQ(drainer.GetBytesDrained(), srcData.size());
+    EXPECT_TRUE(ReadFile(target) == srcData);
+    std::remove(src.c_str());
+    std::remove(target.c_str());
+    std::remove((prefix + "fromMissing").c_str());
+}
+
+INSTANTIATE_TEST_SUITE_P(Drainer, FileDrainerTest, ::testing::Values(1u, 4u));
+
+int main(int argc, char **argv)
+{
+    int result;
+    ::testing::InitGoogleTest(&argc, argv);
+    result = RUN_ALL_TESTS();
+
+    return result;
+}